@@ -11,6 +11,7 @@
  */
 
 #include <algorithm>
+#include <filesystem>
 #include <iostream>
 #include <iterator>
 #include <string>
@@ -61,15 +62,31 @@ Options:
                          occour between winners in a tournament. Range is [0,1]
   --tournament=<size>    number of individuals examined for parents' selection
   --brood=<size>         sets the brood size for recombination (0 to disable)
+  --batch=<n>            number of offspring generated and evaluated together
+                         at every step (1 for the steady-state scheme)
   --dss=<period>         controls the Dynamic Subset Selection algorithm
   --generations=<gen>    sets the maximum number of generations in a run
   --max-stuck-time=<st>  sets the maximum number of generations without
                          improvement in a run
   --runs=<runs>          number of runs to be tried
+  --parallel-runs=<n>    number of runs performed at the same time (0 for
+                         all the available cores)
   --mate-zone=<dist>     mating zone (0 for panmictic)
   --threshold=<val>      success threshold for a run
   --arl                  enables Adaptive Representation through Learning
   --cache=<bits>         cache will contain `2^bits` elements
+  --cache-budget=<MB>    the cache is resized online (doubled / halved) but
+                         never exceeds the given budget
+  --cache-file=FILE      stores the cache in FILE (reused by later searches
+                         on the same data)
+  --column-store=<MB>    memory for the gene outputs reused by the offspring
+                         (incremental evaluation of real-valued programs)
+  --output-store=<MB>    memory for the per-example outputs of the recently
+                         evaluated programs
+  --binary=FILE          converts DATASET in the binary format (FILE) and
+                         exits. Binary files are loaded without parsing
+  --threads=<n>          number of threads used for evaluating an individual
+                         (0 for all the available cores)
   --random-seed=<seed>   sets the seed for the pseudo-random number generator
                          (equences are repeatable by using the same seed value)
   --stat-dir=DIR         base path for log files
@@ -174,6 +191,34 @@ vita::validator_id validator(vita::validator_id::undefined);
 // Reference problem (the problem we will work on).
 vita::src_problem *problem;
 
+// Output file of the binary conversion (empty if not required).
+std::filesystem::path binary_file;
+
+// Converts the dataset in the binary format.
+void binary(const args_t &a)
+{
+  const auto value(a.at("--binary"));
+  if (!value)
+    return;
+
+  binary_file = value.asString();
+}
+
+// Writes the dataset in the binary format.
+bool convert()
+{
+  vitaINFO << "Writing binary dataset " << binary_file << "...";
+
+  if (!problem->data().write_binary(binary_file))
+  {
+    vitaERROR << "Cannot write binary dataset";
+    return false;
+  }
+
+  vitaINFO << "...binary dataset written";
+  return true;
+}
+
 // Enables Adaptive Representation through Learning.
 void arl(const args_t &a)
 {
@@ -184,6 +229,24 @@ void arl(const args_t &a)
   }
 }
 
+// Sets the number of offspring generated and evaluated at every step.
+void batch(const args_t &a)
+{
+  const auto value(a.at("--batch"));
+  if (!value)
+    return;
+
+  const auto n(value.asLong());
+  if (n < 1)
+  {
+    vitaERROR << "Invalid offspring batch size. Value ignored";
+    return;
+  }
+
+  problem->env.offspring_batch = static_cast<unsigned>(n);
+  vitaINFO << "Offspring batch size is " << n;
+}
+
 // Sets the brood size for recombination.
 //
 // `0` to disable brood recombination.
@@ -467,6 +530,24 @@ void layers(const args_t &a)
   vitaINFO << "Number of layers set to " << l;
 }
 
+// Sets the number of runs performed at the same time.
+void parallel_runs(const args_t &a)
+{
+  const auto value(a.at("--parallel-runs"));
+  if (!value)
+    return;
+
+  const auto n(value.asLong());
+  if (n < 0)
+  {
+    vitaERROR << "Invalid number of parallel runs. Value ignored";
+    return;
+  }
+
+  problem->env.parallel_runs = static_cast<unsigned>(n);
+  vitaINFO << "Parallel runs are " << n;
+}
+
 // Sets the number of individuals in a layer of the population.
 void population_size(const args_t &a)
 {
@@ -664,6 +745,89 @@ void cache(const args_t &a)
   vitaINFO << "Cache size is " << bits << " bits";
 }
 
+// Sets the memory budget of the cache (enables online resizing).
+void cache_budget(const args_t &a)
+{
+  const auto value(a.at("--cache-budget"));
+  if (!value)
+    return;
+
+  const auto mb(value.asLong());
+  if (mb <= 0)
+  {
+    vitaWARNING << "Invalid cache budget. Cache isn't resized";
+    return;
+  }
+
+  problem->env.cache_budget = mb;
+  vitaINFO << "Cache budget is " << mb << " MB";
+}
+
+// Sets the file used for storing the cache.
+void cache_file(const args_t &a)
+{
+  const auto value(a.at("--cache-file"));
+  if (!value)
+    return;
+
+  problem->env.misc.cache_file = value.asString();
+  vitaINFO << "Cache file is " << problem->env.misc.cache_file;
+}
+
+// Sets the memory budget for the incremental evaluation.
+void column_store(const args_t &a)
+{
+  const auto value(a.at("--column-store"));
+  if (!value)
+    return;
+
+  const auto mb(value.asLong());
+  if (mb < 0)
+  {
+    vitaWARNING << "Invalid column store size. Value ignored";
+    return;
+  }
+
+  problem->env.column_store_size = static_cast<unsigned>(mb);
+  vitaINFO << "Column store size is " << mb << " MB";
+}
+
+// Sets the memory budget for the per-example outputs of the programs.
+void output_store(const args_t &a)
+{
+  const auto value(a.at("--output-store"));
+  if (!value)
+    return;
+
+  const auto mb(value.asLong());
+  if (mb < 0)
+  {
+    vitaWARNING << "Invalid output store size. Value ignored";
+    return;
+  }
+
+  problem->env.output_store_size = static_cast<unsigned>(mb);
+  vitaINFO << "Output store size is " << mb << " MB";
+}
+
+// Sets the number of threads used for evaluating an individual.
+void threads(const args_t &a)
+{
+  const auto value(a.at("--threads"));
+  if (!value)
+    return;
+
+  const auto n(value.asLong());
+  if (n < 0)
+  {
+    vitaERROR << "Invalid number of threads. Value ignored";
+    return;
+  }
+
+  problem->env.threads = static_cast<unsigned>(n);
+  vitaINFO << "Threads are " << n;
+}
+
 // Sets percent of the dataset used for validation.
 //
 // Range is `[0,1]` or `[0%,100%]`.
@@ -713,7 +877,14 @@ void parse_command_line(int argc, char *const argv[])
 
   ui::verbosity(args);
 
+  ui::binary(args);
+
   ui::cache(args);
+  ui::cache_budget(args);
+  ui::cache_file(args);
+  ui::column_store(args);
+  ui::output_store(args);
+  ui::threads(args);
   ui::evaluator(args);
   ui::random_seed(args);
 
@@ -725,10 +896,12 @@ void parse_command_line(int argc, char *const argv[])
   ui::crossover_rate(args);
   ui::tournament_size(args);
   ui::brood(args);
+  ui::batch(args);
   ui::dss(args);
   ui::generations(args);
   ui::max_stuck_time(args);
   ui::set_runs(args);
+  ui::parallel_runs(args);
   ui::mate_zone(args);
   ui::arl(args);
   ui::threshold(args);
@@ -757,6 +930,9 @@ int main(int argc, char *const argv[])
   if (!problem.data().size())
     return EXIT_FAILURE;
 
+  if (!ui::binary_file.empty())
+    return ui::convert() ? EXIT_SUCCESS : EXIT_FAILURE;
+
   ui::go();
 
   return EXIT_SUCCESS;
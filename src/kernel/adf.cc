@@ -47,7 +47,7 @@ value_t adf::eval(core_interpreter *i) const
 {
   Expects(typeid(*i) == typeid(interpreter<i_mep>));
 
-  return interpreter<i_mep>(&code(),
+  return interpreter<i_mep>(&code(), core_.compiled(),
                             static_cast<interpreter<i_mep> *>(i)).run();
 }
 
@@ -112,7 +112,7 @@ bool adt::auto_defined() const
 ///
 value_t adt::eval(core_interpreter *) const
 {
-  return interpreter<i_mep>(&code()).run();
+  return interpreter<i_mep>(&code(), core_.compiled()).run();
 }
 
 ///
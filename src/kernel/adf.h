@@ -18,6 +18,7 @@
 
 #include "kernel/function.h"
 #include "kernel/i_mep.h"
+#include "kernel/interpreter.h"
 #include "kernel/terminal.h"
 #include "kernel/vitafwd.h"
 
@@ -52,6 +53,7 @@ public:
   explicit adf_core(const T &);
 
   const T &code() const;
+  const typename interpreter<T>::code_t &compiled() const;
 
   std::string name(const std::string &) const;
 
@@ -61,6 +63,10 @@ private:
   T        code_;
   opcode_t   id_;
 
+  // The compiled form of `code_` (shared by all the evaluations of the
+  // subroutine).
+  typename interpreter<T>::code_t compiled_;
+
   static opcode_t adf_count()
   {
     static std::atomic<opcode_t> counter(0);
@@ -21,7 +21,8 @@
 /// \param[in] ind individual whose code is used as ADF/ADT
 ///
 template<class T>
-adf_core<T>::adf_core(const T &ind) : code_(ind), id_(adf_count())
+adf_core<T>::adf_core(const T &ind)
+  : code_(ind), id_(adf_count()), compiled_(interpreter<T>::compile(code_))
 {
 }
 
@@ -44,6 +45,15 @@ const T &adf_core<T>::code() const
   return code_;
 }
 
+///
+/// \return the compiled code of the ADF/ADT (see `interpreter::compile`)
+///
+template<class T>
+const typename interpreter<T>::code_t &adf_core<T>::compiled() const
+{
+  return compiled_;
+}
+
 ///
 /// \return `true` if the object passes the internal consistency check
 ///
@@ -10,6 +10,9 @@
  *  You can obtain one at http://mozilla.org/MPL/2.0/
  */
 
+#include <algorithm>
+#include <tuple>
+
 #include "kernel/cache.h"
 
 namespace vita
@@ -18,22 +21,76 @@ namespace vita
 /// Creates a new hash table.
 ///
 /// \param[in] bits `2^bits` is the number of elements of the table
+/// \param[in] ways number of slots of a set (a power of `2`)
+///
+/// \remark
+/// The memory used depends only on `bits`.
 ///
-cache::cache(std::uint8_t bits)
-  : k_mask((1ull << bits) - 1), table_(1ull << bits),
-    seal_(1), probes_(0), hits_(0)
+cache::cache(std::uint8_t bits, unsigned ways)
+  : k_ways(ways), mask_((1ull << bits) / ways - 1), table_(1ull << bits),
+    seal_(1), tick_(0), probes_(0), hits_(0), evictions_(0), last_()
 {
   Expects(bits);
+  Expects(ways && !(ways & (ways - 1)));
+  Expects(ways <= (1ull << bits));
   Ensures(debug());
 }
 
 ///
-/// \param[in] u the signature of an individual
-/// \return      an index in the hash table
+/// \param[in] h the signature of an individual
+/// \return      index of the first slot of the set containing `h`
 ///
 inline std::size_t cache::index(const hash_t &h) const
 {
-  return h.data[0] & k_mask;
+  return (h.data[0] & mask_) * k_ways;
+}
+
+///
+/// \param[in] h the signature of an individual
+/// \return      index of the valid slot containing `h` (`table_.size()` if
+///              not present)
+///
+std::size_t cache::lookup(const hash_t &h) const
+{
+  const auto base(index(h));
+
+  for (auto i(base); i < base + k_ways; ++i)
+    if (table_[i].seal == seal_ && table_[i].hash == h)
+      return i;
+
+  return table_.size();
+}
+
+///
+/// \param[in] i index of a slot
+/// \return      `true` if the slot doesn't contain a valid entry
+///
+inline bool cache::free(std::size_t i) const
+{
+  return table_[i].seal != seal_ || table_[i].hash.empty();
+}
+
+///
+/// \param[in] h the signature of an individual
+/// \return      index of the slot of the set of `h` that should host `h`
+///              (according to the replacement policy)
+///
+std::size_t cache::victim(const hash_t &h) const
+{
+  const auto base(index(h));
+
+  auto i(base);
+  for (auto j(base); j < base + k_ways; ++j)
+  {
+    if (free(j))
+      return j;
+
+    if (std::tie(table_[j].used, table_[j].age)
+        < std::tie(table_[i].used, table_[i].age))
+      i = j;
+  }
+
+  return i;
 }
 
 ///
@@ -43,7 +100,8 @@ inline std::size_t cache::index(const hash_t &h) const
 ///
 void cache::clear()
 {
-  probes_ = hits_ = 0;
+  probes_ = hits_ = evictions_ = 0;
+  last_ = {};
 
   ++seal_;
 
@@ -61,31 +119,46 @@ void cache::clear()
 ///
 void cache::clear(const hash_t &h)
 {
-  table_[index(h)].hash = hash_t();
+  if (const auto i(lookup(h)); i < table_.size())
+    table_[i].hash = hash_t();
 
   // An alternative to invalidate the slot:
-  //   table_[index(h)].seal = 0;
+  //   table_[i].seal = 0;
   // It works because the first valid seal is 1.
 }
 
 ///
 /// Looks for the fitness of an individual in the transposition table.
 ///
-/// \param[in] h individual's signature to look for
-/// \return      the fitness of the individual. If the individuals isn't
-///              present returns an empty fitness
+/// \param[in]  h       individual's signature to look for
+/// \param[out] partial if not `nullptr`, partial results are also considered
+///                     and `*partial` is set accordingly
+/// \return             the fitness of the individual. If the individuals
+///                     isn't present returns an empty fitness
+///
+/// \remark
+/// Partial results (see evaluator::race) are ignored when `partial` is
+/// `nullptr`.
 ///
-const fitness_t &cache::find(const hash_t &h) const
+const fitness_t &cache::find(const hash_t &h, bool *partial) const
 {
   ++probes_;
 
-  const slot &s(table_[index(h)]);
-  const bool ret(seal_ == s.seal && h == s.hash);
-
-  if (ret)
+  if (const auto i(lookup(h)); i < table_.size())
   {
-    ++hits_;
-    return s.fitness;
+    const slot &s(table_[i]);
+
+    if (partial || !s.partial)
+    {
+      ++hits_;
+
+      s.age = ++tick_;
+      s.used = true;
+
+      if (partial)
+        *partial = s.partial;
+      return s.fitness;
+    }
   }
 
   static const fitness_t empty{};
@@ -98,15 +171,164 @@ const fitness_t &cache::find(const hash_t &h) const
 /// \param[in] h       a (possibly) new individual's signature to be stored in
 ///                    the table
 /// \param[in] fitness the fitness of the individual
+/// \param[in] partial `true` if `fitness` is just an upper bound of the real
+///                    fitness (see evaluator::race)
 ///
-void cache::insert(const hash_t &h, const fitness_t &fitness)
+/// If the set of `h` is full a victim is chosen according to the replacement
+/// policy described in the class documentation.
+///
+void cache::insert(const hash_t &h, const fitness_t &fitness, bool partial)
 {
-  slot s;
+  auto i(lookup(h));
+
+  if (i == table_.size())
+  {
+    i = victim(h);
+
+    if (!free(i))
+      ++evictions_;
+
+    table_[i].used = false;
+  }
+
+  slot &s(table_[i]);
   s.hash    =       h;
   s.fitness = fitness;
+  s.partial = partial;
   s.seal    =   seal_;
+  s.age     = ++tick_;
+}
+
+///
+/// Changes the size of the table preserving (if possible) its content.
+///
+/// \param[in] bits `2^bits` is the new number of elements of the table
+///
+/// Live entries are rehashed into the new table. When the table shrinks, and
+/// a set overflows, the replacement policy chooses the entries to be
+/// dropped (they aren't counted as evictions).
+///
+void cache::resize(std::uint8_t bits)
+{
+  Expects(bits);
+  Expects(k_ways <= (1ull << bits));
 
-  table_[index(s.hash)] = s;
+  if ((1ull << bits) == table_.size())
+    return;
+
+  std::vector<slot> old(1ull << bits);
+  old.swap(table_);
+  mask_ = table_.size() / k_ways - 1;
+
+  std::vector<const slot *> alive;
+  for (const auto &s : old)
+    if (s.seal == seal_ && !s.hash.empty())
+      alive.push_back(&s);
+
+  // Oldest entries first: when a set overflows they're the first victims.
+  std::sort(alive.begin(), alive.end(),
+            [](const slot *a, const slot *b) { return a->age < b->age; });
+
+  for (const auto *s : alive)
+    table_[victim(s->hash)] = *s;
+
+  Ensures(debug());
+}
+
+///
+/// Doubles / halves the size of the table according to the statistics
+/// collected since the previous call.
+///
+/// \param[in] budget maximum memory (in bytes) used by the table
+/// \return           a description of the change (an empty string if the
+///                   size doesn't change)
+///
+/// The policy is:
+/// - a table exceeding `budget` is halved;
+/// - a thrashing table (at least half of the recent misses evicted a valid
+///   entry) is doubled, if `budget` allows;
+/// - a mostly empty table (less than 1/8 of the slots in use) without recent
+///   evictions is halved.
+///
+/// The table never goes below `2^k_min_bits` elements. Every call changes
+/// the size by (at most) a factor of `2`. Calls observing less than
+/// `k_min_probes` probes don't change anything (statistics keep
+/// accumulating).
+///
+std::string cache::adapt(std::size_t budget)
+{
+  const auto probes(probes_ - last_.probes);
+  const auto hits(hits_ - last_.hits);
+  const auto evictions(evictions_ - last_.evictions);
+
+  // Too few probes for reliable statistics: they're collected further.
+  if (probes < k_min_probes)
+    return {};
+
+  last_ = {probes_, hits_, evictions_};
+
+  const auto misses(probes - hits);
+  const auto old_bits(bits());
+  auto new_bits(old_bits);
+
+  if (bytes() > budget)
+  {
+    if (old_bits > k_min_bits)
+      --new_bits;
+  }
+  else if (evictions && 2 * evictions >= misses)
+  {
+    if (2 * bytes() <= budget)
+      ++new_bits;
+  }
+  else if (!evictions && 8 * live() < table_.size()
+           && old_bits > k_min_bits)
+    --new_bits;
+
+  if (new_bits == old_bits)
+    return {};
+
+  resize(new_bits);
+
+  return
+    "cache resized from 2^" + std::to_string(old_bits) +
+    " to 2^" + std::to_string(new_bits) + " elements (hit ratio " +
+    std::to_string(hits * 100 / probes) + "%, evictions " +
+    std::to_string(evictions) + "/" + std::to_string(misses) +
+    " misses, " + std::to_string(bytes() >> 10) + " KB)";
+}
+
+///
+/// \return `2^bits()` is the number of elements of the table
+///
+std::uint8_t cache::bits() const
+{
+  std::uint8_t ret(0);
+  while ((1ull << ret) < table_.size())
+    ++ret;
+
+  return ret;
+}
+
+///
+/// \return memory (in bytes) used by the table
+///
+std::size_t cache::bytes() const
+{
+  return table_.size() * sizeof(slot);
+}
+
+///
+/// \return number of valid entries
+///
+std::size_t cache::live() const
+{
+  std::size_t ret(0);
+  for (std::size_t i(0); i < table_.size(); ++i)
+    if (!free(i))
+      ++ret;
+
+  return ret;
 }
 
 ///
@@ -134,22 +356,28 @@ bool cache::load(std::istream &in)
   if (!(in >> n))
     return false;
 
+  std::vector<std::pair<hash_t, fitness_t>> t_table;
   for (decltype(n) i(0); i < n; ++i)
   {
-    slot s;
-    s.seal = t_seal;
-
-    if (!s.hash.load(in))
+    hash_t h;
+    if (!h.load(in))
       return false;
-    if (!s.fitness.load(in))
+
+    fitness_t f;
+    if (!f.load(in))
       return false;
 
-    table_[index(s.hash)] = s;
+    t_table.emplace_back(h, f);
   }
 
-  seal_   = t_seal;
+  seal_ = t_seal;
+  for (const auto &[h, f] : t_table)
+    insert(h, f);
+
   probes_ = t_probes;
   hits_   = t_hits;
+  evictions_ = 0;
+  last_ = {probes_, hits_, evictions_};
 
   return true;
 }
@@ -162,14 +390,15 @@ bool cache::save(std::ostream &out) const
 {
   out << seal_ << ' ' << probes_ << ' ' << hits_ << '\n';
 
+  // Partial results aren't saved.
   std::size_t num(0);
   for (const auto &s : table_)
-    if (!s.hash.empty())
+    if (s.seal == seal_ && !s.hash.empty() && !s.partial)
       ++num;
   out << num << '\n';
 
   for (const auto &s : table_)
-    if (s.seal == seal_ && !s.hash.empty())
+    if (s.seal == seal_ && !s.hash.empty() && !s.partial)
     {
       s.hash.save(out);
       s.fitness.save(out);
@@ -183,6 +412,12 @@ bool cache::save(std::ostream &out) const
 ///
 bool cache::debug() const
 {
+  if (table_.size() % k_ways)
+    return false;
+
+  if (mask_ != table_.size() / k_ways - 1)
+    return false;
+
   return probes() >= hits();
 }
 
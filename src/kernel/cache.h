@@ -26,19 +26,40 @@ namespace vita
 /// individuals are often generated and cache can give a significant speed
 /// improvement avoiding the recalculation of shared information.
 ///
+/// The table is set-associative: a signature can be stored in any of the
+/// `ways` slots of its set. When the set is full the victim is chosen by an
+/// age-aware policy:
+/// - stale slots (see `clear()`) are reused first;
+/// - then the least recently used slot among the ones never hit after their
+///   insertion (one-off offspring);
+/// - otherwise the least recently used slot.
+///
+/// So a flood of new individuals doesn't wipe out the frequently requested
+/// ones (e.g. the elite). With `ways == 1` the table is direct-mapped.
+///
+/// The table can be resized online (see `resize` and `adapt`): live entries
+/// are rehashed into the new table.
+///
 class cache
 {
 public:
   DISALLOW_COPY_AND_ASSIGN(cache);
 
-  explicit cache(std::uint8_t);
+  explicit cache(std::uint8_t, unsigned = 4);
 
   void clear();
   void clear(const hash_t &);
 
-  void insert(const hash_t &, const fitness_t &);
+  void insert(const hash_t &, const fitness_t &, bool = false);
 
-  const fitness_t &find(const hash_t &) const;
+  const fitness_t &find(const hash_t &, bool * = nullptr) const;
+
+  void resize(std::uint8_t);
+  std::string adapt(std::size_t);
+
+  std::uint8_t bits() const;
+  std::size_t bytes() const;
+  std::size_t live() const;
 
   /// \return number of searches in the hash table
   /// \note Every call to the find method increment the counter.
@@ -47,6 +68,12 @@ public:
   /// \return number of successful searches in the hash table
   std::uintmax_t hits() const { return hits_; }
 
+  /// \return number of valid entries replaced by a different signature
+  std::uintmax_t evictions() const { return evictions_; }
+
+  /// \return number of slots of a set
+  unsigned ways() const { return k_ways; }
+
   bool debug() const;
 
   // Serialization.
@@ -56,25 +83,50 @@ public:
 private:
   // Private support methods.
   std::size_t index(const hash_t &) const;
+  std::size_t lookup(const hash_t &) const;
+  std::size_t victim(const hash_t &) const;
+  bool free(std::size_t) const;
 
   // Private data members.
+  /// Minimum size (`2^k_min_bits` elements) reachable by `adapt`.
+  static constexpr std::uint8_t k_min_bits = 10;
+  /// Minimum number of probes required by `adapt` to take a decision.
+  static constexpr std::uintmax_t k_min_probes = 256;
+
   struct slot
   {
     /// This is used as primary key for access to the table.
     hash_t       hash;
     /// The stored fitness of an individual.
     fitness_t fitness;
+    /// `true` for an upper bound of the fitness (see evaluator::race).
+    bool      partial;
     /// Valid slots are recognized comparing their seal with the current one.
     unsigned     seal;
+    /// Time of the last access (see `tick_`).
+    mutable unsigned age;
+    /// `true` if the slot has been hit after its insertion.
+    mutable bool      used;
   };
 
-  const std::uint64_t k_mask;
-  std::vector<slot>   table_;
+  const unsigned        k_ways;
+  std::uint64_t           mask_;  // selects a set
+  std::vector<slot>     table_;
 
   decltype(slot::seal) seal_;
 
+  // A logical clock incremented at every access.
+  mutable decltype(slot::age) tick_;
+
   mutable std::uintmax_t probes_;
   mutable std::uintmax_t   hits_;
+  std::uintmax_t      evictions_;
+
+  // Value of the counters at the last call of `adapt`.
+  struct
+  {
+    std::uintmax_t probes, hits, evictions;
+  } last_;
 };
 
 /// \example example4.cc
@@ -58,4 +58,121 @@ std::ostream &operator<<(std::ostream &o, hash_t h)
   return o << h.data[0] << h.data[1];
 }
 
+///
+/// \param[in] p    data stream to be hashed
+/// \param[in] len  length, in bytes, of `p` (`128 < len <= 512`)
+/// \param[in] seed initialization seed
+/// \return         the signature of `p`
+///
+hash_t mulxhash::hash_large(const std::byte *p, std::size_t len,
+                            std::uint64_t seed)
+{
+  Expects(128 < len && len <= 512);
+
+  std::uint64_t acc0(len * k_p1), acc1(0);
+
+  // Every 32-byte block uses distinct keys: blocks can't be swapped without
+  // changing the signature.
+  const auto round([&](const std::byte *b, std::size_t k)
+  {
+    acc0 += fold(read64(b) ^ key(k, seed), read64(b + 8) ^ key(k + 1, seed));
+    acc0 ^= read64(b + 16) + read64(b + 24);
+
+    acc1 += fold(read64(b + 16) ^ key(k + 2, seed),
+                 read64(b + 24) ^ key(k + 3, seed));
+    acc1 ^= read64(b) + read64(b + 8);
+  });
+
+  const auto n(len / 32);
+  for (std::size_t i(0); i < n; ++i)
+    round(p + 32 * i, 4 * i);
+
+  // The last block may overlap the previous one.
+  round(p + len - 32, k_keys - 4);
+
+  return hash_t(avalanche(acc0 + acc1),
+                0 - avalanche(acc0 * k_p1 + acc1 * k_p2
+                              + (len - seed) * k_p3));
+}
+
+///
+/// \param[in] p    data stream to be hashed
+/// \param[in] len  length, in bytes, of `p` (`len > 512`)
+/// \param[in] seed initialization seed
+/// \return         the signature of `p`
+///
+hash_t mulxhash::hash_long(const std::byte *p, std::size_t len,
+                           std::uint64_t seed)
+{
+  Expects(len > 512);
+
+  std::uint64_t k[k_lanes + k_stripes_per_block];
+  for (std::size_t i(0); i < k_lanes + k_stripes_per_block; ++i)
+    k[i] = key(i, seed);
+
+  std::uint64_t acc[k_lanes] =
+  {
+    0x9e3779b1, k_p1, k_p2, k_p3,
+    0x85ebca77c2b2ae63, 0x85ebca77, 0x27d4eb2f165667c5, 0xc2b2ae3d
+  };
+
+  // Every lane accumulates a 32x32->64 product of the keyed input and (a
+  // neighbour's copy of) the input itself: no lane depends on the others.
+  const auto accumulate([&acc](const std::byte *stripe,
+                               const std::uint64_t *keys)
+  {
+    for (std::size_t j(0); j < k_lanes; ++j)
+    {
+      const auto d(read64(stripe + 8 * j));
+      const auto x(d ^ keys[j]);
+
+      acc[j ^ 1] += d;
+      acc[j] += (x & 0xffffffff) * (x >> 32);
+    }
+  });
+
+  // Spreads the high bits of the accumulators (multiplications only move
+  // information upwards).
+  const auto scramble([&acc, &k]
+  {
+    for (std::size_t j(0); j < k_lanes; ++j)
+    {
+      acc[j] ^= acc[j] >> 47;
+      acc[j] ^= k[k_stripes_per_block + j];
+      acc[j] *= 0x9e3779b1;
+    }
+  });
+
+  const std::size_t block_len(k_stripe * k_stripes_per_block);
+  const auto n_blocks((len - 1) / block_len);
+
+  for (std::size_t b(0); b < n_blocks; ++b)
+  {
+    for (std::size_t s(0); s < k_stripes_per_block; ++s)
+      accumulate(p + b * block_len + s * k_stripe, k + s);
+
+    scramble();
+  }
+
+  // Last (partial) block. The last stripe is always processed entirely
+  // (overlapping the previous one).
+  const auto n_stripes((len - 1 - n_blocks * block_len) / k_stripe);
+  for (std::size_t s(0); s < n_stripes; ++s)
+    accumulate(p + n_blocks * block_len + s * k_stripe, k + s);
+
+  accumulate(p + len - k_stripe, k + k_stripes_per_block);
+
+  // Merging.
+  const auto merge([&acc, &k](std::size_t first_key, std::uint64_t start)
+  {
+    for (std::size_t j(0); j < k_lanes; j += 2)
+      start += fold(acc[j] ^ k[first_key + j],
+                    acc[j + 1] ^ k[first_key + j + 1]);
+
+    return avalanche(start);
+  });
+
+  return hash_t(merge(1, len * k_p1), merge(15, ~(len * k_p2)));
+}
+
 }  // namespace vita
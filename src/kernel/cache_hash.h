@@ -13,8 +13,10 @@
 #if !defined(VITA_CACHE_HASH_H)
 #define      VITA_CACHE_HASH_H
 
+#include <array>
 #include <cstddef>
 #include <cstring>
+
 #include "kernel/common.h"
 
 namespace vita
@@ -95,6 +97,9 @@ inline std::uint64_t rotl64(std::uint64_t x, std::uint8_t r)
 class murmurhash3
 {
 public:
+  /// Identifies the hash function (e.g. in files containing signatures).
+  static constexpr std::uint32_t id = 1;
+
   static hash_t hash128(const void *const, std::size_t, std::uint32_t = 1973);
 
 private:
@@ -224,7 +229,240 @@ inline T murmurhash3::get_block(const T *p, std::size_t i)
   return tmp;
 }
 
+///
+/// A 128-bit hash built around wide multiplications (in the spirit of XXH3
+/// by Yann Collet and wyhash by Wang Yi).
+///
+/// - Inputs up to 512 bytes are consumed 16 bytes at a time: every pair of
+///   64-bit words is folded by a single 64x64->128 multiplication and the
+///   pairs are independent (good instruction-level parallelism).
+/// - Longer inputs are consumed in 64-byte stripes by eight independent lanes
+///   performing 32x32->64 multiplications: the inner loop is easily
+///   vectorized by the compiler.
+///
+/// It's usually faster than MurmurHash3 (see `test/speed_hash.cc`), mostly
+/// because the work on distinct parts of the input isn't serialized.
+///
+/// \warning
+/// The output is NOT compatible with the reference XXH3 implementation.
+///
+class mulxhash
+{
+public:
+  /// Identifies the hash function (e.g. in files containing signatures).
+  static constexpr std::uint32_t id = 2;
+
+  static hash_t hash128(const void *const, std::size_t, std::uint32_t = 1973);
+
+private:
+  static constexpr std::size_t k_lanes = 8;
+  static constexpr std::size_t k_stripe = k_lanes * sizeof(std::uint64_t);
+  static constexpr std::size_t k_stripes_per_block = 16;
+  static constexpr std::size_t k_keys = 68;
+
+  static constexpr std::uint64_t k_p1 = 0x9e3779b185ebca87;
+  static constexpr std::uint64_t k_p2 = 0xc2b2ae3d27d4eb4f;
+  static constexpr std::uint64_t k_p3 = 0x165667b19e3779f9;
+
+  static std::uint64_t key(std::size_t, std::uint64_t);
+  static std::uint64_t read64(const std::byte *);
+  static std::uint32_t read32(const std::byte *);
+  static std::uint64_t fold(std::uint64_t, std::uint64_t);
+  static std::uint64_t avalanche(std::uint64_t);
+  static std::uint64_t mix(std::uint64_t);
+
+  static hash_t hash_short(const std::byte *, std::size_t, std::uint64_t);
+  static hash_t hash_medium(const std::byte *, std::size_t, std::uint64_t);
+  static hash_t hash_large(const std::byte *, std::size_t, std::uint64_t);
+  static hash_t hash_long(const std::byte *, std::size_t, std::uint64_t);
+};
+
+///
+/// Hashes a single message in one call, return 128-bit output.
+///
+/// \param[in] data data stream to be hashed
+/// \param[in] len  length, in bytes, of `data`
+/// \param[in] seed initialization seed
+/// \return         the signature of `data`
+///
+inline hash_t mulxhash::hash128(const void *const data, std::size_t len,
+                                std::uint32_t seed)
+{
+  const auto *p(static_cast<const std::byte *>(data));
+
+  if (len <= 16)
+    return hash_short(p, len, seed);
+  if (len <= 128)
+    return hash_medium(p, len, seed);
+  if (len <= 512)
+    return hash_large(p, len, seed);
+
+  return hash_long(p, len, seed);
+}
+
+///
+/// \param[in] i    index of a key
+/// \param[in] seed initialization seed
+/// \return         the `i`-th key (a pseudo-random constant) perturbed by
+///                 `seed`
+///
+inline std::uint64_t mulxhash::key(std::size_t i, std::uint64_t seed)
+{
+  // SplitMix64 sequence.
+  static constexpr auto secret([]
+  {
+    std::array<std::uint64_t, k_keys> ret{};
+
+    std::uint64_t x(0);
+    for (auto &k : ret)
+    {
+      std::uint64_t z(x += 0x9e3779b97f4a7c15);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+      k = z ^ (z >> 31);
+    }
+
+    return ret;
+  }());
+
+  return i & 1 ? secret[i] - seed : secret[i] + seed;
+}
+
+inline std::uint64_t mulxhash::read64(const std::byte *p)
+{
+  std::uint64_t ret;
+  std::memcpy(&ret, p, sizeof(ret));
+  return ret;
+}
+
+inline std::uint32_t mulxhash::read32(const std::byte *p)
+{
+  std::uint32_t ret;
+  std::memcpy(&ret, p, sizeof(ret));
+  return ret;
+}
+
+///
+/// \param[in] a first factor
+/// \param[in] b second factor
+/// \return      the 128-bit product `a * b` folded to 64 bits (low half XOR
+///              high half)
+///
+inline std::uint64_t mulxhash::fold(std::uint64_t a, std::uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+  __extension__ using uint128 = unsigned __int128;
+
+  const auto r(static_cast<uint128>(a) * b);
+  return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+#else
+  const std::uint64_t a_lo(a & 0xffffffff), a_hi(a >> 32);
+  const std::uint64_t b_lo(b & 0xffffffff), b_hi(b >> 32);
+
+  const auto ll(a_lo * b_lo), lh(a_lo * b_hi), hl(a_hi * b_lo),
+             hh(a_hi * b_hi);
+
+  const auto cross((ll >> 32) + (hl & 0xffffffff) + lh);
+  const auto lo((cross << 32) | (ll & 0xffffffff));
+  const auto hi(hh + (hl >> 32) + (cross >> 32));
+
+  return lo ^ hi;
+#endif
+}
+
+/// A fast final mixer for well-distributed values.
+inline std::uint64_t mulxhash::avalanche(std::uint64_t h)
+{
+  h ^= h >> 37;
+  h *= k_p3;
+  h ^= h >> 32;
+  return h;
+}
+
+/// A stronger final mixer, used for (poorly distributed) short inputs.
+inline std::uint64_t mulxhash::mix(std::uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccd;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53;
+  h ^= h >> 33;
+  return h;
+}
+
+///
+/// \param[in] p    data stream to be hashed
+/// \param[in] len  length, in bytes, of `p` (`len <= 16`)
+/// \param[in] seed initialization seed
+/// \return         the signature of `p`
+///
+inline hash_t mulxhash::hash_short(const std::byte *p, std::size_t len,
+                                   std::uint64_t seed)
+{
+  // `a` and `b` encode the input without loss (given its length).
+  std::uint64_t a(0), b(0);
+
+  if (len > 8)
+  {
+    a = read64(p);
+    b = read64(p + len - 8);
+  }
+  else if (len >= 4)
+    a = read32(p) | std::uint64_t(read32(p + len - 4)) << 32;
+  else if (len)
+    a = std::uint64_t(p[0]) << 16 | std::uint64_t(p[len >> 1]) << 24
+        | std::uint64_t(p[len - 1]) | len << 8;
+
+  return hash_t(mix(fold(a ^ key(0, seed), b ^ key(1, seed)) ^ len),
+                mix(fold(a ^ key(2, seed), b ^ key(3, seed)) + len * k_p1));
+}
+
+///
+/// \param[in] p    data stream to be hashed
+/// \param[in] len  length, in bytes, of `p` (`16 < len <= 128`)
+/// \param[in] seed initialization seed
+/// \return         the signature of `p`
+///
+inline hash_t mulxhash::hash_medium(const std::byte *p, std::size_t len,
+                                    std::uint64_t seed)
+{
+  std::uint64_t acc0(len * k_p1), acc1(0);
+
+  // 16-byte blocks are taken from both ends of the input (they may overlap).
+  for (std::size_t i(0); i <= (len - 1) / 32; ++i)
+  {
+    const std::byte *front(p + 16 * i), *back(p + len - 16 * (i + 1));
+
+    acc0 += fold(read64(front) ^ key(4 * i, seed),
+                 read64(front + 8) ^ key(4 * i + 1, seed));
+    acc0 ^= read64(back) + read64(back + 8);
+
+    acc1 += fold(read64(back) ^ key(4 * i + 2, seed),
+                 read64(back + 8) ^ key(4 * i + 3, seed));
+    acc1 ^= read64(front) + read64(front + 8);
+  }
+
+  return hash_t(avalanche(acc0 + acc1),
+                0 - avalanche(acc0 * k_p1 + acc1 * k_p2
+                              + (len - seed) * k_p3));
+}
+
+///
+/// The hash function used for individuals' signatures.
+///
+/// Every hash function is a class with the same (static) interface:
+/// - `hash128(data, len, seed)` returns the 128-bit signature of `len` bytes;
+/// - `id` identifies the function (signatures obtained by distinct functions
+///   aren't comparable).
+///
+/// MurmurHash3 (the choice of the previous versions) can be selected
+/// defining `VITA_MURMURHASH3` (CMake option of the same name).
+///
+#if defined(VITA_MURMURHASH3)
 typedef murmurhash3 hash;
+#else
+typedef mulxhash hash;
+#endif
 
 }  // namespace vita
 
@@ -0,0 +1,196 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <algorithm>
+
+#include "kernel/column_store.h"
+
+namespace vita
+{
+///
+/// \return an estimate of the memory (in bytes) used by the object
+///
+/// \remark
+/// Shared columns are fully accounted (so this is an upper bound).
+///
+std::size_t gene_outputs::bytes() const
+{
+  std::size_t ret(sizeof(*this));
+
+  for (const auto &l : loci)
+  {
+    ret += sizeof(l);
+    if (l.second.values)
+      ret += l.second.values->size() * sizeof(D_DOUBLE);
+  }
+
+  return ret;
+}
+
+///
+/// \param[in] budget maximum memory (in bytes) used by the store
+///
+column_store::column_store(std::size_t budget)
+  : lru_(), where_(), subtrees_(), sweep_size_(0), budget_(budget),
+    used_(0), hits_(0), misses_(0)
+{
+  Expects(budget);
+}
+
+///
+/// \param[in] go gene outputs we are looking for (usually obtained via
+///               `i_mep::outputs()`)
+/// \return       `go` if it's still in the store, `nullptr` otherwise
+///
+/// A successful search marks the element as recently used.
+///
+std::shared_ptr<const gene_outputs> column_store::find(
+  const std::shared_ptr<const gene_outputs> &go)
+{
+  if (!go)
+    return nullptr;
+
+  const auto it(where_.find(go.get()));
+  if (it == where_.end())
+    return nullptr;
+
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return go;
+}
+
+///
+/// Inserts a new element into the store.
+///
+/// \param[in] go gene outputs of an individual
+/// \return       a shared pointer to the element inserted
+///
+/// Least recently used elements are evicted to stay within the budget.
+///
+std::shared_ptr<const gene_outputs> column_store::insert(gene_outputs go)
+{
+  const auto bytes(go.bytes());
+  auto ret(std::make_shared<const gene_outputs>(std::move(go)));
+
+  if (bytes > budget_)
+    return ret;  // too big to be stored
+
+  lru_.push_front(ret);
+  where_[ret.get()] = lru_.begin();
+  used_ += bytes;
+
+  while (used_ > budget_)
+  {
+    const auto &victim(lru_.back());
+
+    used_ -= victim->bytes();
+    where_.erase(victim.get());
+    lru_.pop_back();
+  }
+
+  Ensures(used_ <= budget_);
+  return ret;
+}
+
+///
+/// \param[in] h signature of a subtree
+/// \return      the output column of the subtree (`nullptr` if not available)
+///
+gene_outputs::column column_store::find(const hash_t &h)
+{
+  if (const auto it = subtrees_.find(h); it != subtrees_.end())
+  {
+    if (auto ret = it->second.lock())
+    {
+      ++hits_;
+      return ret;
+    }
+
+    subtrees_.erase(it);
+  }
+
+  ++misses_;
+  return nullptr;
+}
+
+///
+/// Indexes the output column of a subtree.
+///
+/// \param[in] h   signature of a subtree
+/// \param[in] col output column of the subtree (it should be referenced by
+///                an element of the store, otherwise it's soon unavailable)
+///
+void column_store::insert(const hash_t &h, const gene_outputs::column &col)
+{
+  Expects(col);
+
+  subtrees_[h] = col;
+
+  // Periodically drops the references to the evicted columns.
+  if (subtrees_.size() > 2 * sweep_size_)
+  {
+    for (auto it(subtrees_.begin()); it != subtrees_.end();)
+      if (it->second.expired())
+        it = subtrees_.erase(it);
+      else
+        ++it;
+
+    sweep_size_ = std::max<std::size_t>(subtrees_.size(), 1024);
+  }
+}
+
+///
+/// Removes every element from the store.
+///
+/// To be called when the dataset changes (e.g. after a DSS shake).
+///
+void column_store::clear()
+{
+  lru_.clear();
+  where_.clear();
+  subtrees_.clear();
+  sweep_size_ = 0;
+  used_ = 0;
+}
+
+///
+/// \return the memory budget (in bytes)
+///
+std::size_t column_store::budget() const
+{
+  return budget_;
+}
+
+///
+/// \return an estimate of the memory used (in bytes)
+///
+std::size_t column_store::used() const
+{
+  return used_;
+}
+
+///
+/// \return number of successful subtree lookups
+///
+std::uintmax_t column_store::hits() const
+{
+  return hits_;
+}
+
+///
+/// \return number of failed subtree lookups
+///
+std::uintmax_t column_store::misses() const
+{
+  return misses_;
+}
+
+}  // namespace vita
@@ -0,0 +1,114 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_COLUMN_STORE_H)
+#define      VITA_COLUMN_STORE_H
+
+#include <list>
+#include <map>
+#include <unordered_map>
+
+#include "kernel/cache_hash.h"
+#include "kernel/gene.h"
+#include "kernel/locus.h"
+
+namespace vita
+{
+///
+/// Outputs of the active genes of an individual.
+///
+/// Every active locus is associated with the gene it contains and with the
+/// column of values it outputs for the examples of a dataset (`NaN` encodes
+/// the empty value).
+///
+/// Columns are shared (an offspring references the columns of the parent for
+/// the unchanged part of the genome).
+///
+struct gene_outputs
+{
+  using column = std::shared_ptr<const std::vector<D_DOUBLE>>;
+
+  struct elem
+  {
+    gene g;
+    column values;
+  };
+
+  std::map<locus, elem> loci;
+
+  std::size_t bytes() const;
+};
+
+///
+/// A memory-bounded store of gene_outputs.
+///
+/// Individuals keep a weak reference to their gene outputs (see
+/// `i_mep::outputs()`) and offspring inherit it from the parent they are
+/// copied from. So the evaluation of an offspring only has to recompute the
+/// loci whose subtree has been changed by mutation / crossover.
+///
+/// When the memory budget is exceeded the least recently used elements are
+/// evicted.
+///
+/// The store also works as a population-wide semantic cache: stored columns
+/// are indexed by the signature of the subtree producing them (see
+/// `i_mep::signature(const locus &)`), so identical subexpressions of
+/// unrelated individuals are evaluated once. The index doesn't own the
+/// columns (a column is available while an element of the store references
+/// it).
+///
+class column_store
+{
+public:
+  explicit column_store(std::size_t);
+
+  std::shared_ptr<const gene_outputs> find(
+    const std::shared_ptr<const gene_outputs> &);
+  std::shared_ptr<const gene_outputs> insert(gene_outputs);
+
+  gene_outputs::column find(const hash_t &);
+  void insert(const hash_t &, const gene_outputs::column &);
+
+  void clear();
+
+  std::size_t budget() const;
+  std::size_t used() const;
+
+  std::uintmax_t hits() const;
+  std::uintmax_t misses() const;
+
+private:
+  using lru_list = std::list<std::shared_ptr<const gene_outputs>>;
+
+  struct hash_key
+  {
+    std::size_t operator()(const hash_t &h) const { return h.data[0]; }
+  };
+
+  lru_list lru_;  // most recently used elements are at the front
+  std::unordered_map<const gene_outputs *, lru_list::iterator> where_;
+
+  // Subtree signature to output column.
+  std::unordered_map<hash_t, std::weak_ptr<const std::vector<D_DOUBLE>>,
+                     hash_key> subtrees_;
+  std::size_t sweep_size_;  // size of `subtrees_` after the last sweep
+
+  std::size_t budget_;  // memory budget in bytes
+  std::size_t used_;
+
+  std::uintmax_t hits_;    // successful subtree lookups
+  std::uintmax_t misses_;  // failed subtree lookups
+};
+
+}  // namespace vita
+
+#endif  // include guard
@@ -0,0 +1,328 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include "kernel/concurrent_cache.h"
+
+namespace vita
+{
+
+namespace
+{
+// Every thread updates the statistics in its own stripe (threads outnumbering
+// the stripes share them, the counters remain exact).
+template<std::size_t N>
+std::size_t stripe()
+{
+  static std::atomic<std::size_t> next(0);
+  thread_local const std::size_t id(next++ % N);
+
+  return id;
+}
+
+constexpr std::uint32_t k_partial_flag = 1u << 8;
+}  // unnamed namespace
+
+///
+/// Creates a new hash table.
+///
+/// \param[in] bits `2^bits` is the number of elements of the table
+///
+concurrent_cache::concurrent_cache(std::uint8_t bits)
+  : k_mask((1ull << bits) - 1), table_(new slot[1ull << bits]), seal_(1)
+{
+  Expects(bits);
+  Ensures(debug());
+}
+
+///
+/// \param[in] h the signature of an individual
+/// \return      an index in the hash table
+///
+inline std::size_t concurrent_cache::index(const hash_t &h) const
+{
+  return h.data[0] & k_mask;
+}
+
+///
+/// \return number of searches in the hash table
+///
+/// \note Every call to the find method increment the counter.
+///
+std::uintmax_t concurrent_cache::probes() const
+{
+  std::uintmax_t ret(0);
+  for (const auto &c : stats_)
+    ret += c.probes.load(std::memory_order_relaxed);
+
+  return ret;
+}
+
+///
+/// \return number of successful searches in the hash table
+///
+std::uintmax_t concurrent_cache::hits() const
+{
+  std::uintmax_t ret(0);
+  for (const auto &c : stats_)
+    ret += c.hits.load(std::memory_order_relaxed);
+
+  return ret;
+}
+
+///
+/// Clears the content and the statistical informations of the table.
+///
+/// \note Allocated size isn't changed.
+///
+void concurrent_cache::clear()
+{
+  for (auto &c : stats_)
+  {
+    c.probes.store(0, std::memory_order_relaxed);
+    c.hits.store(0, std::memory_order_relaxed);
+  }
+
+  seal_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+///
+/// Clears the cached information for a specific individual.
+///
+/// \param[in] h individual's signature whose informations we have to clear
+///
+void concurrent_cache::clear(const hash_t &h)
+{
+  const auto i(index(h));
+
+  std::lock_guard lock(shards_[i % k_shards]);
+  write(i, hash_t(), {}, false, seal_.load(std::memory_order_acquire));
+}
+
+///
+/// Writes a slot of the table.
+///
+/// \param[in] i       index of the slot
+/// \param[in] h       individual's signature
+/// \param[in] f       fitness of the individual
+/// \param[in] partial `true` if `f` is just an upper bound
+/// \param[in] seal    current seal
+///
+/// \warning The shard lock for slot `i` must be held.
+///
+void concurrent_cache::write(std::size_t i, const hash_t &h,
+                             const fitness_t &f, bool partial, unsigned seal)
+{
+  Expects(f.size() <= k_components);
+
+  slot &s(table_[i]);
+
+  const auto seq(s.seq.load(std::memory_order_relaxed));
+  s.seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  s.hash[0].store(h.data[0], std::memory_order_relaxed);
+  s.hash[1].store(h.data[1], std::memory_order_relaxed);
+  for (std::size_t j(0); j < f.size(); ++j)
+    s.fitness[j].store(f[j], std::memory_order_relaxed);
+  s.info.store(static_cast<std::uint32_t>(f.size())
+               | (partial ? k_partial_flag : 0),
+               std::memory_order_relaxed);
+  s.seal.store(seal, std::memory_order_relaxed);
+
+  s.seq.store(seq + 2, std::memory_order_release);
+}
+
+///
+/// Looks for the fitness of an individual in the transposition table.
+///
+/// \param[in]  h       individual's signature to look for
+/// \param[out] partial if not `nullptr`, partial results are also considered
+///                     and `*partial` is set accordingly
+/// \return             the fitness of the individual. If the individuals
+///                     isn't present returns an empty fitness
+///
+/// \remark
+/// A lookup overlapping the update of the same slot is a miss.
+///
+/// \see cache::find
+///
+fitness_t concurrent_cache::find(const hash_t &h, bool *partial) const
+{
+  auto &c(stats_[stripe<k_stripes>()]);
+  c.probes.fetch_add(1, std::memory_order_relaxed);
+
+  const slot &s(table_[index(h)]);
+
+  const auto seq(s.seq.load(std::memory_order_acquire));
+  if (seq & 1)
+    return {};
+
+  const hash_t sh(s.hash[0].load(std::memory_order_relaxed),
+                  s.hash[1].load(std::memory_order_relaxed));
+  const auto info(s.info.load(std::memory_order_relaxed));
+  const auto seal(s.seal.load(std::memory_order_relaxed));
+
+  const bool is_partial(info & k_partial_flag);
+  const std::size_t size(info & 0xFF);
+
+  fitness_t ret(with_size{size});
+  for (std::size_t j(0); j < size; ++j)
+    ret[j] = s.fitness[j].load(std::memory_order_relaxed);
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (s.seq.load(std::memory_order_relaxed) != seq)
+    return {};
+
+  if (seal != seal_.load(std::memory_order_acquire) || h != sh
+      || !size || (is_partial && !partial))
+    return {};
+
+  c.hits.fetch_add(1, std::memory_order_relaxed);
+
+  if (partial)
+    *partial = is_partial;
+  return ret;
+}
+
+///
+/// Stores fitness information in the transposition table.
+///
+/// \param[in] h       a (possibly) new individual's signature to be stored in
+///                    the table
+/// \param[in] fitness the fitness of the individual
+/// \param[in] partial `true` if `fitness` is just an upper bound of the real
+///                    fitness (see evaluator::race)
+///
+/// \remark Fitnesses with more than `k_components` components are ignored.
+///
+void concurrent_cache::insert(const hash_t &h, const fitness_t &fitness,
+                              bool partial)
+{
+  if (fitness.size() > k_components)
+    return;
+
+  const auto i(index(h));
+
+  std::lock_guard lock(shards_[i % k_shards]);
+  write(i, h, fitness, partial, seal_.load(std::memory_order_acquire));
+}
+
+///
+/// \param[in] in input stream
+/// \return       `true` if the object is correctly loaded
+///
+/// \note
+/// If the load operation isn't successful the current object isn't changed.
+///
+/// \warning Not thread safe: no other member function may run concurrently.
+///
+bool concurrent_cache::load(std::istream &in)
+{
+  std::uint32_t t_seal;
+  if (!(in >> t_seal))
+    return false;
+
+  std::uintmax_t t_probes;
+  if (!(in >> t_probes))
+    return false;
+
+  std::uintmax_t t_hits;
+  if (!(in >> t_hits))
+    return false;
+
+  std::size_t n;
+  if (!(in >> n))
+    return false;
+
+  std::vector<std::pair<hash_t, fitness_t>> t_table;
+  for (decltype(n) i(0); i < n; ++i)
+  {
+    hash_t h;
+    if (!h.load(in))
+      return false;
+
+    fitness_t f;
+    if (!f.load(in))
+      return false;
+
+    if (f.size() <= k_components)
+      t_table.emplace_back(h, f);
+  }
+
+  for (const auto &[h, f] : t_table)
+    write(index(h), h, f, false, t_seal);
+
+  seal_ = t_seal;
+
+  for (auto &c : stats_)
+  {
+    c.probes = 0;
+    c.hits = 0;
+  }
+  stats_[0].probes = t_probes;
+  stats_[0].hits = t_hits;
+
+  return true;
+}
+
+///
+/// \param[out] out output stream
+/// \return         `true` if the object was saved correctly
+///
+/// The format is the same used by the `cache` class.
+///
+/// \warning Not thread safe: no other member function may run concurrently.
+///
+bool concurrent_cache::save(std::ostream &out) const
+{
+  const auto seal(seal_.load());
+
+  out << seal << ' ' << probes() << ' ' << hits() << '\n';
+
+  const auto valid([seal](const slot &s)
+  {
+    return s.seal == seal && (s.hash[0] || s.hash[1])
+           && (s.info & 0xFF) && !(s.info & k_partial_flag);
+  });
+
+  // Partial results aren't saved.
+  std::size_t num(0);
+  for (std::size_t i(0); i <= k_mask; ++i)
+    if (valid(table_[i]))
+      ++num;
+  out << num << '\n';
+
+  for (std::size_t i(0); i <= k_mask; ++i)
+    if (const slot &s(table_[i]); valid(s))
+    {
+      hash_t(s.hash[0], s.hash[1]).save(out);
+
+      fitness_t f(with_size(s.info & 0xFF));
+      for (std::size_t j(0); j < f.size(); ++j)
+        f[j] = s.fitness[j];
+      f.save(out);
+    }
+
+  return out.good();
+}
+
+///
+/// \return `true` if the object passes the internal consistency check
+///
+bool concurrent_cache::debug() const
+{
+  // Hits are read first: probes may increase in the meantime.
+  const auto h(hits());
+  return probes() >= h;
+}
+
+}  // namespace vita
@@ -0,0 +1,110 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_CONCURRENT_CACHE_H)
+#define      VITA_CONCURRENT_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "kernel/cache_hash.h"
+#include "kernel/environment.h"
+
+namespace vita
+{
+///
+/// A hash table linking individuals' signature to fitness which can be
+/// shared by many threads.
+///
+/// It has the same interface and behaviour of the `cache` class but every
+/// member function, except `load` and `save`, can be called concurrently:
+/// - readers never block: every slot is protected by a sequence lock and a
+///   read overlapping a write is simply considered a miss;
+/// - writers are serialized by a small set of mutexes (shards) selected by
+///   the slot index, so writes to unrelated slots rarely contend;
+/// - statistics are collected in per-thread counters (distinct cache lines)
+///   and aggregated on demand.
+///
+/// \remark
+/// A slot fits a cache line and stores at most `k_components` fitness
+/// components: larger fitnesses aren't cached.
+///
+class concurrent_cache
+{
+public:
+  DISALLOW_COPY_AND_ASSIGN(concurrent_cache);
+
+  /// Maximum number of components of a cacheable fitness.
+  static constexpr std::size_t k_components = 4;
+
+  explicit concurrent_cache(std::uint8_t);
+
+  void clear();
+  void clear(const hash_t &);
+
+  void insert(const hash_t &, const fitness_t &, bool = false);
+
+  fitness_t find(const hash_t &, bool * = nullptr) const;
+
+  std::uintmax_t probes() const;
+  std::uintmax_t hits() const;
+
+  bool debug() const;
+
+  // Serialization.
+  bool load(std::istream &);
+  bool save(std::ostream &) const;
+
+private:
+  // Private support methods.
+  std::size_t index(const hash_t &) const;
+  void write(std::size_t, const hash_t &, const fitness_t &, bool, unsigned);
+
+  // Private data members.
+  struct alignas(64) slot
+  {
+    /// Odd while the slot is being written.
+    std::atomic<std::uint32_t> seq = 0;
+    /// Valid slots are recognized comparing their seal with the current one.
+    std::atomic<std::uint32_t> seal = 0;
+    /// This is used as primary key for access to the table.
+    std::array<std::atomic<std::uint64_t>, 2> hash = {};
+    /// The stored fitness of an individual.
+    std::array<std::atomic<double>, k_components> fitness = {};
+    /// Number of components of the fitness (low byte) and partial flag (see
+    /// evaluator::race).
+    std::atomic<std::uint32_t> info = 0;
+  };
+
+  struct alignas(64) counters
+  {
+    std::atomic<std::uintmax_t> probes = 0;
+    std::atomic<std::uintmax_t>   hits = 0;
+  };
+
+  static constexpr std::size_t k_shards = 64;
+  static constexpr std::size_t k_stripes = 64;
+
+  const std::uint64_t      k_mask;
+  std::unique_ptr<slot[]> table_;
+
+  std::atomic<std::uint32_t> seal_;
+
+  std::array<std::mutex, k_shards> shards_;
+  mutable std::array<counters, k_stripes> stats_;
+};
+
+}  // namespace vita
+
+#endif  // include guard
@@ -70,7 +70,7 @@ public:
     return *this;
   }
 
-  template<class ...Args> value_t run(Args && ...args) const
+  template<class ...Args> decltype(auto) run(Args && ...args) const
   {
     // Consider that there are situations in which `&int_.program() != &ind_`
     // and this function will blow up.
@@ -88,6 +88,8 @@ public:
     return int_.run(std::forward<Args>(args)...);
   }
 
+  bool real_valued() const { return int_.real_valued(); }
+
   bool debug() const
   {
     if (!ind_.debug())
@@ -115,11 +117,13 @@ public:
   explicit reg_lambda_f_storage(const T &ind) : int_(&ind)
   { Ensures(debug()); }
 
-  template<class ...Args> value_t run(Args && ...args) const
+  template<class ...Args> decltype(auto) run(Args && ...args) const
   {
     return int_.run(std::forward<Args>(args)...);
   }
 
+  bool real_valued() const { return int_.real_valued(); }
+
   bool debug() const { return int_.debug(); }
 
   // Serialization
@@ -11,6 +11,7 @@
  */
 
 #include "kernel/environment.h"
+#include "kernel/random.h"
 
 namespace vita
 {
@@ -94,12 +95,24 @@ void environment::xml(tinyxml2::XMLDocument *d) const
   if (validation_percentage.has_value())
     set_text(e_environment, "validation_percentage", *validation_percentage);
   set_text(e_environment, "cache_bits", cache_size);  // size `1u<<cache_size`
+  set_text(e_environment, "cache_budget", cache_budget);  // MB
+  set_text(e_environment, "column_store_size", column_store_size);  // MB
+  set_text(e_environment, "output_store_size", output_store_size);  // MB
+  set_text(e_environment, "threads", threads);
+  set_text(e_environment, "offspring_batch", offspring_batch);
+  set_text(e_environment, "parallel_runs", parallel_runs);
 
   auto *e_alps(d->NewElement("alps"));
   e_environment->InsertEndChild(e_alps);
   set_text(e_alps, "age_gap", alps.age_gap);
   set_text(e_alps, "p_same_layer", alps.p_same_layer);
 
+  auto *e_island(d->NewElement("island"));
+  e_environment->InsertEndChild(e_island);
+  set_text(e_island, "interval", island.interval);
+  set_text(e_island, "migrants", island.migrants);
+  set_text(e_island, "topology", as_integer(island.topology));
+
   auto *e_team(d->NewElement("team"));
   e_environment->InsertEndChild(e_team);
   set_text(e_team, "individuals", team.individuals);
@@ -118,6 +131,7 @@ void environment::xml(tinyxml2::XMLDocument *d) const
   auto *e_misc(d->NewElement("misc"));
   e_environment->InsertEndChild(e_misc);
   set_text(e_misc, "serialization_file", misc.serialization_file);
+  set_text(e_misc, "cache_file", misc.cache_file);
 }
 
 ///
@@ -228,6 +242,12 @@ bool environment::debug(bool force_defined) const
     }
   }  // if (force_defined)
 
+  if (!offspring_batch)
+  {
+    vitaERROR << "`offspring_batch` must be greater than 0";
+    return false;
+  }
+
   if (mep.code_length == 1)
   {
     vitaERROR << "`code_length` is too short";
@@ -265,6 +285,12 @@ bool environment::debug(bool force_defined) const
     return false;
   }
 
+  if (island.interval && !island.migrants)
+  {
+    vitaERROR << "At least one migrant is required";
+    return false;
+  }
+
   if (alps.p_same_layer > 1.0)
   {
     vitaERROR << "`p_same_layer` out of range";
@@ -351,4 +377,45 @@ bool environment::debug(bool force_defined) const
   return true;
 }
 
+///
+/// \param[in] t       the topology
+/// \param[in] islands number of islands
+/// \param[in] l       an island
+/// \return            the destinations of the migrants leaving island `l`
+///
+/// \remark With the random topology the result changes at every call.
+///
+std::vector<unsigned> island_neighbours(island_topology t, unsigned islands,
+                                        unsigned l)
+{
+  Expects(islands > 1);
+  Expects(l < islands);
+
+  std::vector<unsigned> ret;
+
+  switch (t)
+  {
+  case island_topology::ring:
+    ret.push_back((l + 1) % islands);
+    break;
+
+  case island_topology::full:
+    for (unsigned i(0); i < islands; ++i)
+      if (i != l)
+        ret.push_back(i);
+    break;
+
+  case island_topology::random:
+  {
+    auto i(random::sup(islands - 1));
+    if (i >= l)
+      ++i;
+    ret.push_back(i);
+    break;
+  }
+  }
+
+  return ret;
+}
+
 }  // namespace vita
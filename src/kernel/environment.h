@@ -16,6 +16,7 @@
 #include <cmath>
 #include <filesystem>
 #include <string>
+#include <vector>
 
 #include "tinyxml2/tinyxml2.h"
 
@@ -42,6 +43,12 @@ enum print_format_t {list_f,  // default value
                      python_language_f = language_f + symbol::python_format};
 }
 
+/// How the islands of vita::island_es (or vita::remote_islands) are
+/// connected.
+enum class island_topology {ring, full, random};
+
+std::vector<unsigned> island_neighbours(island_topology, unsigned, unsigned);
+
 ///
 /// Context object aggregating multiple related parameters into one structure.
 ///
@@ -91,7 +98,8 @@ public:
   /// When the evolution strategy is vita::basic_std_es, setting `layers > 1`
   /// is like running `n` evolutions "in parallel" (the sub-populations of each
   /// layer don't interact). A value greater than one is usually choosen for
-  /// vita::basic_alps_es or with other strategies that allow migrants.
+  /// vita::basic_alps_es, vita::island_es or with other strategies that
+  /// allow migrants.
   ///
   /// \note A value of 0 means undefined (auto-tune).
   unsigned layers = 0;
@@ -219,11 +227,74 @@ public:
   /// `2^cache_size` is the number of elements of the cache.
   unsigned cache_size = 16;
 
+  /// Memory budget (in MB) of the cache. When not `0` the cache is resized
+  /// online (see vita::cache::adapt): `cache_size` is just the initial size.
+  unsigned cache_budget = 0;
+
+  /// Memory budget (in MB) for the gene outputs used by the incremental
+  /// evaluation of the offspring (see vita::column_store). `0` disables the
+  /// incremental evaluation.
+  ///
+  /// \remark
+  /// Only used by the symbolic regression evaluators and only for programs
+  /// whose active code works on `double`s (see vita::real_program): other
+  /// programs are always evaluated from scratch and aren't stored.
+  unsigned column_store_size = 0;
+
+  /// Memory budget (in MB) for the per-example outputs of the recently
+  /// evaluated programs (see vita::output_store). The outputs survive the
+  /// changes of the training set, so after a DSS shake only the examples
+  /// new to a program are evaluated. `0` disables the store.
+  ///
+  /// \remark
+  /// Only used by the symbolic regression evaluators.
+  unsigned output_store_size = 0;
+
+  /// Number of threads used for the evaluation of an individual (the
+  /// examples of the dataset are split among the threads) or of a batch of
+  /// offspring (see `offspring_batch`). `0` means the number of concurrent
+  /// threads supported by the hardware.
+  ///
+  /// \remark
+  /// Only used by the symbolic regression / classification evaluators.
+  unsigned threads = 1;
+
+  /// Number of offspring generated, evaluated and inserted into the
+  /// population at every step of the evolution.
+  ///
+  /// `1` is the classic steady-state scheme. With larger values the offspring
+  /// of a step are generated from the same population, evaluated together
+  /// (possibly concurrently, see `threads`) and then go through the
+  /// replacement phase one at a time, in the order they were generated.
+  unsigned offspring_batch = 1;
+
+  /// Maximum number of runs performed at the same time by search::run. `0`
+  /// means the number of concurrent threads supported by the hardware.
+  ///
+  /// Every concurrent run has its own training evaluator (the cache is
+  /// shared). The results don't depend on this value.
+  ///
+  /// \remark
+  /// Runs are performed one at a time if the validation strategy changes
+  /// the training set during a run (e.g. DSS), with ARL, with remote islands
+  /// or when logging generation-level information (dynamic, layers,
+  /// population files).
+  unsigned parallel_runs = 1;
+
   struct misc_parameters
   {
     /// Filename used for persistance. An empty name is used to skip
     /// serialization.
     std::string serialization_file = "";
+
+    /// File used to store the fitness cache across runs and processes (see
+    /// vita::persistent_cache). An empty name keeps the cache in memory.
+    ///
+    /// \remark
+    /// The file is reused only if the training data and the evaluator are
+    /// unchanged. The fingerprint doesn't capture the code of user-defined
+    /// fitness functions: use a new file when it changes.
+    std::filesystem::path cache_file = {};
   } misc;
 
   struct statistics
@@ -302,6 +373,31 @@ public:
     double p_same_layer = 0.75;
   } alps;
 
+  ///
+  /// Parameters for the island model (see vita::island_es and
+  /// vita::remote_islands).
+  ///
+  /// Every layer of the population is an island: a sub-population evolved by
+  /// its own selection / recombination / replacement loop. Periodically the
+  /// best individuals of an island migrate to the neighbouring islands.
+  ///
+  struct island_parameters
+  {
+    /// Number of generations between two migrations. `0` disables migration
+    /// (islands evolve independently).
+    unsigned interval = 10;
+
+    /// Number of individuals an island sends at every migration.
+    unsigned migrants = 1;
+
+    /// How islands are connected:
+    /// - `ring` every island sends migrants to the next one;
+    /// - `full` every island sends migrants to all the other islands;
+    /// - `random` every island sends migrants to a random island (chosen at
+    ///   each migration).
+    island_topology topology = island_topology::ring;
+  } island;
+
   struct de_parameters
   {
     /// Weighting factor range (aka differential factor range).
@@ -13,6 +13,8 @@
 #if !defined(VITA_EVALUATOR_H)
 #define      VITA_EVALUATOR_H
 
+#include <functional>
+
 #include "kernel/fitness.h"
 #include "kernel/lambda_f.h"
 #include "kernel/random.h"
@@ -26,6 +28,11 @@ public:
   /// Clear possible cached values.
   /// \note The default implementation is empty.
   virtual void clear() {}
+
+  /// Adapts the size of the cache (if any) to the observed workload.
+  /// \return a description of the change (empty if nothing changed)
+  /// \note The default implementation doesn't change anything.
+  virtual std::string adapt(std::size_t) { return {}; }
 };
 
 ///
@@ -64,10 +71,16 @@ public:
 
   // The following methods have a default implementation (usually empty).
   virtual fitness_t fast(const T &);
+  virtual fitness_t race(const T &, const fitness_t &, bool *);
+  virtual std::vector<fitness_t> batch(const std::vector<const T *> &);
   virtual std::string info() const;
   virtual std::unique_ptr<basic_lambda_f> lambdify(const T &) const;
 };
 
+/// Builds a new, independent, evaluator (e.g. one for every thread).
+template<class T>
+using evaluator_factory = std::function<std::shared_ptr<evaluator<T>>()>;
+
 enum class test_evaluator_type {distinct, fixed, random};
 
 ///
@@ -34,6 +34,57 @@ fitness_t evaluator<T>::fast(const T &i)
   return operator()(i);
 }
 
+///
+/// Racing evaluation: calculates the fitness of an individual only as far as
+/// it's needed to compare it with a given bound.
+///
+/// \param[in]  i       an individual to be evaluated
+/// \param[in]  bound   fitness the individual must beat
+/// \param[out] partial `true` if the evaluation has been stopped early
+/// \return             the fitness of `i`. When `*partial` is `true`, the
+///                     value returned is an upper bound of the fitness of `i`
+///                     (and it's smaller than `bound`)
+///
+/// Many times (e.g. tournament replacement) we only need to know if an
+/// individual beats a specific competitor: evaluators can stop as soon as
+/// the result is certain.
+///
+/// \note Default implementation calls the standard fitness function.
+///
+template<class T>
+fitness_t evaluator<T>::race(const T &i, const fitness_t &, bool *partial)
+{
+  Expects(partial);
+
+  *partial = false;
+  return operator()(i);
+}
+
+///
+/// Calculates the fitness of a group of individuals.
+///
+/// \param[in] prgs the individuals to be evaluated
+/// \return         `r[i]` is the fitness of `*prgs[i]`
+///
+/// Evaluators able to work on many individuals at the same time (e.g. on
+/// different threads) should override this method. Results must be the same
+/// of the one-at-a-time evaluation.
+///
+/// \note Default implementation calls the standard fitness function for
+///       every individual.
+///
+template<class T>
+std::vector<fitness_t> evaluator<T>::batch(const std::vector<const T *> &prgs)
+{
+  std::vector<fitness_t> ret;
+  ret.reserve(prgs.size());
+
+  for (const auto *prg : prgs)
+    ret.push_back(operator()(*prg));
+
+  return ret;
+}
+
 ///
 /// \param[in] in input stream
 /// \return       `true` if the object loaded correctly
@@ -14,6 +14,7 @@
 #define      VITA_EVALUATOR_PROXY_H
 
 #include "kernel/cache.h"
+#include "kernel/concurrent_cache.h"
 #include "kernel/evaluator.h"
 
 namespace vita
@@ -22,35 +23,56 @@ namespace vita
 /// Provides a surrogate for an evaluator to control access to it.
 ///
 /// \tparam T the type of individual used
+/// \tparam E the proxied evaluator
+/// \tparam C the hash table (`cache`, `concurrent_cache` or
+///           `persistent_cache`)
 ///
-/// evaluator_proxy uses an ad-hoc internal hash table to cache fitness scores
-/// of individuals.
+/// evaluator_proxy uses an ad-hoc hash table to cache fitness scores of
+/// individuals (both standard and approximated ones, see `fast`).
 ///
-template<class T, class E>
+/// Many proxies (each one with its own evaluator, used by a distinct thread)
+/// can share the same `concurrent_cache`: so every thread benefits from the
+/// evaluations performed by the others.
+///
+/// A private `cache` can be resized online (see `adapt`).
+///
+template<class T, class E, class C = cache>
 class evaluator_proxy : public evaluator<T>
 {
 public:
   evaluator_proxy(E, unsigned);
+  evaluator_proxy(E, std::shared_ptr<C>);
 
   // Serialization.
   bool load(std::istream &) override;
   bool save(std::ostream &) const override;
 
   void clear() override;
+  std::string adapt(std::size_t) override;
 
   fitness_t operator()(const T &) override;
   fitness_t fast(const T &) override;
+  fitness_t race(const T &, const fitness_t &, bool *) override;
+  std::vector<fitness_t> batch(const std::vector<const T *> &) override;
 
   std::string info() const override;
 
   std::unique_ptr<basic_lambda_f> lambdify(const T &) const override;
 
 private:
+  static hash_t fast_key(const hash_t &);
+  fitness_t batched(const hash_t &) const;
+
   // Access to the real evaluator.
   E eva_;
 
-  // Hash table cache.
-  cache cache_;
+  // Hash table cache (possibly shared with other proxies).
+  std::shared_ptr<C> cache_;
+
+  // Fitnesses calculated by the last call of `batch()`. They're available
+  // even if the cache has already evicted them (or another thread has
+  // overwritten them).
+  std::vector<std::pair<hash_t, fitness_t>> batch_;
 };
 
 #include "kernel/evaluator_proxy.tcc"
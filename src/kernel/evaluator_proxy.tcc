@@ -21,25 +21,42 @@
 /// \param[in] eva pointer that lets the proxy access the real evaluator
 /// \param[in] ts  `2^ts` is the number of elements of the cache
 ///
-template<class T, class E>
-evaluator_proxy<T, E>::evaluator_proxy(E eva, unsigned ts)
-  : eva_(std::move(eva)), cache_(ts)
+template<class T, class E, class C>
+evaluator_proxy<T, E, C>::evaluator_proxy(E eva, unsigned ts)
+  : eva_(std::move(eva)), cache_(std::make_shared<C>(ts)), batch_()
 {
   Expects(ts > 6);
 }
 
+///
+/// \param[in] eva pointer that lets the proxy access the real evaluator
+/// \param[in] c   a (possibly shared) cache
+///
+/// \remark
+/// When the cache is shared, the proxied evaluators must give the same
+/// fitness for the same individual (e.g. they work on copies of the same
+/// dataset).
+///
+template<class T, class E, class C>
+evaluator_proxy<T, E, C>::evaluator_proxy(E eva, std::shared_ptr<C> c)
+  : eva_(std::move(eva)), cache_(std::move(c)), batch_()
+{
+  Expects(cache_);
+}
+
 ///
 /// \param[in] prg the program (individual/team) whose fitness we want to know
 /// \return        the fitness of `prg`
 ///
-template<class T, class E>
-fitness_t evaluator_proxy<T, E>::operator()(const T &prg)
+template<class T, class E, class C>
+fitness_t evaluator_proxy<T, E, C>::operator()(const T &prg)
 {
-  fitness_t f(cache_.find(prg.signature()));
+  fitness_t f(cache_->find(prg.signature()));
 
   if (f.size())
   {
-    assert(cache_.hits());
+    // A shared cache can be concurrently cleared.
+    assert((!std::is_same_v<C, cache> || cache_->hits()));
 
     // Hash collision checking code can slow down the program very much.
 #if !defined(NDEBUG)
@@ -64,16 +81,20 @@ fitness_t evaluator_proxy<T, E>::operator()(const T &prg)
     // effective size and so distinct fitnesses.
 #endif
   }
-  else  // not found in cache
+  else if (f = batched(prg.signature()); !f.size())  // not found in cache
   {
     f = eva_(prg);
 
-    cache_.insert(prg.signature(), f);
+    cache_->insert(prg.signature(), f);
 
 #if !defined(NDEBUG)
-    fitness_t f1(cache_.find(prg.signature()));
-    assert(f1.size());
-    assert(almost_equal(f, f1));
+    // Other threads sharing the cache could have overwritten the slot.
+    if constexpr (std::is_same_v<C, cache>)
+    {
+      fitness_t f1(cache_->find(prg.signature()));
+      assert(f1.size());
+      assert(almost_equal(f, f1));
+    }
 #endif
   }
 
@@ -84,10 +105,160 @@ fitness_t evaluator_proxy<T, E>::operator()(const T &prg)
 /// \param[in] prg the program (individual/team) whose fitness we want to know
 /// \return        an approximation of the fitness of `prg`
 ///
-template<class T, class E>
-fitness_t evaluator_proxy<T, E>::fast(const T &prg)
+/// Approximated fitnesses are cached too (see `fast_key`): they share the
+/// table, and so the invalidation rules, with the standard fitnesses but
+/// never mix with them.
+///
+template<class T, class E, class C>
+fitness_t evaluator_proxy<T, E, C>::fast(const T &prg)
+{
+  // When the proxied evaluator doesn't specialize `fast` the standard (cached)
+  // evaluation is all we need.
+  if constexpr (std::is_same_v<decltype(&E::fast),
+                               fitness_t (evaluator<T>::*)(const T &)>)
+    return operator()(prg);
+  else
+  {
+    const auto key(fast_key(prg.signature()));
+
+    fitness_t f(cache_->find(key));
+    if (!f.size())
+    {
+      f = eva_.fast(prg);
+      cache_->insert(key, f);
+    }
+
+    return f;
+  }
+}
+
+///
+/// \param[in] h signature of a program
+/// \return      the key used to cache the approximated fitness of the
+///              program
+///
+/// The key is a fixed transformation of `h`: a collision with the signature
+/// of another program is as likely as a collision between two signatures.
+///
+template<class T, class E, class C>
+hash_t evaluator_proxy<T, E, C>::fast_key(const hash_t &h)
 {
-  return eva_.fast(prg);
+  return hash_t(h.data[0] ^ 0x9e3779b97f4a7c15, h.data[1] ^ 0xc2b2ae3d27d4eb4f);
+}
+
+///
+/// \param[in]  prg     the program (individual/team) whose fitness we want to
+///                     know
+/// \param[in]  bound   fitness `prg` must beat
+/// \param[out] partial `true` if the fitness returned is just an upper bound
+/// \return             the (possibly partial) fitness of `prg`
+///
+/// Partial results are cached too: they're reused by subsequent races with
+/// a bound they don't reach and ignored by operator().
+///
+/// \see evaluator::race
+///
+template<class T, class E, class C>
+fitness_t evaluator_proxy<T, E, C>::race(const T &prg, const fitness_t &bound,
+                                      bool *partial)
+{
+  Expects(partial);
+
+  const fitness_t f(cache_->find(prg.signature(), partial));
+
+  if (f.size() && (!*partial || f < bound))
+    return f;
+
+  if (const auto fb = batched(prg.signature()); fb.size())
+  {
+    *partial = false;
+    return fb;
+  }
+
+  const fitness_t ret(eva_.race(prg, bound, partial));
+  cache_->insert(prg.signature(), ret, *partial);
+
+  return ret;
+}
+
+///
+/// \param[in] prgs the programs (individuals/teams) whose fitness we want to
+///                 know
+/// \return         `r[i]` is the fitness of `*prgs[i]`
+///
+/// Only the programs missing from the cache are passed (once) to the real
+/// evaluator, which may evaluate them concurrently. Results are then cached
+/// in the order of `prgs`.
+///
+/// The results are also kept aside until the next call: the subsequent
+/// requests for the same programs (e.g. from the replacement phase of the
+/// evolution) never trigger a new evaluation, whatever the cache evicts in
+/// the meantime.
+///
+/// \see evaluator::batch
+///
+template<class T, class E, class C>
+std::vector<fitness_t> evaluator_proxy<T, E, C>::batch(
+  const std::vector<const T *> &prgs)
+{
+  batch_.clear();
+
+  std::vector<fitness_t> ret;
+  ret.reserve(prgs.size());
+
+  std::vector<const T *> missing;
+  std::vector<std::size_t> where;  // `ret[i]` is the `where[i]`-th missing
+
+  for (const auto *prg : prgs)
+  {
+    ret.push_back(cache_->find(prg->signature()));
+
+    if (!ret.back().size())
+    {
+      const auto sig(prg->signature());
+      const auto dup(std::find_if(missing.begin(), missing.end(),
+                                  [&sig](const T *m)
+                                  {
+                                    return m->signature() == sig;
+                                  }));
+
+      where.push_back(std::distance(missing.begin(), dup));
+      if (dup == missing.end())
+        missing.push_back(prg);
+    }
+  }
+
+  if (!missing.empty())
+  {
+    const auto fits(eva_.batch(missing));
+    assert(fits.size() == missing.size());
+
+    for (std::size_t i(0), j(0); i < ret.size(); ++i)
+      if (!ret[i].size())
+      {
+        ret[i] = fits[where[j++]];
+        cache_->insert(prgs[i]->signature(), ret[i]);
+      }
+  }
+
+  for (std::size_t i(0); i < ret.size(); ++i)
+    batch_.emplace_back(prgs[i]->signature(), ret[i]);
+
+  return ret;
+}
+
+///
+/// \param[in] h signature of a program
+/// \return      the fitness of the program calculated by the last call of
+///              `batch()` (an empty fitness if not available)
+///
+template<class T, class E, class C>
+fitness_t evaluator_proxy<T, E, C>::batched(const hash_t &h) const
+{
+  const auto it(std::find_if(batch_.begin(), batch_.end(),
+                             [&h](const auto &e) { return e.first == h; }));
+
+  return it == batch_.end() ? fitness_t() : it->second;
 }
 
 ///
@@ -99,52 +270,79 @@ fitness_t evaluator_proxy<T, E>::fast(const T &prg)
 /// The temporary object needed to holds values from the stream conceivably is
 /// too big to justify the "no change" warranty.
 ///
-template<class T, class E>
-bool evaluator_proxy<T, E>::load(std::istream &in)
+template<class T, class E, class C>
+bool evaluator_proxy<T, E, C>::load(std::istream &in)
 {
-  return eva_.load(in) && cache_.load(in);
+  return eva_.load(in) && cache_->load(in);
 }
 
 ///
 /// \param[out] out output stream
 /// \return         `true` if the object was saved correctly
 ///
-template<class T, class E>
-bool evaluator_proxy<T, E>::save(std::ostream &out) const
+template<class T, class E, class C>
+bool evaluator_proxy<T, E, C>::save(std::ostream &out) const
 {
-  return eva_.save(out) && cache_.save(out);
+  return eva_.save(out) && cache_->save(out);
 }
 
 ///
-/// Resets the evaluation cache.
+/// Resets the evaluation cache and the caches of the proxied evaluator.
+///
+template<class T, class E, class C>
+void evaluator_proxy<T, E, C>::clear()
+{
+  cache_->clear();
+  batch_.clear();
+  eva_.clear();
+}
+
+///
+/// Resizes the cache according to the hit ratio and the eviction rate
+/// observed since the previous call.
+///
+/// \param[in] budget maximum memory (in bytes) used by the cache
+/// \return           a description of the change (empty if nothing changed)
+///
+/// \remark
+/// Only `cache` is resized: a `concurrent_cache` is shared among threads
+/// and a `persistent_cache` is linked to a file of fixed size.
+///
+/// \see cache::adapt
 ///
-template<class T, class E>
-void evaluator_proxy<T, E>::clear()
+template<class T, class E, class C>
+std::string evaluator_proxy<T, E, C>::adapt(std::size_t budget)
 {
-  cache_.clear();
+  if constexpr (std::is_same_v<C, cache>)
+    return cache_->adapt(budget);
+  else
+    return {};
 }
 
 ///
-/// \return number of cache probes / hits
+/// \return number of cache probes / hits (followed by the info of the proxied
+///         evaluator, if available)
 ///
-template<class T, class E>
-std::string evaluator_proxy<T, E>::info() const
+template<class T, class E, class C>
+std::string evaluator_proxy<T, E, C>::info() const
 {
-  const auto hits(cache_.hits());
-  const auto probes(cache_.probes());
+  const auto hits(cache_->hits());
+  const auto probes(cache_->probes());
+  const auto eva_info(eva_.info());
 
   return
     "hits " + std::to_string(hits) +
     ", probes " + std::to_string(probes) +
-    (probes ? " (ratio " + std::to_string(hits * 100 / probes) + "%)" : "");
+    (probes ? " (ratio " + std::to_string(hits * 100 / probes) + "%)" : "") +
+    (eva_info.empty() ? "" : "; " + eva_info);
 }
 
 ///
 /// \param[in] prg a program (individual/team)
 /// \return        a pointer to the executable version of `prg`
 ///
-template<class T, class E>
-std::unique_ptr<basic_lambda_f> evaluator_proxy<T, E>::lambdify(
+template<class T, class E, class C>
+std::unique_ptr<basic_lambda_f> evaluator_proxy<T, E, C>::lambdify(
   const T &prg) const
 {
   return eva_.lambdify(prg);
@@ -15,11 +15,13 @@
 
 #include <algorithm>
 #include <csignal>
+#include <mutex>
 
 #include "kernel/evaluator_proxy.h"
 #include "kernel/evolution_strategy.h"
 #include "kernel/evolution_summary.h"
 #include "kernel/population.h"
+#include "kernel/remote_islands.h"
 #include "utility/timer.h"
 
 namespace vita
@@ -45,6 +47,8 @@ public:
   evolution(const problem &, evaluator<T> &);
 
   evolution &after_generation(after_generation_callback_t);
+  evolution &evaluators(evaluator_factory<T>);
+  evolution &migration(remote_islands<T> *);
 
   const summary<T> &run(unsigned);
   template<class S> const summary<T> &run(unsigned, S);
@@ -53,8 +57,9 @@ public:
 
 private:
   // *** Support methods ***
+  std::string adapt_cache();
   analyzer<T> get_stats() const;
-  void log_evolution(unsigned) const;
+  void log_evolution(unsigned, const std::string &) const;
   void print_progress(unsigned, unsigned, bool, timer *) const;
   bool stop_condition(const summary<T> &) const;
 
@@ -65,6 +70,9 @@ private:
   ES<T>          es_;
 
   after_generation_callback_t after_generation_callback_;
+
+  // Link to the islands evolving in other processes (optional).
+  remote_islands<T> *migration_;
 };
 
 #include "kernel/evolution.tcc"
@@ -19,12 +19,22 @@
 
 namespace term
 {
+// Concurrent runs (see search::run) share the terminal: it's set up by the
+// first active evolution and restored by the last one.
+inline std::mutex mutex;
+inline unsigned users(0);
+
 ///
 /// \return `true` when the user presses the '.' key
 ///
 inline bool user_stop()
 {
-  const bool stop(keypressed('.'));
+  bool stop;
+
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    stop = keypressed('.');
+  }
 
   if (stop)
   {
@@ -35,9 +45,9 @@ inline bool user_stop()
 }
 
 ///
-/// Resets the term and restores the default signal handlers.
+/// Unconditionally resets the term and restores the default signal handlers.
 ///
-inline void reset()
+inline void restore()
 {
   std::signal(SIGABRT, SIG_DFL);
   std::signal(SIGINT, SIG_DFL);
@@ -46,13 +56,25 @@ inline void reset()
   term_raw_mode(false);
 }
 
+///
+/// Resets the term and restores the default signal handlers (when no other
+/// evolution is active).
+///
+inline void reset()
+{
+  const std::lock_guard<std::mutex> lock(mutex);
+
+  if (--users == 0)
+    restore();
+}
+
 ///
 /// If the program receives a SIGABRT / SIGINT / SIGTERM, it must handle
 /// the signal and reset the terminal to the initial state.
 ///
 inline void signal_handler(int signum)
 {
-  term::reset();
+  term::restore();
 
   std::raise(signum);
 }
@@ -62,6 +84,11 @@ inline void signal_handler(int signum)
 ///
 inline void set()
 {
+  const std::lock_guard<std::mutex> lock(mutex);
+
+  if (users++)
+    return;
+
   // Install our signal handler.
   std::signal(SIGABRT, term::signal_handler);
   std::signal(SIGINT, term::signal_handler);
@@ -77,7 +104,8 @@ inline void set()
 ///
 template<class T, template<class> class ES>
 evolution<T, ES>::evolution(const problem &p, evaluator<T> &eva)
-  : pop_(p), eva_(eva), es_(pop_, eva_, &stats_), after_generation_callback_()
+  : pop_(p), eva_(eva), es_(pop_, eva_, &stats_),
+    after_generation_callback_(), migration_(nullptr)
 {
   Expects(p.debug());
   Ensures(debug());
@@ -97,6 +125,40 @@ evolution<T, ES> &evolution<T, ES>::after_generation(
   return *this;
 }
 
+///
+/// Sets the source of additional evaluators.
+///
+/// \param[in] f builds a new evaluator, independent from the one passed to
+///              the constructor
+/// \return      a reference to `*this` object (fluent interface)
+///
+/// Strategies evolving many layers concurrently (see vita::island_es) need
+/// an evaluator for every thread. Other strategies ignore `f`.
+///
+template<class T, template<class> class ES>
+evolution<T, ES> &evolution<T, ES>::evaluators(evaluator_factory<T> f)
+{
+  if constexpr (ES<T>::is_island)
+    es_.evaluators(f);
+
+  return *this;
+}
+
+///
+/// Exchanges migrants with populations evolving in other processes.
+///
+/// \param[in] r link to the other processes (`nullptr` for a stand-alone
+///              evolution). The lifetime of `r` must exceed the lifetime of
+///              the evolution
+/// \return      a reference to `*this` object (fluent interface)
+///
+template<class T, template<class> class ES>
+evolution<T, ES> &evolution<T, ES>::migration(remote_islands<T> *r)
+{
+  migration_ = r;
+  return *this;
+}
+
 ///
 /// \param[in] s an up to date evolution summary
 /// \return      `true` when evolution should be interrupted
@@ -118,6 +180,29 @@ bool evolution<T, ES>::stop_condition(const summary<T> &s) const
   return es_.stop_condition();
 }
 
+///
+/// Resizes the cache of the evaluator (if allowed by the environment).
+///
+/// \return a description of the change (empty if nothing changed)
+///
+/// \see evaluator_proxy::adapt
+///
+template<class T, template<class> class ES>
+std::string evolution<T, ES>::adapt_cache()
+{
+  const auto budget(pop_.get_problem().env.cache_budget);
+  if (!budget)
+    return {};
+
+  const auto ret(eva_.adapt(std::size_t(budget) << 20));
+  if (!ret.empty())
+  {
+    vitaINFO << ret;
+  }
+
+  return ret;
+}
+
 ///
 /// \return statistical information about the population
 ///
@@ -136,6 +221,8 @@ analyzer<T> evolution<T, ES>::get_stats() const
 /// Saves working / statistical informations in a log file.
 ///
 /// \param[in] run_count run number
+/// \param[in] cache     a description of the last change of the cache size
+///                      (empty if nothing changed)
 ///
 /// Data are written in a CSV-like fashion and are partitioned in blocks
 /// separated by two blank lines:
@@ -154,10 +241,17 @@ analyzer<T> evolution<T, ES>::get_stats() const
 /// CSV-like file. Note also that it's simple to extract and plot data with
 /// GNU Plot.
 ///
+/// Changes of the cache size are written in the dynamic file as comment
+/// lines (`# ...`, ignored by GNU Plot) preceding the line of the
+/// generation.
+///
 template<class T, template<class> class ES>
-void evolution<T, ES>::log_evolution(unsigned run_count) const
+void evolution<T, ES>::log_evolution(unsigned run_count,
+                                     const std::string &cache) const
 {
-  static unsigned last_run(0);
+  // Concurrent runs don't log generation-level information (see
+  // search::run) but every thread has its own copy, just in case.
+  thread_local unsigned last_run(0);
 
   const auto &env(pop_.get_problem().env);
 
@@ -174,6 +268,9 @@ void evolution<T, ES>::log_evolution(unsigned run_count) const
       if (last_run != run_count)
         f_dyn << "\n\n";
 
+      if (!cache.empty())
+        f_dyn << "# " << cache << '\n';
+
       f_dyn << run_count << ' ' << stats_.gen;
 
       if (stats_.best.solution.empty())
@@ -279,6 +376,15 @@ void evolution<T, ES>::print_progress(unsigned k, unsigned run_count,
 /// * place the offspring into the original population (steady state)
 ///   replacing a bad individual.
 ///
+/// With `env.offspring_batch > 1` many offspring are generated from the same
+/// population, evaluated together (see evaluator::batch) and then placed, in
+/// order, into the population. Selection, recombination and replacement run
+/// on the calling thread: for a given seed the evolution is reproducible.
+///
+/// With vita::island_es every layer is an island performing its own loop
+/// (possibly on its own thread, see island_es::evolve) and
+/// `env.offspring_batch` is ignored.
+///
 /// This whole process repeats until the termination criteria is satisfied.
 /// With any luck, it will produce an individual that solves the problem at
 /// hand.
@@ -306,6 +412,15 @@ const summary<T> &evolution<T, ES>::run(unsigned run_count, S shake)
 
   es_.init();  // customizatin point for strategy-specific initialization
 
+  // Offspring generated at every step (`1` for the steady-state scheme).
+  const auto batch(pop_.get_problem().env.offspring_batch);
+  Expects(batch);
+
+  std::vector<typename selection::strategy<T>::parents_t> parents;
+  std::vector<typename recombination::strategy<T>::offspring_t> offspring;
+  parents.reserve(batch);
+  offspring.reserve(batch);
+
   for (stats_.gen = 0; !stop_condition(stats_) && !stop;  ++stats_.gen)
   {
     if (shake(stats_.gen))
@@ -319,35 +434,87 @@ const summary<T> &evolution<T, ES>::run(unsigned run_count, S shake)
       print_progress(0, run_count, true, &from_last_msg);
     }
 
+    // Cache sizing is based on the statistics of the previous generation.
+    const auto cache_change(adapt_cache());
+
     stats_.az = get_stats();
-    log_evolution(run_count);
+    log_evolution(run_count, cache_change);
 
-    for (unsigned k(0); k < pop_.individuals() && !stop; ++k)
+    if constexpr (ES<T>::is_island)
     {
+      // --------- ISLANDS ---------
+      // Every island performs a whole generation on its own.
       if (from_last_msg.elapsed() > std::chrono::seconds(2))
-      {
-        print_progress(k, run_count, false, &from_last_msg);
-
-        stop = term::user_stop();
-      }
-
-      // --------- SELECTION ---------
-      auto parents(es_.selection.run());
-
-      // --------- CROSSOVER / MUTATION ---------
-      auto off(es_.recombination.run(parents));
+        print_progress(0, run_count, false, &from_last_msg);
 
-      // --------- REPLACEMENT --------
       const auto before(stats_.best.score.fitness);
-      es_.replacement.run(parents, off, &stats_);
+      es_.evolve();
 
       if (stats_.best.score.fitness != before)
-        print_progress(k, run_count, true, &from_last_msg);
+        print_progress(pop_.individuals(), run_count, true, &from_last_msg);
+      else if (from_last_msg.elapsed() > std::chrono::seconds(2))
+        print_progress(pop_.individuals(), run_count, false, &from_last_msg);
+
+      stop = term::user_stop();
+    }
+    else
+    {
+      for (unsigned k(0); k < pop_.individuals() && !stop; k += batch)
+      {
+        if (from_last_msg.elapsed() > std::chrono::seconds(2))
+        {
+          print_progress(k, run_count, false, &from_last_msg);
+
+          stop = term::user_stop();
+        }
+
+        const auto n(std::min(batch, pop_.individuals() - k));
+        parents.clear();
+        offspring.clear();
+
+        for (unsigned i(0); i < n; ++i)
+        {
+          // --------- SELECTION ---------
+          parents.push_back(es_.selection.run());
+
+          // --------- CROSSOVER / MUTATION ---------
+          offspring.push_back(es_.recombination.run(parents.back()));
+        }
+
+        // --------- EVALUATION --------
+        // Offspring of the same step are evaluated together (possibly
+        // concurrently). The replacement phase finds their fitness in the
+        // evaluator proxy (see evaluator_proxy::batch).
+        // A plain evaluator would lose the results and evaluate every
+        // offspring twice (vita::search always wraps it in a proxy).
+        if (n > 1)
+        {
+          std::vector<const T *> prgs;
+          for (const auto &off : offspring)
+            prgs.push_back(&off[0]);
+
+          eva_.batch(prgs);
+        }
+
+        // --------- REPLACEMENT --------
+        for (unsigned i(0); i < n; ++i)
+        {
+          const auto before(stats_.best.score.fitness);
+          es_.replacement.run(parents[i], offspring[i], &stats_);
+
+          if (stats_.best.score.fitness != before)
+            print_progress(k + i, run_count, true, &from_last_msg);
+        }
+      }
     }
 
     stats_.elapsed = measure.elapsed();
 
     es_.after_generation();  // hook for strategy-specific bookkeeping
+
+    if (migration_)
+      migration_->exchange(pop_, eva_, &stats_);
+
     if (after_generation_callback_)
       after_generation_callback_(pop_, stats_);
   }
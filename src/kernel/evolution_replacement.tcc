@@ -103,7 +103,8 @@ void family_competition<T>::run(
 ///
 /// Parameters from the environment:
 /// * elitism is `true` => child replaces a member of the population only if
-///   child is better.
+///   child is better;
+/// * dss is enabled => no racing evaluation of the offspring.
 ///
 template<class T>
 void tournament<T>::run(
@@ -114,8 +115,6 @@ void tournament<T>::run(
   const auto elitism(pop.get_problem().env.elitism);
   Expects(elitism != trilean::unknown);
 
-  const auto fit_off(this->eva_(offspring[0]));
-
   // In old versions of Vita, the individual to be replaced was chosen with
   // an ad-hoc kill tournament.
   // Now we perform just one tournament for choosing the parents; the
@@ -127,6 +126,24 @@ void tournament<T>::run(
   // (aka deterministic / probabilistic crowding).
   const auto rep_idx(parent.back());
   const auto f_rep_idx(this->eva_(pop[rep_idx]));
+
+  // With elitism the offspring only has to beat the individual to be
+  // replaced: most of the times it doesn't and a racing evaluation can stop
+  // early.
+  // Not with DSS: the difficulty of the examples skipped by an early stop
+  // wouldn't be updated, biasing the selection of the next training subset.
+  const bool racing(elitism == trilean::yes
+                    && !pop.get_problem().env.dss.value_or(0));
+
+  bool partial(false);
+  auto fit_off(racing
+               ? this->eva_.race(offspring[0], f_rep_idx, &partial)
+               : this->eva_(offspring[0]));
+
+  // An upper bound isn't enough to update the best-so-far individual.
+  if (partial && fit_off > s->best.score.fitness)
+    fit_off = this->eva_(offspring[0]);
+
   const bool replace(f_rep_idx < fit_off);
 
   if (elitism == trilean::no || replace)
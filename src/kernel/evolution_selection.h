@@ -72,6 +72,7 @@ public:
   using tournament::strategy::strategy;
 
   typename strategy<T>::parents_t run();
+  typename strategy<T>::parents_t run(typename population<T>::coord);
 };
 
 ///
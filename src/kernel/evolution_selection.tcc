@@ -54,13 +54,27 @@ strategy<T>::strategy(const population<T> &pop, evaluator<T> &eva,
 ///
 template<class T>
 typename strategy<T>::parents_t tournament<T>::run()
+{
+  return run(pickup(this->pop_));
+}
+
+///
+/// \param[in] target coordinates of a reference individual
+/// \return           a collection of coordinates of individuals (in the same
+///                   layer of `target`) ordered in descending fitness
+///
+/// The tournament takes place near `target` (see `mate_zone`). This is
+/// useful when layers must not interact (e.g. the island model).
+///
+template<class T>
+typename strategy<T>::parents_t tournament<T>::run(
+  typename population<T>::coord target)
 {
   const auto &pop(this->pop_);
 
   const auto rounds(pop.get_problem().env.tournament_size);
   assert(rounds);
 
-  const auto target(pickup(pop));
   typename strategy<T>::parents_t ret(rounds);
 
   // This is the inner loop of an insertion sort algorithm. It's simple, fast
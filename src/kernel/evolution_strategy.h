@@ -13,9 +13,14 @@
 #if !defined(VITA_EVOLUTION_STRATEGY_H)
 #define      VITA_EVOLUTION_STRATEGY_H
 
+#include <numeric>
+#include <tuple>
+
 #include "kernel/evolution_recombination.h"
 #include "kernel/evolution_replacement.h"
 #include "kernel/evolution_selection.h"
+#include "utility/spsc_queue.h"
+#include "utility/thread_pool.h"
 
 namespace vita
 {
@@ -76,6 +81,9 @@ public:
   static constexpr bool is_de =
     std::is_same<CS<T>, typename vita::recombination::de<T>>::value;
 
+  /// Strategies evolving every layer on its own (see vita::island_es).
+  static constexpr bool is_island = false;
+
 public:
   SS<T> selection;
   CS<T> recombination;
@@ -189,6 +197,79 @@ public:
   using de_alps_es::basic_alps_es::basic_alps_es;
 };
 
+///
+/// Island model.
+///
+/// Every layer of the population is an island: an independent sub-population
+/// with its own selection (tournament), recombination and replacement loop.
+/// Islands are evolved concurrently, one thread per island, when additional
+/// evaluators are available (see evolution::evaluators), otherwise one after
+/// the other.
+///
+/// Every `env.island.interval` generations the best `env.island.migrants`
+/// individuals of an island are sent to the neighbouring islands (see
+/// environment::island_parameters) through bounded lock-free queues.
+/// Immigrants replace the worst individuals of the destination island at the
+/// beginning of the next generation.
+///
+/// \remark
+/// Islands are synchronized at the end of every generation, so statistics,
+/// logging and stop conditions work as with the other strategies. Every
+/// island has its own random stream: for a given seed, results don't depend
+/// on the number of threads.
+///
+template<class T>
+class island_es : public evolution_strategy<T,
+                                            selection::tournament,
+                                            recombination::base,
+                                            replacement::tournament>
+{
+public:
+  island_es(population<T> &, evaluator<T> &, summary<T> *);
+
+  void evaluators(evaluator_factory<T>);
+
+  void init();
+  void evolve();
+
+  static environment shape(environment);
+
+  static constexpr bool is_island = true;
+
+private:
+  struct migrant
+  {
+    T individual;
+    unsigned gen;   // generation of departure
+    unsigned from;  // island of departure
+  };
+
+  spsc_queue<migrant> &channel(unsigned, unsigned);
+  std::vector<unsigned> neighbours(unsigned) const;
+  std::vector<unsigned> ranking(unsigned, evaluator<T> &) const;
+
+  void evolve(unsigned, evaluator<T> &);
+  void emigrate(unsigned, evaluator<T> &);
+  void immigrate(unsigned, evaluator<T> &);
+
+  evaluator<T> &eva_;
+
+  // Additional evaluators (one for every thread but the calling one).
+  evaluator_factory<T> factory_;
+  std::vector<std::shared_ptr<evaluator<T>>> workers_;
+  std::unique_ptr<thread_pool> pool_;
+
+  std::vector<random::engine_t> engines_;  // random stream of every island
+  std::vector<summary<T>> sums_;           // statistics of every island
+
+  // `channels_[from * islands + to]` contains the migrants travelling from
+  // island `from` to island `to`.
+  std::vector<std::unique_ptr<spsc_queue<migrant>>> channels_;
+
+  // Migrants received by every island and waiting to be accepted.
+  std::vector<std::vector<migrant>> inboxes_;
+};
+
 #include "kernel/evolution_strategy.tcc"
 }  // namespace vita
 
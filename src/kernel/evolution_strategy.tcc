@@ -164,4 +164,302 @@ void basic_alps_es<T, CS>::log_strategy(unsigned last_run,
     }
   }
 }
+
+///
+/// \param[in] pop the population (every layer is an island)
+/// \param[in] eva evaluator used by the calling thread
+/// \param[in] s   statistical summary of the whole evolution
+///
+template<class T>
+island_es<T>::island_es(population<T> &pop, evaluator<T> &eva, summary<T> *s)
+  : island_es::evolution_strategy(pop, eva, s), eva_(eva), factory_(),
+    workers_(), pool_(), engines_(), sums_(), channels_(), inboxes_()
+{
+}
+
+///
+/// Sets the source of the additional evaluators required to evolve the
+/// islands concurrently.
+///
+/// \param[in] f builds an evaluator independent from the one passed to the
+///              constructor (an empty function means sequential evolution)
+///
+template<class T>
+void island_es<T>::evaluators(evaluator_factory<T> f)
+{
+  factory_ = f;
+}
+
+///
+/// \param[out] env environment
+/// \return         a strategy-specific environment
+///
+/// \remark Four islands by default.
+///
+template<class T>
+environment island_es<T>::shape(environment env)
+{
+  env.layers = 4;
+  return env;
+}
+
+///
+/// Creates the islands and the communication channels.
+///
+/// Every island gets its own random stream, derived from the current state
+/// of the random engine.
+///
+template<class T>
+void island_es<T>::init()
+{
+  auto &pop(this->pop_);
+  const auto &env(pop.get_problem().env);
+
+  while (pop.layers() < env.layers)
+    pop.add_layer();
+
+  const auto islands(pop.layers());
+
+  const auto seed(random::engine());
+  engines_.clear();
+  for (unsigned l(0); l < islands; ++l)
+  {
+    engines_.push_back(random::engine);
+    engines_.back().seed(seed + l);
+  }
+
+  sums_.assign(islands, summary<T>());
+
+  // Every island drains its incoming channels at the beginning of each
+  // generation so a channel contains, at most, the migrants of two
+  // consecutive migrations.
+  channels_.clear();
+  for (unsigned i(0); i < islands * islands; ++i)
+    channels_.push_back(
+      std::make_unique<spsc_queue<migrant>>(2 * std::max(env.island.migrants,
+                                                         1u)));
+  inboxes_.assign(islands, {});
+
+  workers_.clear();
+  pool_.reset();
+  if (factory_ && islands > 1)
+  {
+    for (unsigned w(1); w < islands; ++w)
+      workers_.push_back(factory_());
+
+    pool_ = std::make_unique<thread_pool>(islands);
+  }
+}
+
+///
+/// \param[in] from island of departure
+/// \param[in] to   island of arrival
+/// \return         the channel connecting island `from` to island `to`
+///
+template<class T>
+spsc_queue<typename island_es<T>::migrant> &island_es<T>::channel(
+  unsigned from, unsigned to)
+{
+  const auto islands(this->pop_.layers());
+  Expects(from < islands);
+  Expects(to < islands);
+
+  return *channels_[from * islands + to];
+}
+
+///
+/// \param[in] l an island
+/// \return     the destinations of the migrants leaving island `l`
+///
+template<class T>
+std::vector<unsigned> island_es<T>::neighbours(unsigned l) const
+{
+  return island_neighbours(this->pop_.get_problem().env.island.topology,
+                           this->pop_.layers(), l);
+}
+
+///
+/// \param[in] l   an island
+/// \param[in] eva evaluator used by the current thread
+/// \return        the indexes of the individuals of island `l` in descending
+///                fitness order
+///
+template<class T>
+std::vector<unsigned> island_es<T>::ranking(unsigned l,
+                                            evaluator<T> &eva) const
+{
+  const auto &pop(this->pop_);
+  const auto n(pop.individuals(l));
+
+  std::vector<fitness_t> fit;
+  fit.reserve(n);
+  for (unsigned i(0); i < n; ++i)
+    fit.push_back(eva(pop[{l, i}]));
+
+  std::vector<unsigned> ret(n);
+  std::iota(ret.begin(), ret.end(), 0);
+  std::stable_sort(ret.begin(), ret.end(),
+                   [&fit](unsigned a, unsigned b) { return fit[a] > fit[b]; });
+
+  return ret;
+}
+
+///
+/// Sends copies of the best individuals of an island to its neighbours.
+///
+/// \param[in] l   an island
+/// \param[in] eva evaluator used by the current thread
+///
+template<class T>
+void island_es<T>::emigrate(unsigned l, evaluator<T> &eva)
+{
+  const auto &pop(this->pop_);
+  if (pop.layers() < 2)
+    return;
+
+  const auto best(ranking(l, eva));
+  const auto m(std::min<std::size_t>(pop.get_problem().env.island.migrants,
+                                     best.size()));
+
+  for (auto to : neighbours(l))
+    for (std::size_t i(0); i < m; ++i)
+      // When the channel is full the migrant is lost.
+      channel(l, to).push({pop[{l, best[i]}], sums_[l].gen, l});
+}
+
+///
+/// Moves the incoming migrants into an island.
+///
+/// \param[in] l   an island
+/// \param[in] eva evaluator used by the current thread
+///
+/// Immigrants replace the worst individuals of the island (if better).
+///
+template<class T>
+void island_es<T>::immigrate(unsigned l, evaluator<T> &eva)
+{
+  auto &pop(this->pop_);
+  auto &inbox(inboxes_[l]);
+
+  migrant incoming;
+  for (unsigned from(0); from < pop.layers(); ++from)
+    while (channel(from, l).pop(&incoming))
+      inbox.push_back(incoming);
+
+  // Only migrants leaving during a previous generation are accepted. The
+  // others come from a faster island and must wait: this way the evolution
+  // doesn't depend on the scheduling of the threads.
+  const auto gen(sums_[l].gen);
+  const auto arrived(std::stable_partition(
+                       inbox.begin(), inbox.end(),
+                       [gen](const migrant &m) { return m.gen < gen; }));
+  std::stable_sort(inbox.begin(), arrived,
+                   [](const migrant &a, const migrant &b)
+                   {
+                     return std::tie(a.gen, a.from) < std::tie(b.gen, b.from);
+                   });
+
+  if (inbox.begin() != arrived)
+  {
+    const auto rank(ranking(l, eva));
+
+    auto worst(rank.rbegin());
+    for (auto it(inbox.begin()); it != arrived && worst != rank.rend();
+         ++it, ++worst)
+    {
+      const typename population<T>::coord c{l, *worst};
+
+      if (eva(it->individual) > eva(pop[c]))
+        pop[c] = it->individual;
+    }
+  }
+
+  inbox.erase(inbox.begin(), arrived);
+}
+
+///
+/// Evolves an island for a generation.
+///
+/// \param[in] l   an island
+/// \param[in] eva evaluator used by the current thread
+///
+template<class T>
+void island_es<T>::evolve(unsigned l, evaluator<T> &eva)
+{
+  auto &pop(this->pop_);
+  auto &sum(sums_[l]);
+
+  immigrate(l, eva);
+
+  selection::tournament<T> select(pop, eva, sum);
+  recombination::base<T> recombine(pop, eva, &sum);
+  replacement::tournament<T> replace(pop, eva);
+
+  const auto n(pop.individuals(l));
+  for (unsigned k(0); k < n; ++k)
+  {
+    const auto parents(select.run({l, random::sup(n)}));
+    replace.run(parents, recombine.run(parents), &sum);
+  }
+
+  const auto interval(pop.get_problem().env.island.interval);
+  if (interval && (sum.gen + 1) % interval == 0)
+    emigrate(l, eva);
+}
+
+///
+/// Evolves every island for a generation.
+///
+/// Islands are evolved concurrently if additional evaluators are available
+/// (see island_es::evaluators). Statistics of the islands are then merged,
+/// in island order, into the summary of the evolution.
+///
+template<class T>
+void island_es<T>::evolve()
+{
+  const auto islands(this->pop_.layers());
+  Expects(engines_.size() == islands);
+
+  auto &sum(*this->sum_);
+
+  for (auto &s : sums_)
+  {
+    s.best = sum.best;
+    s.gen = sum.gen;
+    s.last_imp = sum.last_imp;
+    s.crossovers = s.mutations = 0;
+  }
+
+  // Random engines are thread local: the engine of the calling thread is
+  // restored at the end.
+  const auto caller(random::engine);
+
+  const auto task([&](std::size_t l, unsigned w)
+                  {
+                    random::engine = engines_[l];
+                    evolve(l, w ? *workers_[w - 1] : eva_);
+                    engines_[l] = random::engine;
+                  });
+
+  if (pool_)
+    pool_->run(islands, task);
+  else
+    for (unsigned l(0); l < islands; ++l)
+      task(l, 0);
+
+  random::engine = caller;
+
+  for (const auto &s : sums_)
+  {
+    sum.crossovers += s.crossovers;
+    sum.mutations += s.mutations;
+
+    if (s.best.score.fitness > sum.best.score.fitness)
+    {
+      sum.best = s.best;
+      sum.last_imp = sum.gen;
+    }
+  }
+}
+
 #endif  // include guard
@@ -33,6 +33,8 @@ class data_format : public std::runtime_error
 { using std::runtime_error::runtime_error; };
 class insufficient_data : public std::logic_error
 { using std::logic_error::logic_error; };
+class network : public std::runtime_error
+{ using std::runtime_error::runtime_error; };
 
 }  // namespace exception
 
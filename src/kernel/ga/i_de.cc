@@ -154,7 +154,7 @@ hash_t i_de::signature() const
 ///
 /// \return the signature of this individual
 ///
-/// The signature is obtained performing *MurmurHash3* on the individual.
+/// The signature is obtained applying `vita::hash` to the genome.
 ///
 hash_t i_de::hash() const
 {
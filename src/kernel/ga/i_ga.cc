@@ -167,7 +167,7 @@ hash_t i_ga::signature() const
 /// \return the hash value of the individual
 ///
 /// Converts this individual in a packed representation (raw sequence of bytes)
-/// and performs the *MurmurHash3* algorithm on it.
+/// and applies the `vita::hash` function to it.
 ///
 hash_t i_ga::hash() const
 {
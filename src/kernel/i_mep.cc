@@ -11,6 +11,7 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <functional>
 #include <map>
 
@@ -33,7 +34,8 @@ namespace vita
 ///
 i_mep::i_mep(const problem &p)
   : individual(), genome_(p.env.mep.code_length, p.sset.categories()),
-    best_{0, 0}, active_crossover_type_(random::sup(NUM_CROSSOVERS))
+    best_{0, 0}, active_crossover_type_(random::sup(NUM_CROSSOVERS)),
+    outputs_(), hashes_(genome_.rows(), genome_.cols()), stale_rows_(0)
 {
   Expects(size());
   Expects(p.env.mep.patch_length);
@@ -72,7 +74,8 @@ i_mep::i_mep(const std::vector<gene> &gv)
                                return g1.sym->category() < g2.sym->category();
                              })->sym->category() + 1),
     best_{0, 0},
-    active_crossover_type_(random::sup(NUM_CROSSOVERS))
+    active_crossover_type_(random::sup(NUM_CROSSOVERS)),
+    outputs_(), hashes_(genome_.rows(), genome_.cols()), stale_rows_(0)
 {
   index_t i(0);
 
@@ -156,12 +159,10 @@ unsigned i_mep::mutation(double pgm, const problem &prb)
       {
         ++n;
         *i = g;
+        touch(i.locus());
       }
     }
 
-  if (n)
-    signature_.clear();
-
   Ensures(debug());
   return n;
 }
@@ -201,7 +202,7 @@ i_mep i_mep::replace(const locus &l, const gene &g) const
   i_mep ret(*this);
 
   ret.genome_(l) = g;
-  ret.signature_.clear();
+  ret.touch(l);
 
   Ensures(ret.debug());
   return ret;
@@ -232,9 +233,10 @@ i_mep i_mep::destroy_block(index_t index, const symbol_set &sset) const
   i_mep ret(*this);
   const category_t c_sup(categories());
   for (category_t c(0); c < c_sup; ++c)
+  {
     ret.genome_(index, c) = gene(sset.roulette_terminal(c));
-
-  ret.signature_.clear();
+    ret.touch({index, c});
+  }
 
   Ensures(ret.debug());
   return ret;
@@ -281,8 +283,10 @@ std::pair<i_mep, std::vector<locus>> i_mep::generalize(
   // Step 3: randomly substitute `n` terminals with function arguments.
   i_mep ret(*this);
   for (auto j(decltype(n){0}); j < n; ++j)
+  {
     ret.genome_(terminals[j]).sym = &sset.arg(j);
-  ret.signature_.clear();
+    ret.touch(terminals[j]);
+  }
 
   Ensures(ret.debug());
 
@@ -353,56 +357,110 @@ unsigned distance(const i_mep &lhs, const i_mep &rhs)
   return d;
 }
 
+namespace
+{
 ///
-/// Maps syntactically distinct (but logically equivalent) individuals to the
-/// same byte stream.
+/// Performs the hash algorithm on a gene and on the signatures of its
+/// arguments.
 ///
-/// \param[in]  l locus in this individual
-/// \param[out] p byte stream compacted version of the gene sequence
-///               starting at locus `l`
+/// \param[in] g     a gene
+/// \param[in] child a function returning the signature of the `i`-th
+///                  argument of `g`
+/// \return          the signature of the subtree rooted at `g`
 ///
-/// Useful for individual comparison / information retrieval.
+/// Syntactically distinct (but logically equivalent) subtrees are mapped to
+/// the same value: the locus of the arguments doesn't matter, just their
+/// signature.
 ///
-void i_mep::pack(const locus &l, std::vector<std::byte> *p) const
+template<class F>
+hash_t hash_gene(const gene &g, F child)
 {
-  const gene &g(genome_(l));
-
-  // Although 16 bit are enough to contain opcodes and parameters, they are
-  // usually stored in unsigned variables (i.e. 32 or 64 bit) for performance
-  // reasons.
-  // Anyway before hashing opcodes/parameters we convert them to 16 bit types
-  // to avoid hashing more than necessary.
+  // Although 16 bit are enough to contain opcodes, they are usually stored in
+  // unsigned variables (i.e. 32 or 64 bit) for performance reasons.
+  // Anyway before hashing opcodes we convert them to 16 bit types to avoid
+  // hashing more than necessary.
   const auto opcode(static_cast<std::uint16_t>(g.sym->opcode()));
   assert(g.sym->opcode() <= std::numeric_limits<decltype(opcode)>::max());
 
-  auto s1 = reinterpret_cast<const std::byte *>(&opcode);
-  for (std::size_t i(0); i < sizeof(opcode); ++i)
-    p->push_back(s1[i]);
+  // The buffer is sized by the arity of the symbol (functions can have more
+  // than `gene::k_args` arguments): the usual case doesn't allocate.
+  const auto arity(g.sym->arity());
+  const bool parametric(!arity && terminal::cast(g.sym)->parametric());
+
+  small_vector<std::byte, sizeof(opcode) + gene::k_args * sizeof(hash_t::data)>
+    packed(sizeof(opcode) + arity * sizeof(hash_t::data)
+           + (parametric ? sizeof(g.par) : 0));
+
+  std::size_t len(sizeof(opcode));
+  std::memcpy(packed.data(), &opcode, sizeof(opcode));
 
-  auto arity(g.sym->arity());
-  if (arity)
+  for (std::size_t i(0); i < arity; ++i)
   {
-    decltype(arity) i(0);
-    do
-      pack(g.arg_locus(i), p);
-    while (++i < arity);
+    const hash_t h(child(i));
+    std::memcpy(packed.data() + len, h.data, sizeof(h.data));
+    len += sizeof(h.data);
   }
-  else
+
+  if (parametric)
   {
-    if (terminal::cast(g.sym)->parametric())
+    std::memcpy(packed.data() + len, &g.par, sizeof(g.par));
+    len += sizeof(g.par);
+  }
+
+  assert(len == packed.size());
+  return vita::hash::hash128(packed.data(), len);
+}
+}  // unnamed namespace
+
+///
+/// Marks the gene at locus `l` as changed.
+///
+/// \param[in] l locus of a changed gene
+///
+/// The signature of the subtree rooted at `l` is cleared. The signatures of
+/// the subtrees containing `l` are cleared lazily (see i_mep::refresh), so
+/// many changes are managed with a single pass.
+///
+void i_mep::touch(const locus &l)
+{
+  hashes_(l).clear();
+  stale_rows_ = std::max<index_t>(stale_rows_, l.index);
+
+  signature_.clear();
+}
+
+///
+/// Clears the signatures depending on the genes changed since the last call.
+///
+/// Arguments are always placed after the function using them, so a single
+/// backward pass on the rows before the last changed gene is enough. Only
+/// the subtrees containing a changed gene (i.e. the paths from the changed
+/// genes to the roots) will be rehashed.
+///
+void i_mep::refresh() const
+{
+  for (auto i(stale_rows_); i > 0; --i)
+    for (category_t c(0); c < categories(); ++c)
     {
-      const auto param(g.par);
+      const locus l{i - 1, c};
 
-      auto s2 = reinterpret_cast<const std::byte *>(&param);
-      for (std::size_t i(0); i < sizeof(param); ++i)
-        p->push_back(s2[i]);
+      if (!hashes_(l).empty())
+      {
+        const gene &g(genome_(l));
+        const auto arity(g.sym->arity());
+
+        for (std::size_t j(0); j < arity; ++j)
+          if (hashes_(g.arg_locus(j)).empty())
+          {
+            hashes_(l).clear();
+            break;
+          }
+      }
     }
-  }
+
+  stale_rows_ = 0;
 }
 
-///
-/// Converts this individual in a packed byte level representation and
-/// performs the hash algorithm on it.
 ///
 /// \return the signature of this individual
 ///
@@ -412,16 +470,52 @@ hash_t i_mep::hash() const
   // if (empty())
   //   return hash_t();
 
-  // From an individual to a packed byte stream...
-  thread_local std::vector<std::byte> packed;
+  return hash(best());
+}
 
-  packed.clear();
-  pack(best(), &packed);
+///
+/// Combines the signatures of the arguments of the gene at locus `l`
+/// (recursively computing the missing ones).
+///
+/// \param[in] l root of the subtree
+/// \return      the signature of the subtree rooted at `l`
+///
+hash_t i_mep::hash(const locus &l) const
+{
+  if (stale_rows_)
+    refresh();
 
-  /// ... and from a packed byte stream to a signature...
-  const auto len(packed.size() * sizeof(packed[0]));  // length in bytes
+  auto hash_([this](const locus &root, const auto &lambda) -> hash_t
+             {
+               hash_t &h(hashes_(root));
 
-  return vita::hash::hash128(packed.data(), len);
+               if (h.empty())
+               {
+                 const gene &g(genome_(root));
+                 h = hash_gene(g, [&](std::size_t i)
+                                  {
+                                    return lambda(g.arg_locus(i), lambda);
+                                  });
+               }
+
+               return h;
+             });
+
+  return hash_(l, hash_);
+}
+
+///
+/// \param[in] l root of the subtree
+/// \return      the signature of the subtree rooted at `l` computed from
+///              scratch (without using / updating the stored signatures)
+///
+/// \remark Used to check the consistency of the stored signatures.
+///
+hash_t i_mep::rehash(const locus &l) const
+{
+  const gene &g(genome_(l));
+
+  return hash_gene(g, [&](std::size_t i) { return rehash(g.arg_locus(i)); });
 }
 
 ///
@@ -446,6 +540,22 @@ hash_t i_mep::signature() const
   return signature_;
 }
 
+///
+/// \param[in] l locus of an active gene
+/// \return      the signature of the subtree rooted at `l`
+///
+/// Subtrees with the same signature compute the same function (even if they
+/// belong to different individuals or are placed at different loci).
+///
+/// \remark
+/// Signatures of the subtrees are stored: after a change of the genome only
+/// the subtrees containing the changed genes are rehashed.
+///
+hash_t i_mep::signature(const locus &l) const
+{
+  return hash(l);
+}
+
 ///
 /// \return `true` if the individual passes the internal consistency check
 ///
@@ -553,7 +663,21 @@ bool i_mep::debug() const
     return false;
   }
 
-  return signature_.empty() || signature_ == hash();
+  if (hashes_.rows() != genome_.rows() || hashes_.cols() != genome_.cols())
+  {
+    vitaERROR << "Wrong size of the signatures' table";
+    return false;
+  }
+
+  const auto h(rehash(best()));
+
+  if (!stale_rows_ && !hashes_(best()).empty() && hashes_(best()) != h)
+  {
+    vitaERROR << "Stale signature of the active code";
+    return false;
+  }
+
+  return signature_.empty() || signature_ == h;
 }
 
 ///
@@ -612,6 +736,8 @@ bool i_mep::load_impl(std::istream &in, const symbol_set &ss)
 
   best_ = best;
   genome_ = genome;
+  hashes_ = decltype(hashes_)(rows, cols);
+  stale_rows_ = 0;
 
   return true;
 }
@@ -804,6 +930,7 @@ i_mep crossover(const i_mep &lhs, const i_mep &rhs)
       {
         const locus l{i, c};
         to.genome_(l) = from[l];
+        to.touch(l);
       }
     }
     break;
@@ -821,6 +948,7 @@ i_mep crossover(const i_mep &lhs, const i_mep &rhs)
       {
         const locus l{i, c};
         to.genome_(l) = from[l];
+        to.touch(l);
       }
     }
     break;
@@ -836,6 +964,7 @@ i_mep crossover(const i_mep &lhs, const i_mep &rhs)
         {
           const locus l{i, c};
           to.genome_(l) = from[l];
+          to.touch(l);
         }
     }
     break;
@@ -845,6 +974,7 @@ i_mep crossover(const i_mep &lhs, const i_mep &rhs)
       auto crossover_ = [&](locus l, const auto &lambda) -> void
       {
         to.genome_(l) = from[l];
+        to.touch(l);
 
         if (!from[l].sym->terminal())
         {
@@ -862,7 +992,6 @@ i_mep crossover(const i_mep &lhs, const i_mep &rhs)
 
   to.active_crossover_type_ = from.active_crossover_type_;
   to.set_older_age(from.age());
-  to.signature_.clear();
 
   Ensures(to.debug());
   return to;
@@ -15,6 +15,7 @@
 
 #include <cmath>
 #include <iomanip>
+#include <memory>
 
 #include "kernel/function.h"
 #include "kernel/gene.h"
@@ -33,7 +34,8 @@ class i_mep : public individual<i_mep>
 {
 public:
   i_mep() : individual(), genome_(), best_(locus::npos()),
-            active_crossover_type_() {}
+            active_crossover_type_(), outputs_(), hashes_(), stale_rows_(0)
+  {}
 
   explicit i_mep(const problem &);
   explicit i_mep(const std::vector<gene> &);
@@ -60,6 +62,7 @@ public:
   bool operator==(const i_mep &) const;
 
   hash_t signature() const;
+  hash_t signature(const locus &) const;
 
   const gene &operator[](locus) const;
 
@@ -71,6 +74,10 @@ public:
   category_t category() const;
   locus best() const;
 
+  // ---- Incremental evaluation ----
+  std::shared_ptr<const gene_outputs> outputs() const;
+  void outputs(const std::shared_ptr<const gene_outputs> &) const;
+
   bool debug() const;
 
   // ---- Iterators ----
@@ -92,7 +99,10 @@ public:
 private:
   // ---- Private support methods ----
   hash_t hash() const;
-  void pack(const locus &, std::vector<std::byte> *) const;
+  hash_t hash(const locus &) const;
+  hash_t rehash(const locus &) const;
+  void refresh() const;
+  void touch(const locus &);
 
   // Serialization.
   bool load_impl(std::istream &, const symbol_set &);
@@ -111,6 +121,19 @@ private:
   // Crossover operator used to create this individual. Initially this is set
   // to a random type.
   crossover_t active_crossover_type_;
+
+  // Outputs of the active genes (see vita::column_store). Copies of an
+  // individual (e.g. offspring) inherit the reference, so the unchanged
+  // part of the genome needn't be re-evaluated.
+  mutable std::weak_ptr<const gene_outputs> outputs_;
+
+  // Signatures of the subtrees rooted at every locus, combined bottom-up
+  // (Merkle-style) and computed on demand. An empty hash is missing or stale.
+  mutable matrix<hash_t> hashes_;
+
+  // Rows `[0, stale_rows_[` may contain signatures depending on a changed
+  // gene (see i_mep::touch).
+  mutable index_t stale_rows_;
 };  // class i_mep
 
 unsigned distance(const i_mep &, const i_mep &);
@@ -123,6 +146,30 @@ inline locus i_mep::best() const
   return best_;
 }
 
+///
+/// \return the outputs of the active genes of `this` individual (or of the
+///         individual it's been copied from). `nullptr` if not available
+///
+/// \remark
+/// Outputs may refer to a different genome: the comparison of the genes at
+/// the same locus is up to the user.
+///
+inline std::shared_ptr<const gene_outputs> i_mep::outputs() const
+{
+  return outputs_.lock();
+}
+
+///
+/// \param[in] go outputs of the active genes of `this` individual
+///
+/// \remark
+/// Only a weak reference is kept: ownership is up to vita::column_store.
+///
+inline void i_mep::outputs(const std::shared_ptr<const gene_outputs> &go) const
+{
+  outputs_ = go;
+}
+
 ///
 /// \param[in] l locus of a `gene`
 /// \return      the `l`-th gene of `this` individual
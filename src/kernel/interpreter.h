@@ -13,6 +13,8 @@
 #if !defined(VITA_INTERPRETER_H)
 #define      VITA_INTERPRETER_H
 
+#include <memory>
+
 #include "kernel/core_interpreter.h"
 #include "kernel/function.h"
 #include "kernel/gene.h"
@@ -51,7 +53,23 @@ template<class T>
 class interpreter : public core_interpreter
 {
 public:
+  // Compiled form of the active code: a linear, topologically ordered
+  // sequence of instructions (arguments come before the functions using them
+  // and the last instruction is the starting gene). The output of the `i`-th
+  // instruction goes in the `i`-th register.
+  struct instr_
+  {
+    const symbol *sym;
+    terminal::param_t par;
+    locus loc;
+    small_vector<unsigned, gene::k_args> args;  // registers of arguments
+  };
+  using code_t = std::shared_ptr<const std::vector<instr_>>;
+
+  static code_t compile(const T &);
+
   explicit interpreter(const T *, interpreter * = nullptr);
+  interpreter(const T *, code_t, interpreter * = nullptr);
 
   terminal::param_t fetch_param();
   value_t fetch_arg(unsigned);
@@ -60,9 +78,15 @@ public:
 
   const T &program() const { return *prg_; }
 
+protected:
+  template<class F> void run_columns(std::size_t, F, std::vector<value_t> *);
+
+  // The compiled program (shared among the copies of the interpreter).
+  code_t code_;
+
 private:
   // *** Private support methods ***
-  value_t run_locus(const locus &);
+  template<class F> void exec(std::size_t, F);
   double penalty_locus(const locus &);
 
   // Nonvirtual interface.
@@ -73,8 +97,18 @@ private:
   // *** Private data members ***
   const T *prg_;
 
-  struct elem_ {bool valid; value_t value;};
-  mutable matrix<elem_> cache_;
+  // `regs_[r * width_ + row]` is the content of register `r` for the `row`-th
+  // example being evaluated.
+  std::vector<value_t> regs_;
+  std::size_t width_;
+
+  // Single example evaluation (see `run_nvi()`): `valid_[r]` is `true` if
+  // register `r` has been computed. Empty for the columnar evaluation.
+  std::vector<bool> valid_;
+
+  // Current instruction / example.
+  std::size_t pc_;
+  std::size_t row_;
 
   // Instruction pointer.
   locus ip_;
@@ -27,35 +27,183 @@
 ///
 template<class T>
 interpreter<T>::interpreter(const T *ind, interpreter *ctx)
-  : core_interpreter(), prg_(ind), cache_(ind->size(), ind->categories()),
-    ip_(ind->best_), context_(ctx)
+  : interpreter(ind, compile(*ind), ctx)
+{
+}
+
+///
+/// \param[in] ind  individual whose value we are interested in
+/// \param[in] code the compiled form of `ind` (see `compile()`)
+/// \param[in] ctx  context in which we calculate the output value (used for
+///                 the evaluation of ADF). It can be empty (`nullptr`)
+///
+/// Useful when the same program is evaluated by many interpreters (e.g. the
+/// code of an ADF): the program is compiled just once.
+///
+/// \warning
+/// The lifetime of `ind` and `ctx` must extend beyond that of the interpreter.
+///
+template<class T>
+interpreter<T>::interpreter(const T *ind, code_t code, interpreter *ctx)
+  : core_interpreter(), code_(std::move(code)), prg_(ind), regs_(),
+    width_(0), valid_(), pc_(0), row_(0), ip_(ind->best_), context_(ctx)
 {
   Expects(ind);
+  Expects(code_);
+  Ensures(code_->empty() || code_->back().loc == prg_->best_);
 }
 
 ///
-/// \param[in] ip locus of the genome we are starting evaluation from
-/// \return       the output value of `this` individual
+/// Translates the active code of a program in a linear sequence of
+/// instructions.
+///
+/// \param[in] prg a program
+/// \return        the compiled form of `prg`
+///
+/// The program is compiled just once and then reused for every example. This
+/// avoids, during the evaluation, the traversal of the genome via
+/// `i_mep::basic_iterator`.
 ///
 template<class T>
-value_t interpreter<T>::run_locus(const locus &ip)
+typename interpreter<T>::code_t interpreter<T>::compile(const T &prg)
 {
-  for (auto &e : cache_)
-    e.valid = false;
+  auto code(std::make_shared<std::vector<instr_>>());
 
-  ip_ = ip;
-  return (*prg_)[ip_].sym->eval(this);
+  if (prg.empty())
+    return code;
+
+  // Active loci are enumerated in ascending order. The arguments of a gene
+  // always have a greater index, so the reverse order is a valid execution
+  // order.
+  std::vector<locus> active;
+  for (auto i(prg.begin()); i != prg.end(); ++i)
+    active.push_back(i.locus());
+
+  matrix<unsigned> reg(prg.size(), prg.categories());
+
+  code->reserve(active.size());
+  for (auto l(active.rbegin()); l != active.rend(); ++l)
+  {
+    const gene &g(prg[*l]);
+
+    instr_ ins;
+    ins.sym = g.sym;
+    ins.par = g.par;
+    ins.loc = *l;
+    ins.args = decltype(ins.args)(g.sym->arity());
+    for (unsigned i(0); i < g.sym->arity(); ++i)
+    {
+      const locus al(g.arg_locus(i));
+      assert(al.index > l->index);
+
+      ins.args[i] = reg(al);
+    }
+
+    reg(*l) = static_cast<unsigned>(code->size());
+    code->push_back(ins);
+  }
+
+  Ensures(!code->empty());
+  Ensures(code->back().loc == prg.best_);
+  return code;
+}
+
+///
+/// Executes the compiled code for a group of examples.
+///
+/// \param[in] n      number of examples
+/// \param[in] select callable object positioning the interpreter on the
+///                   `i`-th example of the group (only derived classes know
+///                   where input data come from)
+///
+/// Instructions are executed in order and every instruction is executed for
+/// all the examples before moving to the next one.
+///
+/// \remark
+/// All the active genes are evaluated (i.e. lazy functions like `ifl` get both
+/// branches computed). Since we ASSUME REFERENTIAL TRANSPARENCY, the result
+/// doesn't change. The single example evaluation (see `run_nvi()`) is lazy.
+///
+/// \note
+/// Dispatching is via the virtual `symbol::eval` function: the set of symbols
+/// is open (user defined primitives are allowed) so a closed, switch-based
+/// interpreter isn't an option.
+///
+template<class T>
+template<class F>
+void interpreter<T>::exec(std::size_t n, F select)
+{
+  const auto &code(*code_);
+
+  width_ = n;
+  regs_.resize(code.size() * width_);
+  valid_.clear();
+
+  auto out(regs_.begin());
+  for (pc_ = 0; pc_ < code.size(); ++pc_)
+  {
+    ip_ = code[pc_].loc;
+    const symbol *sym(code[pc_].sym);
+
+    for (row_ = 0; row_ < n; ++row_)
+    {
+      select(row_);
+      *out++ = sym->eval(this);
+    }
+  }
+
+  pc_ = code.size() - 1;
+  ip_ = code.back().loc;
 }
 
 ///
-/// Calls `run_locus()` using the default starting locus.
+/// Evaluates the program for a single example.
 ///
 /// \return the output value of `this` individual
 ///
+/// Contrary to `exec()`, registers are computed on demand (see
+/// `fetch_arg()`): functions like `ifl` only evaluate the required branch.
+///
+template<class T>
+value_t interpreter<T>::run_nvi()
+{
+  const auto &code(*code_);
+
+  width_ = 1;
+  row_ = 0;
+  regs_.assign(code.size(), value_t());
+  valid_.assign(code.size(), false);
+
+  pc_ = code.size() - 1;
+  ip_ = code.back().loc;
+
+  regs_.back() = code.back().sym->eval(this);
+  valid_.back() = true;
+
+  return regs_.back();
+}
+
+///
+/// Columnar evaluation of the program for a block of examples.
+///
+/// \param[in]  n      number of examples in the block
+/// \param[in]  select callable object positioning the interpreter on the
+///                    `i`-th example of the block
+/// \param[out] out    output value of the program for every example of the
+///                    block
+///
+/// Every instruction is executed for the whole block, so the fixed costs of
+/// an instruction are paid once per block instead of once per example.
+///
 template<class T>
-inline value_t interpreter<T>::run_nvi()
+template<class F>
+void interpreter<T>::run_columns(std::size_t n, F select,
+                                 std::vector<value_t> *out)
 {
-  return run_locus(prg_->best_);
+  Expects(out);
+
+  exec(n, select);
+  out->assign(std::prev(regs_.end(), n), regs_.end());
 }
 
 ///
@@ -64,10 +212,10 @@ inline value_t interpreter<T>::run_nvi()
 template<class T>
 terminal::param_t interpreter<T>::fetch_param()
 {
-  const gene &g((*prg_)[ip_]);
+  const instr_ &ins((*code_)[pc_]);
 
-  assert(g.sym->terminal() && terminal::cast(g.sym)->parametric());
-  return g.par;
+  assert(ins.sym->terminal() && terminal::cast(ins.sym)->parametric());
+  return ins.par;
 }
 
 ///
@@ -76,8 +224,10 @@ terminal::param_t interpreter<T>::fetch_param()
 /// \param[in] i i-th argument of the current gene
 /// \return      the required value
 ///
-/// We use a cache to avoid recalculating the same value during the same
-/// interpreter execution.
+/// Arguments are computed before the function using them (see `compile()`)
+/// or, for the single example evaluation, the first time they're required.
+/// Every value is calculated only once during the same interpreter
+/// execution.
 /// This means that side effects are not evaluated to date: WE ASSUME
 /// REFERENTIAL TRANSPARENCY for all the expressions.
 ///
@@ -88,40 +238,28 @@ terminal::param_t interpreter<T>::fetch_param()
 template<class T>
 value_t interpreter<T>::fetch_arg(unsigned i)
 {
-  const gene &g((*prg_)[ip_]);
+  const auto &code(*code_);
 
-  assert(g.sym->arity());
-  assert(i < g.sym->arity());
+  assert(code[pc_].sym->arity());
+  assert(i < code[pc_].sym->arity());
 
-  const locus l(g.arg_locus(i));
+  const auto r(code[pc_].args[i]);
+  assert(r < pc_);
 
-  const auto get_val(
-    [&]()
-    {
-      const locus backup(ip_);
-      ip_ = l;
-      assert(ip_.index > backup.index);
-      const auto ret((*prg_)[ip_].sym->eval(this));
-      ip_ = backup;
-      return ret;
-    });
+  if (!valid_.empty() && !valid_[r])
+  {
+    const auto backup(pc_);
+    pc_ = r;
+    ip_ = code[r].loc;
 
-  auto &elem(cache_(l));
+    regs_[r] = code[r].sym->eval(this);
+    valid_[r] = true;
 
-  if (!elem.valid)
-  {
-    elem.value = get_val();
-    elem.valid = true;
-  }
-#if !defined(NDEBUG)
-  else // Cache not empty... checking if the cached value is right.
-  {
-    assert(get_val() == elem.value);
+    pc_ = backup;
+    ip_ = code[pc_].loc;
   }
-#endif
 
-  Ensures(elem.valid);
-  return elem.value;
+  return regs_[r * width_ + row_];
 }
 
 ///
@@ -192,6 +330,9 @@ bool interpreter<T>::debug_nvi() const
   if (!prg_->debug())
     return false;
 
+  if (!code_ || (!code_->empty() && code_->back().loc != prg_->best_))
+    return false;
+
   return ip_.index < prg_->size();
 }
 #endif  // include guard
@@ -135,6 +135,11 @@ public:
   basic_reg_lambda_f(std::istream &, const symbol_set &);
 
   value_t operator()(const dataframe::example &) const final;
+  template<class It> void operator()(It, It, std::vector<value_t> *) const;
+  bool operator()(const columnar_dataframe &, std::size_t, std::size_t,
+                  std::vector<value_t> *) const;
+  bool operator()(const std::vector<const D_DOUBLE *> &, std::size_t,
+                  std::vector<value_t> *) const;
 
   std::string name(const value_t &) const final;
 
@@ -154,6 +159,20 @@ private:
 
   value_t eval(const dataframe::example &, std::false_type) const;
   value_t eval(const dataframe::example &, std::true_type) const;
+  template<class It> void eval(It, It, std::vector<value_t> *,
+                               std::false_type) const;
+  template<class It> void eval(It, It, std::vector<value_t> *,
+                               std::true_type) const;
+  bool eval(const columnar_dataframe &, std::size_t, std::size_t,
+            std::vector<value_t> *, std::false_type) const;
+  bool eval(const columnar_dataframe &, std::size_t, std::size_t,
+            std::vector<value_t> *, std::true_type) const;
+  bool eval(const std::vector<const D_DOUBLE *> &, std::size_t,
+            std::vector<value_t> *, std::false_type) const;
+  bool eval(const std::vector<const D_DOUBLE *> &, std::size_t,
+            std::vector<value_t> *, std::true_type) const;
+  template<class F> void average(std::size_t, F,
+                                 std::vector<value_t> *) const;
 };
 
 // ***********************************************************************
@@ -226,6 +245,8 @@ class basic_dyn_slot_lambda_f : public basic_class_lambda_f<N>
 {
 public:
   basic_dyn_slot_lambda_f(const T &, dataframe &, unsigned);
+  basic_dyn_slot_lambda_f(const T &, dataframe &, unsigned,
+                          const std::vector<value_t> &);
   basic_dyn_slot_lambda_f(std::istream &, const symbol_set &);
 
   classification_result tag(const dataframe::example &) const final;
@@ -240,8 +261,9 @@ public:
 
 private:
   // *** Private support methods ***
-  void fill_matrix(dataframe &, unsigned);
+  void fill_matrix(dataframe &, unsigned, const std::vector<value_t> &);
   std::size_t slot(const dataframe::example &) const;
+  std::size_t slot(const value_t &) const;
 
   std::string serialize_id() const final { return SERIALIZE_ID; }
 
@@ -278,6 +300,8 @@ class basic_gaussian_lambda_f : public basic_class_lambda_f<N>
 {
 public:
   basic_gaussian_lambda_f(const T &, dataframe &);
+  basic_gaussian_lambda_f(const T &, dataframe &,
+                          const std::vector<value_t> &);
   basic_gaussian_lambda_f(std::istream &, const symbol_set &);
 
   classification_result tag(const dataframe::example &) const final;
@@ -290,7 +314,7 @@ public:
 
 private:
   // *** Private support methods ***
-  void fill_vector(dataframe &);
+  void fill_vector(dataframe &, const std::vector<value_t> &);
   bool load_(std::istream &, const symbol_set &, std::true_type);
   bool load_(std::istream &, const symbol_set &, std::false_type);
 
@@ -107,6 +107,196 @@ value_t basic_reg_lambda_f<T, S>::eval(const dataframe::example &e,
   return {};
 }
 
+///
+/// Batch version of the function call operator.
+///
+/// \param[in]  first beginning of a range of examples
+/// \param[in]  last  end of the range
+/// \param[out] out   `(*out)[i]` is the output value associated with the
+///                   `i`-th example of the range
+///
+/// Much faster than calling the single-example version in a loop (see
+/// `src_interpreter::run` for details).
+///
+template<class T, bool S>
+template<class It>
+void basic_reg_lambda_f<T, S>::operator()(It first, It last,
+                                          std::vector<value_t> *out) const
+{
+  Expects(out);
+  eval(first, last, out, is_team<T>());
+}
+
+template<class T, bool S>
+template<class It>
+void basic_reg_lambda_f<T, S>::eval(It first, It last,
+                                    std::vector<value_t> *out,
+                                    std::false_type) const
+{
+  this->run(first, last, out);
+}
+
+template<class T, bool S>
+template<class It>
+void basic_reg_lambda_f<T, S>::eval(It first, It last,
+                                    std::vector<value_t> *out,
+                                    std::true_type) const
+{
+  average(static_cast<std::size_t>(std::distance(first, last)),
+          [&](const auto &core, std::vector<value_t> *res)
+          {
+            core.run(first, last, res);
+          },
+          out);
+}
+
+///
+/// Batch version of the function call operator working on the columns of a
+/// columnar dataframe.
+///
+/// \param[in]  d     a columnar dataframe
+/// \param[in]  first index of the first row of the range
+/// \param[in]  last  index one past the last row of the range
+/// \param[out] out   `(*out)[i]` is the output value associated with the
+///                   `first + i`-th row
+/// \return           `true` if the `double`-only fast path is available
+///                   (otherwise nothing is done)
+///
+/// The caller should fall back to the row-oriented version when the fast
+/// path isn't available: converting the rows would waste the advantage of
+/// the columnar layout.
+///
+/// \see src_interpreter::real_valued
+///
+template<class T, bool S>
+bool basic_reg_lambda_f<T, S>::operator()(const columnar_dataframe &d,
+                                          std::size_t first, std::size_t last,
+                                          std::vector<value_t> *out) const
+{
+  Expects(out);
+  return eval(d, first, last, out, is_team<T>());
+}
+
+template<class T, bool S>
+bool basic_reg_lambda_f<T, S>::eval(const columnar_dataframe &d,
+                                    std::size_t first, std::size_t last,
+                                    std::vector<value_t> *out,
+                                    std::false_type) const
+{
+  if (!this->real_valued())
+    return false;
+
+  this->run(d, first, last, out);
+  return true;
+}
+
+template<class T, bool S>
+bool basic_reg_lambda_f<T, S>::eval(const columnar_dataframe &d,
+                                    std::size_t first, std::size_t last,
+                                    std::vector<value_t> *out,
+                                    std::true_type) const
+{
+  if (!std::all_of(this->team_.begin(), this->team_.end(),
+                   [](const auto &core) { return core.real_valued(); }))
+    return false;
+
+  average(last - first,
+          [&](const auto &core, std::vector<value_t> *res)
+          {
+            core.run(d, first, last, res);
+          },
+          out);
+  return true;
+}
+
+///
+/// Batch version of the function call operator working on columns of
+/// `D_DOUBLE`s.
+///
+/// \param[in]  vars `vars[v]` is the column (`n` elements, `NaN` for the
+///                  empty value) of the `v`-th variable
+/// \param[in]  n    number of examples
+/// \param[out] out  `(*out)[i]` is the output value associated with the
+///                  `i`-th example
+/// \return          `true` if the `double`-only fast path is available
+///                  (otherwise `out` is unspecified)
+///
+/// The columns are used in place (e.g. the memory-mapped columns of a
+/// vita::binary_data_file).
+///
+template<class T, bool S>
+bool basic_reg_lambda_f<T, S>::operator()(
+  const std::vector<const D_DOUBLE *> &vars, std::size_t n,
+  std::vector<value_t> *out) const
+{
+  Expects(out);
+  return eval(vars, n, out, is_team<T>());
+}
+
+template<class T, bool S>
+bool basic_reg_lambda_f<T, S>::eval(const std::vector<const D_DOUBLE *> &vars,
+                                    std::size_t n, std::vector<value_t> *out,
+                                    std::false_type) const
+{
+  return this->run(vars, n, out);
+}
+
+template<class T, bool S>
+bool basic_reg_lambda_f<T, S>::eval(const std::vector<const D_DOUBLE *> &vars,
+                                    std::size_t n, std::vector<value_t> *out,
+                                    std::true_type) const
+{
+  if (!std::all_of(this->team_.begin(), this->team_.end(),
+                   [](const auto &core) { return core.real_valued(); }))
+    return false;
+
+  bool ok(true);
+  average(n,
+          [&](const auto &core, std::vector<value_t> *res)
+          {
+            if (!ok || !core.run(vars, n, res))
+            {
+              ok = false;
+              res->assign(n, value_t());
+            }
+          },
+          out);
+  return ok;
+}
+
+///
+/// Combines the outputs of the members of a team.
+///
+/// \param[in]  n   number of examples
+/// \param[in]  run callable object calculating the outputs of a member of
+///                 the team (`run(core, &res)`)
+/// \param[out] out `(*out)[i]` is the average of the outputs of the members
+///                 for the `i`-th example
+///
+template<class T, bool S>
+template<class F>
+void basic_reg_lambda_f<T, S>::average(std::size_t n, F run,
+                                       std::vector<value_t> *out) const
+{
+  std::vector<D_DOUBLE> avg(n, 0.0), count(n, 0.0);
+
+  // Calculate the running average (row by row, as the single-example
+  // version).
+  std::vector<value_t> res;
+  for (const auto &core : this->team_)
+  {
+    run(core, &res);
+
+    for (std::size_t i(0); i < n; ++i)
+      if (has_value(res[i]))
+        avg[i] += (lexical_cast<D_DOUBLE>(res[i]) - avg[i]) / ++count[i];
+  }
+
+  out->resize(n);
+  for (std::size_t i(0); i < n; ++i)
+    (*out)[i] = count[i] > 0.0 ? value_t(avg[i]) : value_t();
+}
+
 ///
 /// \return a *failed* status
 ///
@@ -225,7 +415,39 @@ basic_dyn_slot_lambda_f<T, S, N>::basic_dyn_slot_lambda_f(const T &ind,
   Expects(d.classes() > 1);
   Expects(x_slot);
 
-  fill_matrix(d, x_slot);
+  std::vector<value_t> outs;
+  for (const auto &example : d)
+    outs.push_back(lambda_(example));
+
+  fill_matrix(d, x_slot, outs);
+
+  Ensures(debug());
+}
+
+///
+/// \param[in] ind    individual "to be transformed" into a lambda function
+/// \param[in] d      the training set
+/// \param[in] x_slot number of slots for each class of the training set
+/// \param[in] outs   `outs[i]` is the output of `ind` for the `i`-th example
+///                   of `d`
+///
+/// Useful when the outputs of `ind` have already been calculated (e.g. in
+/// parallel by the evaluator).
+///
+template<class T, bool S, bool N>
+basic_dyn_slot_lambda_f<T, S, N>::basic_dyn_slot_lambda_f(
+  const T &ind, dataframe &d, unsigned x_slot,
+  const std::vector<value_t> &outs)
+  : basic_class_lambda_f<N>(d), lambda_(ind),
+    slot_matrix_(d.classes() * x_slot, d.classes()),
+    slot_class_(d.classes() * x_slot), dataset_size_(0)
+{
+  Expects(ind.debug());
+  Expects(d.debug());
+  Expects(d.classes() > 1);
+  Expects(x_slot);
+
+  fill_matrix(d, x_slot, outs);
 
   Ensures(debug());
 }
@@ -275,14 +497,18 @@ basic_dyn_slot_lambda_f<T, S, N>::basic_dyn_slot_lambda_f(std::istream &in,
 ///
 /// \param[in] d      the training set
 /// \param[in] x_slot number of slots for each class of the training set
+/// \param[in] outs   `outs[i]` is the output of the program for the `i`-th
+///                   example of `d`
 ///
 template<class T, bool S, bool N>
-void basic_dyn_slot_lambda_f<T, S, N>::fill_matrix(dataframe &d,
-                                                   unsigned x_slot)
+void basic_dyn_slot_lambda_f<T, S, N>::fill_matrix(
+  dataframe &d, unsigned x_slot, const std::vector<value_t> &outs)
 {
   Expects(d.debug());
   Expects(d.classes() > 1);
   Expects(x_slot);
+  Expects(outs.size() == static_cast<std::size_t>(std::distance(d.begin(),
+                                                                d.end())));
 
   const auto n_slots(d.classes() * x_slot);
   assert(n_slots == slot_matrix_.rows());
@@ -294,11 +520,12 @@ void basic_dyn_slot_lambda_f<T, S, N>::fill_matrix(dataframe &d,
   // In the first step this method evaluates the program to obtain an output
   // value for each training example. Based on the program output a
   // bi-dimensional matrix is built (slot_matrix_(slot, class)).
+  auto out(outs.begin());
   for (const auto &example : d)
   {
     ++dataset_size_;
 
-    ++slot_matrix_(slot(example), label(example));
+    ++slot_matrix_(slot(*out++), label(example));
   }
 
   const auto unknown(d.classes());
@@ -344,8 +571,16 @@ template<class T, bool S, bool N>
 std::size_t basic_dyn_slot_lambda_f<T,S,N>::slot(
   const dataframe::example &e) const
 {
-  const auto res(lambda_(e));
+  return slot(lambda_(e));
+}
 
+///
+/// \param[in] res output of the program for some input data
+/// \return        the slot `res` falls into
+///
+template<class T, bool S, bool N>
+std::size_t basic_dyn_slot_lambda_f<T,S,N>::slot(const value_t &res) const
+{
   const auto ns(slot_matrix_.rows());
   const auto last_slot(ns - 1);
   if (!has_value(res))
@@ -453,7 +688,34 @@ basic_gaussian_lambda_f<T, S, N>::basic_gaussian_lambda_f(const T &ind,
   Expects(d.debug());
   Expects(d.classes() > 1);
 
-  fill_vector(d);
+  std::vector<value_t> outs;
+  for (const auto &example : d)
+    outs.push_back(lambda_(example));
+
+  fill_vector(d, outs);
+
+  Ensures(debug());
+}
+
+///
+/// \param[in] ind  individual "to be transformed" into a lambda function
+/// \param[in] d    the training set
+/// \param[in] outs `outs[i]` is the output of `ind` for the `i`-th example of
+///                 `d`
+///
+/// Useful when the outputs of `ind` have already been calculated (e.g. in
+/// parallel by the evaluator).
+///
+template<class T, bool S, bool N>
+basic_gaussian_lambda_f<T, S, N>::basic_gaussian_lambda_f(
+  const T &ind, dataframe &d, const std::vector<value_t> &outs)
+  : basic_class_lambda_f<N>(d), lambda_(ind), gauss_dist_(d.classes())
+{
+  Expects(ind.debug());
+  Expects(d.debug());
+  Expects(d.classes() > 1);
+
+  fill_vector(d, outs);
 
   Ensures(debug());
 }
@@ -497,12 +759,17 @@ basic_gaussian_lambda_f<T, S, N>::basic_gaussian_lambda_f(std::istream &in,
 ///
 /// Sets up the data structures needed by the gaussian algorithm.
 ///
-/// \param[in] d the training set
+/// \param[in] d    the training set
+/// \param[in] outs `outs[i]` is the output of the program for the `i`-th
+///                 example of `d`
 ///
 template<class T, bool S, bool N>
-void basic_gaussian_lambda_f<T, S, N>::fill_vector(dataframe &d)
+void basic_gaussian_lambda_f<T, S, N>::fill_vector(
+  dataframe &d, const std::vector<value_t> &outs)
 {
   Expects(d.classes() > 1);
+  Expects(outs.size() == static_cast<std::size_t>(std::distance(d.begin(),
+                                                                d.end())));
 
   // For a set of training data, we assume that the behaviour of a program
   // classifier is modelled using multiple Gaussian distributions, each of
@@ -510,11 +777,12 @@ void basic_gaussian_lambda_f<T, S, N>::fill_vector(dataframe &d)
   // determined by evaluating the program on the examples of the class in
   // the training set. This is done by taking the mean and standard deviation
   // of the program outputs for those training examples for that class.
+  auto res(outs.begin());
   for (const auto &example : d)
   {
-    const auto res(lambda_(example));
+    number val(has_value(*res) ? lexical_cast<D_DOUBLE>(*res) : 0.0);
+    ++res;
 
-    number val(has_value(res) ? lexical_cast<D_DOUBLE>(res) : 0.0);
     const number cut(10000000.0);
     if (val > cut)
       val = cut;
@@ -13,6 +13,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 
 #include "kernel/log.h"
 
@@ -58,6 +59,10 @@ log::~log()
     "ALL", "DEBUG", "INFO", "", "WARNING", "ERROR", "FATAL", ""
   };
 
+  // Messages can come from many threads.
+  static std::mutex mutex;
+  const std::lock_guard<std::mutex> lock(mutex);
+
   if (stream)  // `stream`, if available, gets all the messages
   {
     const auto tp(std::chrono::system_clock::now());
@@ -0,0 +1,491 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#if !defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)
+#  include <fcntl.h>
+#  include <sys/file.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#include "kernel/persistent_cache.h"
+
+namespace vita
+{
+
+struct persistent_cache::header
+{
+  char          magic[8];
+  std::uint32_t version;
+  std::uint32_t bits;
+  std::uint64_t fingerprint[2];
+  /// The hash function used for signatures (see `hash::id`).
+  std::uint32_t hash_id;
+  std::uint32_t reserved[5];
+  /// Checksum of the previous fields.
+  std::uint64_t check;
+};
+
+struct persistent_cache::slot
+{
+  std::uint64_t hash[2];
+  double        fitness[k_components];
+  /// Number of components of `fitness`.
+  std::uint32_t size;
+  /// `1` for an upper bound of the fitness (see evaluator::race).
+  std::uint32_t partial;
+  /// Checksum of the previous fields.
+  std::uint64_t check;
+};
+
+namespace
+{
+
+constexpr char k_magic[8] = "VITAPFC";
+constexpr std::uint32_t k_version = 2;
+
+// Checksum of the first `offsetof(S, check)` bytes of `s`.
+template<class S>
+std::uint64_t checksum(const S &s)
+{
+  return hash::hash128(&s, offsetof(S, check), 2020).data[0];
+}
+
+}  // unnamed namespace
+
+///
+/// Creates a new (in memory) hash table.
+///
+/// \param[in] bits `2^bits` is the number of elements of the table
+///
+persistent_cache::persistent_cache(std::uint8_t bits)
+  : k_bits(bits), k_mask((1ull << bits) - 1), base_(nullptr), fd_(-1),
+    path_(), fingerprint_(), probes_(0), hits_(0)
+{
+  static_assert(sizeof(header) == 64);
+  static_assert(sizeof(slot) == 64);
+
+  Expects(bits);
+
+  close();
+
+  Ensures(debug());
+}
+
+persistent_cache::~persistent_cache()
+{
+  unmap();
+}
+
+///
+/// \return size, in bytes, of the mapping (header and table)
+///
+std::size_t persistent_cache::length() const
+{
+  return sizeof(header) + sizeof(slot) * (k_mask + 1);
+}
+
+///
+/// \return a pointer to the first slot of the table
+///
+persistent_cache::slot *persistent_cache::table() const
+{
+  return reinterpret_cast<slot *>(static_cast<char *>(base_)
+                                  + sizeof(header));
+}
+
+///
+/// \param[in] h the signature of an individual
+/// \return      an index in the hash table
+///
+inline std::size_t persistent_cache::index(const hash_t &h) const
+{
+  return h.data[0] & k_mask;
+}
+
+///
+/// Releases the current mapping (and the associated file, if any).
+///
+void persistent_cache::unmap()
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
+  std::free(base_);
+  base_ = nullptr;
+#else
+  if (base_)
+  {
+    if (fd_ >= 0)
+      ::msync(base_, length(), MS_SYNC);
+
+    ::munmap(base_, length());
+    base_ = nullptr;
+  }
+
+  if (fd_ >= 0)
+  {
+    ::close(fd_);  // also releases the lock
+    fd_ = -1;
+  }
+#endif
+
+  path_.clear();
+  fingerprint_.clear();
+}
+
+///
+/// Links the table to a file.
+///
+/// \param[in] f  path of the file (created if missing)
+/// \param[in] fp fingerprint of the data the cached fitnesses refer to
+/// \return       `true` if the file is correctly mapped
+///
+/// The content of the file is kept only if it refers to the same fingerprint
+/// and table size; otherwise it's reinitialized. The current content of the
+/// table is always discarded (unless `f` and `fp` are the ones already in
+/// use).
+///
+/// \note
+/// * If the operation isn't successful the current object isn't changed.
+/// * Memory-mapped files are only supported on POSIX systems: elsewhere the
+///   operation always fails (and the table stays in memory).
+///
+/// \warning Not thread safe: no other member function may run concurrently.
+///
+bool persistent_cache::open(const std::filesystem::path &f, const hash_t &fp)
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
+  (void)f;
+  (void)fp;
+  return false;
+#else
+  if (fd_ >= 0 && f == path_ && fp == fingerprint_)
+    return true;
+
+  const int fd(::open(f.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644));
+  if (fd < 0)
+    return false;
+
+  const auto fail([fd] { ::close(fd); return false; });
+
+  // Another process is using the file.
+  if (::flock(fd, LOCK_EX | LOCK_NB))
+    return fail();
+
+  struct stat st;
+  if (::fstat(fd, &st))
+    return fail();
+
+  const bool same_size(static_cast<std::size_t>(st.st_size) == length());
+  if (!same_size && (::ftruncate(fd, 0) || ::ftruncate(fd, length())))
+    return fail();
+
+  void *const base(::mmap(nullptr, length(), PROT_READ | PROT_WRITE,
+                          MAP_SHARED, fd, 0));
+  if (base == MAP_FAILED)
+    return fail();
+
+  auto *h(static_cast<header *>(base));
+  const bool valid(same_size
+                   && !std::memcmp(h->magic, k_magic, sizeof(k_magic))
+                   && h->version == k_version && h->bits == k_bits
+                   && h->hash_id == hash::id
+                   && h->fingerprint[0] == fp.data[0]
+                   && h->fingerprint[1] == fp.data[1]
+                   && h->check == checksum(*h));
+
+  if (!valid)
+  {
+    // The table is cleared (and flushed) before writing the header: an
+    // interrupted initialization leaves an invalid header.
+    std::memset(base, 0, length());
+    ::msync(base, length(), MS_SYNC);
+
+    std::memcpy(h->magic, k_magic, sizeof(k_magic));
+    h->version = k_version;
+    h->bits = k_bits;
+    h->hash_id = hash::id;
+    h->fingerprint[0] = fp.data[0];
+    h->fingerprint[1] = fp.data[1];
+    h->check = checksum(*h);
+    ::msync(base, sizeof(header), MS_SYNC);
+  }
+
+  unmap();
+
+  base_ = base;
+  fd_ = fd;
+  path_ = f;
+  fingerprint_ = fp;
+
+  return true;
+#endif
+}
+
+///
+/// Flushes and releases the file: the table goes back in memory (empty).
+///
+/// \warning Not thread safe: no other member function may run concurrently.
+///
+void persistent_cache::close()
+{
+  unmap();
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
+  base_ = std::calloc(length(), 1);
+#else
+  if (void *const base = ::mmap(nullptr, length(), PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      base != MAP_FAILED)
+    base_ = base;
+#endif
+
+  if (!base_)
+    throw std::bad_alloc();
+}
+
+///
+/// \return `true` if the table is backed by a file
+///
+bool persistent_cache::is_open() const
+{
+  return fd_ >= 0;
+}
+
+///
+/// \return number of searches in the hash table
+///
+/// \note Every call to the find method increment the counter.
+///
+std::uintmax_t persistent_cache::probes() const
+{
+  return probes_;
+}
+
+///
+/// \return number of successful searches in the hash table
+///
+std::uintmax_t persistent_cache::hits() const
+{
+  return hits_;
+}
+
+///
+/// Clears the content and the statistical informations of the table.
+///
+/// \note Allocated size isn't changed.
+///
+void persistent_cache::clear()
+{
+  probes_ = hits_ = 0;
+
+  for (std::size_t s(0); s < k_shards; ++s)
+  {
+    std::lock_guard lock(shards_[s]);
+
+    for (auto i(s); i <= k_mask; i += k_shards)
+      table()[i].check = 0;
+  }
+}
+
+///
+/// Clears the cached information for a specific individual.
+///
+/// \param[in] h individual's signature whose informations we have to clear
+///
+void persistent_cache::clear(const hash_t &h)
+{
+  const auto i(index(h));
+
+  std::lock_guard lock(shards_[i % k_shards]);
+
+  slot &s(table()[i]);
+  if (s.hash[0] == h.data[0] && s.hash[1] == h.data[1])
+    s.check = 0;
+}
+
+///
+/// Looks for the fitness of an individual in the transposition table.
+///
+/// \param[in]  h       individual's signature to look for
+/// \param[out] partial if not `nullptr`, partial results are also considered
+///                     and `*partial` is set accordingly
+/// \return             the fitness of the individual. If the individuals
+///                     isn't present returns an empty fitness
+///
+/// \see cache::find
+///
+fitness_t persistent_cache::find(const hash_t &h, bool *partial) const
+{
+  ++probes_;
+
+  const auto i(index(h));
+
+  slot s;
+  {
+    std::lock_guard lock(shards_[i % k_shards]);
+    s = table()[i];
+  }
+
+  if (s.check != checksum(s) || s.hash[0] != h.data[0]
+      || s.hash[1] != h.data[1] || !s.size || s.size > k_components
+      || (s.partial && !partial))
+    return {};
+
+  ++hits_;
+
+  if (partial)
+    *partial = s.partial;
+
+  fitness_t ret(with_size{s.size});
+  for (std::size_t j(0); j < s.size; ++j)
+    ret[j] = s.fitness[j];
+  return ret;
+}
+
+///
+/// Stores fitness information in the transposition table.
+///
+/// \param[in] h       a (possibly) new individual's signature to be stored in
+///                    the table
+/// \param[in] fitness the fitness of the individual
+/// \param[in] partial `true` if `fitness` is just an upper bound of the real
+///                    fitness (see evaluator::race)
+///
+/// \remark Fitnesses with more than `k_components` components are ignored.
+///
+void persistent_cache::insert(const hash_t &h, const fitness_t &fitness,
+                              bool partial)
+{
+  if (!fitness.size() || fitness.size() > k_components)
+    return;
+
+  slot s{};
+  s.hash[0] = h.data[0];
+  s.hash[1] = h.data[1];
+  for (std::size_t j(0); j < fitness.size(); ++j)
+    s.fitness[j] = fitness[j];
+  s.size = static_cast<std::uint32_t>(fitness.size());
+  s.partial = partial;
+  s.check = checksum(s);
+
+  const auto i(index(h));
+
+  std::lock_guard lock(shards_[i % k_shards]);
+  table()[i] = s;
+}
+
+///
+/// \param[in] in input stream
+/// \return       `true` if the object is correctly loaded
+///
+/// The format is the same used by the `cache` class.
+///
+/// \note
+/// If the load operation isn't successful the current object isn't changed.
+///
+bool persistent_cache::load(std::istream &in)
+{
+  unsigned t_seal;
+  if (!(in >> t_seal))
+    return false;
+
+  std::uintmax_t t_probes;
+  if (!(in >> t_probes))
+    return false;
+
+  std::uintmax_t t_hits;
+  if (!(in >> t_hits))
+    return false;
+
+  std::size_t n;
+  if (!(in >> n))
+    return false;
+
+  std::vector<std::pair<hash_t, fitness_t>> t_table;
+  for (decltype(n) i(0); i < n; ++i)
+  {
+    hash_t h;
+    if (!h.load(in))
+      return false;
+
+    fitness_t f;
+    if (!f.load(in))
+      return false;
+
+    t_table.emplace_back(h, f);
+  }
+
+  for (const auto &[h, f] : t_table)
+    insert(h, f);
+
+  probes_ = t_probes;
+  hits_ = t_hits;
+
+  return true;
+}
+
+///
+/// \param[out] out output stream
+/// \return         `true` if the object was saved correctly
+///
+/// The format is the same used by the `cache` class.
+///
+bool persistent_cache::save(std::ostream &out) const
+{
+  out << 1 << ' ' << probes() << ' ' << hits() << '\n';
+
+  const auto valid([](const slot &s)
+                   {
+                     return s.check == checksum(s) && s.size && !s.partial
+                            && s.size <= k_components;
+                   });
+
+  // Partial results aren't saved.
+  std::size_t num(0);
+  for (std::size_t i(0); i <= k_mask; ++i)
+    if (valid(table()[i]))
+      ++num;
+  out << num << '\n';
+
+  for (std::size_t i(0); i <= k_mask; ++i)
+    if (const slot &s(table()[i]); valid(s))
+    {
+      hash_t(s.hash[0], s.hash[1]).save(out);
+
+      fitness_t f(with_size{s.size});
+      for (std::size_t j(0); j < s.size; ++j)
+        f[j] = s.fitness[j];
+      f.save(out);
+    }
+
+  return out.good();
+}
+
+///
+/// \return `true` if the object passes the internal consistency check
+///
+bool persistent_cache::debug() const
+{
+  if (!base_)
+    return false;
+
+  // Hits are read first: probes may increase in the meantime.
+  const auto h(hits());
+  return probes() >= h;
+}
+
+}  // namespace vita
@@ -0,0 +1,115 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_PERSISTENT_CACHE_H)
+#define      VITA_PERSISTENT_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+
+#include "kernel/cache_hash.h"
+#include "kernel/environment.h"
+
+namespace vita
+{
+///
+/// A fitness cache stored in a memory-mapped file, so that it survives
+/// across runs and processes.
+///
+/// The file is keyed by a fingerprint (usually of the training data and of
+/// the evaluator, see search::fingerprint): when the fingerprint doesn't match
+/// the one stored in the file, the content of the file is discarded.
+///
+/// Until `open` is called (or after `close`) the table lives in memory and
+/// the class works like an ordinary cache.
+///
+/// The table is direct-mapped. Every slot fits a cache line and ends with a
+/// checksum of its content: a slot partially written (e.g. the process was
+/// killed during an `insert`) doesn't match its checksum and is ignored. The
+/// header of the file is written after the table has been initialized, so
+/// an interrupted initialization is detected at the next `open`.
+///
+/// Member functions can be called concurrently except `open`, `close`,
+/// `load` and `save`. A file is used by a single process at a time (it's
+/// locked by `open`).
+///
+/// \remark
+/// Fitnesses with more than `k_components` components aren't cached.
+///
+/// \note
+/// Files are only supported on POSIX systems: elsewhere `open` always fails
+/// and the table lives in memory.
+///
+class persistent_cache
+{
+public:
+  DISALLOW_COPY_AND_ASSIGN(persistent_cache);
+
+  /// Maximum number of components of a cacheable fitness.
+  static constexpr std::size_t k_components = 4;
+
+  explicit persistent_cache(std::uint8_t);
+  ~persistent_cache();
+
+  bool open(const std::filesystem::path &, const hash_t &);
+  void close();
+  bool is_open() const;
+
+  void clear();
+  void clear(const hash_t &);
+
+  void insert(const hash_t &, const fitness_t &, bool = false);
+
+  fitness_t find(const hash_t &, bool * = nullptr) const;
+
+  std::uintmax_t probes() const;
+  std::uintmax_t hits() const;
+
+  bool debug() const;
+
+  // Serialization.
+  bool load(std::istream &);
+  bool save(std::ostream &) const;
+
+private:
+  struct header;
+  struct slot;
+
+  // Private support methods.
+  std::size_t index(const hash_t &) const;
+  std::size_t length() const;
+  slot *table() const;
+  void unmap();
+
+  // Private data members.
+  static constexpr std::size_t k_shards = 64;
+
+  const std::uint8_t  k_bits;
+  const std::uint64_t k_mask;
+
+  void *base_;  // header followed by the table (`nullptr` if unmapped)
+  int     fd_;  // `-1` for an anonymous (in memory) mapping
+
+  std::filesystem::path path_;
+  hash_t         fingerprint_;
+
+  mutable std::array<std::mutex, k_shards> shards_;
+
+  mutable std::atomic<std::uintmax_t> probes_;
+  mutable std::atomic<std::uintmax_t>   hits_;
+};
+
+}  // namespace vita
+
+#endif  // include guard
@@ -0,0 +1,106 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_REMOTE_ISLANDS_H)
+#define      VITA_REMOTE_ISLANDS_H
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include "kernel/evaluator.h"
+#include "kernel/evolution_summary.h"
+#include "kernel/i_mep.h"
+#include "kernel/population.h"
+#include "kernel/team.h"
+#include "kernel/wire.h"
+#include "utility/net.h"
+
+namespace vita
+{
+
+///
+/// Connects the population of this process to the populations evolving in
+/// other processes (possibly on other hosts).
+///
+/// \tparam T type of individual
+///
+/// Every process of the group (the *archipelago*) runs its own, normal,
+/// evolution and is an island. Every `env.island.interval` generations:
+/// - the migrants received from the other processes replace the worst
+///   individuals of the last layer of the population (if better);
+/// - the best `env.island.migrants` individuals of the population are sent
+///   to the neighbouring processes (see `env.island.topology`).
+///
+/// Migrants travel over TCP (use `localhost` for processes on the same
+/// machine) in the compact binary format described in vita::wire. They're
+/// received by a background thread: evolution never waits for the other
+/// processes and lost messages (e.g. a process not yet started) are simply
+/// skipped. Migrants whose genome doesn't fit the problem (or fails the
+/// internal consistency check) are discarded.
+///
+/// By default only local connections are accepted: processes on other hosts
+/// require the address of the interface to listen on. A typical use is:
+///
+///     remote_islands<i_mep> link(prob, my_port, my_address);
+///     link.join({{"host1", 4000}, {"host2", 4000}, {"host3", 4000}}, me);
+///
+///     src_search<i_mep, std_es> s(prob);
+///     s.migration(&link).run();
+///
+template<class T>
+class remote_islands
+{
+public:
+  DISALLOW_COPY_AND_ASSIGN(remote_islands);
+
+  explicit remote_islands(const problem &, std::uint16_t = 0,
+                          const std::string & = "127.0.0.1");
+  ~remote_islands();
+
+  std::uint16_t port() const;
+  void join(const std::vector<net::endpoint> &, unsigned);
+
+  void exchange(population<T> &, evaluator<T> &, summary<T> *);
+
+  std::uintmax_t sent() const;
+  std::uintmax_t received() const;
+
+private:
+  void listen();
+  bool admissible(const T &) const;
+
+  const problem &prob_;
+  net::server server_;
+
+  // Members of the archipelago (this process included) and index of this
+  // process.
+  std::vector<net::endpoint> hosts_;
+  unsigned self_;
+
+  std::mutex mutex_;      // protects `inbox_`
+  std::vector<T> inbox_;  // migrants waiting to be imported
+
+  std::atomic<std::uintmax_t> sent_;
+  std::atomic<std::uintmax_t> received_;
+
+  std::atomic<bool> stop_;
+  std::thread listener_;
+};
+
+#include "kernel/remote_islands.tcc"
+
+}  // namespace vita
+
+#endif  // include guard
@@ -0,0 +1,286 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_REMOTE_ISLANDS_H)
+#  error "Don't include this file directly, include the specific .h instead"
+#endif
+
+#if !defined(VITA_REMOTE_ISLANDS_TCC)
+#define      VITA_REMOTE_ISLANDS_TCC
+
+///
+/// Starts receiving migrants.
+///
+/// \param[in] p       the problem we're working on (its symbol set is used
+///                    to decode the incoming individuals). The lifetime of
+///                    `p` must exceed the lifetime of `this` object
+/// \param[in] port    TCP port where migrants are received (`0` lets the
+///                    operating system choose a free one, see `port()`)
+/// \param[in] address numeric IPv4 address of the interface where migrants
+///                    are received (`0.0.0.0` for every interface, see
+///                    net::server)
+///
+/// \exception exception::network the port cannot be used
+///
+template<class T>
+remote_islands<T>::remote_islands(const problem &p, std::uint16_t port,
+                                  const std::string &address)
+  : prob_(p), server_(port, address), hosts_(), self_(0), mutex_(), inbox_(),
+    sent_(0), received_(0), stop_(false), listener_()
+{
+  listener_ = std::thread(&remote_islands::listen, this);
+}
+
+///
+/// Stops receiving migrants.
+///
+template<class T>
+remote_islands<T>::~remote_islands()
+{
+  stop_ = true;
+  listener_.join();
+}
+
+///
+/// \return the port where migrants are received
+///
+template<class T>
+std::uint16_t remote_islands<T>::port() const
+{
+  return server_.port();
+}
+
+///
+/// Sets the members of the archipelago.
+///
+/// \param[in] hosts every process of the archipelago (this one included).
+///                  All the processes must use the same list
+/// \param[in] self  index of this process in `hosts`
+///
+template<class T>
+void remote_islands<T>::join(const std::vector<net::endpoint> &hosts,
+                             unsigned self)
+{
+  Expects(self < hosts.size());
+
+  hosts_ = hosts;
+  self_ = self;
+}
+
+///
+/// \return number of individuals sent to the other processes
+///
+template<class T>
+std::uintmax_t remote_islands<T>::sent() const
+{
+  return sent_;
+}
+
+///
+/// \return number of individuals received from the other processes
+///
+template<class T>
+std::uintmax_t remote_islands<T>::received() const
+{
+  return received_;
+}
+
+///
+/// \param[in] prg an individual (or team) received from another process
+/// \return        `true` if `prg` can join the population of this process
+///
+/// The shape of the genome must match the one of the local individuals
+/// (this prevents out of range accesses during the evaluation).
+///
+template<class T>
+bool remote_islands<T>::admissible(const T &prg) const
+{
+  const auto &env(prob_.env);
+
+  if constexpr (is_team<T>::value)
+  {
+    if (prg.individuals() != env.team.individuals)
+      return false;
+
+    for (const auto &member : prg)
+      if (member.empty() || member.size() != env.mep.code_length
+          || member.categories() != prob_.sset.categories())
+        return false;
+  }
+  else if constexpr (std::is_same_v<T, i_mep>)
+  {
+    if (prg.empty() || prg.size() != env.mep.code_length
+        || prg.categories() != prob_.sset.categories())
+      return false;
+  }
+  else
+  {
+    if (prg.parameters() != prob_.sset.categories())
+      return false;
+  }
+
+  return prg.debug();
+}
+
+///
+/// Main loop of the thread receiving migrants.
+///
+/// Nothing received from the network can stop the thread: malformed messages
+/// and unfit migrants are discarded and exceptions (e.g. allocation failures
+/// caused by corrupted data) are logged.
+///
+template<class T>
+void remote_islands<T>::listen()
+{
+  using namespace std::chrono_literals;
+
+  std::string msg;
+  while (!stop_)
+    try
+    {
+      if (!server_.receive(&msg, 100ms))
+        continue;
+
+      std::vector<T> migrants;
+      if (!wire::unpack(msg, prob_.sset, &migrants))
+      {
+        vitaWARNING << "Malformed migration message";
+        continue;
+      }
+
+      const auto unfit(std::remove_if(migrants.begin(), migrants.end(),
+                                      [this](const T &prg)
+                                      {
+                                        return !admissible(prg);
+                                      }));
+      if (unfit != migrants.end())
+      {
+        vitaWARNING << "Discarded " << std::distance(unfit, migrants.end())
+                    << " migrants not fitting the problem";
+        migrants.erase(unfit, migrants.end());
+      }
+
+      received_ += migrants.size();
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      inbox_.insert(inbox_.end(), migrants.begin(), migrants.end());
+
+      // Processes faster than this one cannot fill the memory.
+      const std::size_t max(prob_.env.individuals);
+      if (inbox_.size() > max)
+        inbox_.erase(inbox_.begin(), inbox_.end() - max);
+    }
+    catch (const std::exception &e)
+    {
+      vitaWARNING << "Migration message rejected: " << e.what();
+    }
+}
+
+///
+/// Imports and exports migrants.
+///
+/// \param[in,out] pop the population of this process
+/// \param[in]     eva the evaluator used by the evolution
+/// \param[in,out] s   statistical summary of the evolution
+///
+/// It's called at the end of every generation (see evolution::migration)
+/// but only works every `env.island.interval` generations.
+///
+template<class T>
+void remote_islands<T>::exchange(population<T> &pop, evaluator<T> &eva,
+                                 summary<T> *s)
+{
+  Expects(s);
+
+  const auto &env(prob_.env);
+  if (!env.island.interval || (s->gen + 1) % env.island.interval)
+    return;
+
+  // --------- IMMIGRATION ---------
+  std::vector<T> immigrants;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    immigrants.swap(inbox_);
+  }
+
+  if (!immigrants.empty())
+  {
+    const auto l(pop.layers() - 1);
+    const auto n(pop.individuals(l));
+
+    std::vector<fitness_t> fit;
+    fit.reserve(n);
+    for (unsigned i(0); i < n; ++i)
+      fit.push_back(eva(pop[{l, i}]));
+
+    std::vector<unsigned> worst(n);
+    std::iota(worst.begin(), worst.end(), 0);
+    std::stable_sort(worst.begin(), worst.end(),
+                     [&fit](unsigned a, unsigned b)
+                     {
+                       return fit[a] < fit[b];
+                     });
+
+    for (std::size_t i(0); i < std::min<std::size_t>(immigrants.size(), n);
+         ++i)
+    {
+      const auto f(eva(immigrants[i]));
+      if (f > fit[worst[i]])
+      {
+        pop[{l, worst[i]}] = immigrants[i];
+
+        if (f > s->best.score.fitness)
+        {
+          s->last_imp           = s->gen;
+          s->best.solution      = immigrants[i];
+          s->best.score.fitness = f;
+        }
+      }
+    }
+  }
+
+  // --------- EMIGRATION ---------
+  if (hosts_.size() < 2)
+    return;
+
+  using scored = std::pair<fitness_t, typename population<T>::coord>;
+  std::vector<scored> candidates;
+  for (unsigned l(0); l < pop.layers(); ++l)
+    for (unsigned i(0); i < pop.individuals(l); ++i)
+      candidates.push_back({eva(pop[{l, i}]), {l, i}});
+
+  const auto m(std::min<std::size_t>(env.island.migrants,
+                                     candidates.size()));
+  std::partial_sort(candidates.begin(), candidates.begin() + m,
+                    candidates.end(),
+                    [](const scored &a, const scored &b)
+                    {
+                      return a.first > b.first;
+                    });
+
+  std::vector<T> emigrants;
+  for (std::size_t i(0); i < m; ++i)
+    emigrants.push_back(pop[candidates[i].second]);
+
+  const auto frame(wire::pack(emigrants));
+
+  for (auto to : island_neighbours(env.island.topology,
+                                   static_cast<unsigned>(hosts_.size()),
+                                   self_))
+    if (net::send(hosts_[to], frame))
+      sent_ += emigrants.size();
+    else
+      vitaWARNING << "Cannot send migrants to " << hosts_[to].host << ':'
+                  << hosts_[to].port;
+}
+
+#endif  // include guard
@@ -13,9 +13,14 @@
 #if !defined(VITA_SEARCH_H)
 #define      VITA_SEARCH_H
 
+#include <mutex>
+#include <sstream>
+
 #include "kernel/evolution.h"
+#include "kernel/persistent_cache.h"
 #include "kernel/problem.h"
 #include "kernel/validation_strategy.h"
+#include "utility/thread_pool.h"
 
 namespace vita
 {
@@ -64,6 +69,9 @@ public:
 
   search &after_generation(
     typename evolution<T, ES>::after_generation_callback_t);
+  search &migration(remote_islands<T> *);
+
+  virtual hash_t fingerprint() const;
 
   virtual bool debug() const;
 
@@ -96,11 +104,31 @@ protected:
 
   virtual void tune_parameters();
 
+  template<class E> std::unique_ptr<evaluator<T>> with_cache(E) const;
+
   // *** Data members ***
   std::unique_ptr<evaluator<T>> eva1_;  // fitness function for training
   std::unique_ptr<evaluator<T>> eva2_;  // fitness function for validation
   std::unique_ptr<vita::validation_strategy> vs_;
 
+  // Builds a new training evaluator, independent from `eva1_`, for a
+  // concurrent run or island (empty if not available).
+  evaluator_factory<T> eva1_factory_;
+
+  // Cache shared by the evaluators built by `eva1_factory_` and, with
+  // islands, by `eva1_` (empty if not available).
+  std::shared_ptr<concurrent_cache> shared_cache_;
+
+  // As `shared_cache_` but stored in a file (see environment::misc).
+  std::shared_ptr<persistent_cache> persistent_cache_;
+
+  // Type of the training evaluator (part of the fingerprint).
+  std::string eva1_type_;
+
+  // `true` when the last search didn't use `eva1_` for the evolution
+  // (concurrent runs).
+  bool eva1_idle_;
+
   // Problem we're working on.
   problem &prob_;
 
@@ -108,7 +136,12 @@ protected:
   typename evolution<T, ES>::after_generation_callback_t
   after_generation_callback_;
 
+  // Link to the islands evolving in other processes (optional).
+  remote_islands<T> *migration_;
+
 private:
+  unsigned concurrent_runs(unsigned) const;
+  void open_cache();
   void log_stats(const search_stats<T> &) const;
   bool load();
   bool save() const;
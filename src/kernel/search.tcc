@@ -24,7 +24,11 @@
 template<class T, template<class> class ES>
 search<T, ES>::search(problem &p) : eva1_(nullptr), eva2_(nullptr),
                                     vs_(std::make_unique<as_is_validation>()),
-                                    prob_(p), after_generation_callback_()
+                                    eva1_factory_(), shared_cache_(),
+                                    persistent_cache_(), eva1_type_(),
+                                    eva1_idle_(false), prob_(p),
+                                    after_generation_callback_(),
+                                    migration_(nullptr)
 {
   Ensures(debug());
 }
@@ -37,6 +41,23 @@ search<T, ES> &search<T, ES>::after_generation(
   return *this;
 }
 
+///
+/// Spreads the search over many processes.
+///
+/// \param[in] r link to the other processes of the archipelago (see
+///              vita::remote_islands). The lifetime of `r` must exceed the
+///              lifetime of the search
+/// \return      a reference to `*this` object (fluent interface)
+///
+/// Every run exchanges migrants with the other processes.
+///
+template<class T, template<class> class ES>
+search<T, ES> &search<T, ES>::migration(remote_islands<T> *r)
+{
+  migration_ = r;
+  return *this;
+}
+
 template<class T, template<class> class ES>
 bool search<T, ES>::can_validate() const
 {
@@ -180,29 +201,113 @@ void search<T, ES>::after_evolution(const summary<T> &s)
 /// \param[in] n number of runs
 /// \return      a summary of the search
 ///
+/// Every run has its own seed, derived from the state of the random engine
+/// at the beginning of the search. When possible (see
+/// `environment::parallel_runs`) runs are performed concurrently: the
+/// end-of-run work (metrics, statistics, logs...) is still done on the
+/// calling thread, in run-index order. Results don't depend on the number of
+/// concurrent runs.
+///
+/// \remark
+/// With concurrent runs the after-generation callback (see
+/// search::after_generation) is called from many threads, but never
+/// concurrently. The training evaluator isn't used by the concurrent runs
+/// and its cache isn't saved (see `save()`).
+///
 template<class T, template<class> class ES>
 summary<T> search<T, ES>::run(unsigned n)
 {
   init();
 
-  auto shake([this](unsigned g) { return vs_->shake(g); });
+  const auto seed(random::engine());
   search_stats<T> stats;
 
-  for (unsigned r(0); r < n; ++r)
+  const auto after_run([&](unsigned r, summary<T> *s)
   {
-    vs_->init(r);
-    auto run_summary(evolution<T, ES>(prob_, *eva1_)
-                     .after_generation(after_generation_callback_)
-                     .run(r, shake));
     vs_->close(r);
 
     // Possibly calculates additional metrics.
-    calculate_metrics(&run_summary);
+    calculate_metrics(s);
 
-    after_evolution(run_summary);
+    after_evolution(*s);
 
-    stats.update(run_summary);
+    stats.update(*s);
     log_stats(stats);
+  });
+
+  if (const auto threads(concurrent_runs(n)); threads > 1)
+  {
+    // The validation strategy is initialized, one run at a time, before
+    // starting the concurrent runs. The state of the random engine after
+    // the initialization is the starting point of a run.
+    std::vector<random::engine_t> engines;
+    for (unsigned r(0); r < n; ++r)
+    {
+      random::engine.seed(seed + r);
+      vs_->init(r);
+      engines.push_back(random::engine);
+    }
+
+    open_cache();
+
+    if (!shared_cache_ && prob_.env.cache_size && !persistent_cache_)
+      shared_cache_ = std::make_shared<concurrent_cache>(prob_.env.cache_size);
+
+    std::vector<std::shared_ptr<evaluator<T>>> evas;
+    for (unsigned w(0); w < threads; ++w)
+      evas.push_back(eva1_factory_());
+
+    // Calls of the user-supplied callback are serialized.
+    std::mutex callback_mutex;
+    typename evolution<T, ES>::after_generation_callback_t callback;
+    if (after_generation_callback_)
+      callback = [&](const population<T> &p, const summary<T> &s)
+                 {
+                   std::lock_guard lock(callback_mutex);
+                   after_generation_callback_(p, s);
+                 };
+
+    std::vector<summary<T>> summaries(n);
+
+    thread_pool(threads).run(n, [&](std::size_t r, unsigned w)
+    {
+      random::engine = engines[r];
+      summaries[r] = evolution<T, ES>(prob_, *evas[w])
+                     .after_generation(callback)
+                     .run(r);
+    });
+
+    eva1_idle_ = true;
+
+    for (unsigned r(0); r < n; ++r)
+      after_run(r, &summaries[r]);
+  }
+  else
+  {
+    eva1_idle_ = false;
+
+    auto shake([this](unsigned g) { return vs_->shake(g); });
+
+    // Additional evaluators (e.g. for the islands) work on a copy of the
+    // training set which cannot follow the changes of the validation
+    // strategy.
+    const auto factory(vs_->concurrent() ? eva1_factory_
+                                         : evaluator_factory<T>());
+
+    for (unsigned r(0); r < n; ++r)
+    {
+      random::engine.seed(seed + r);
+      vs_->init(r);
+      open_cache();
+
+      auto run_summary(evolution<T, ES>(prob_, *eva1_)
+                       .after_generation(after_generation_callback_)
+                       .evaluators(factory)
+                       .migration(migration_)
+                       .run(r, shake));
+
+      after_run(r, &run_summary);
+    }
   }
 
   close();
@@ -210,6 +315,82 @@ summary<T> search<T, ES>::run(unsigned n)
   return stats.overall;
 }
 
+///
+/// \return a signature of the data the training fitnesses depend on
+///
+/// The base implementation considers the type of the training evaluator and
+/// the symbol set. Derived classes add the training data.
+///
+/// \see persistent_cache
+///
+template<class T, template<class> class ES>
+hash_t search<T, ES>::fingerprint() const
+{
+  std::ostringstream ss;
+  ss << eva1_type_ << '\n' << prob_.sset;
+
+  const auto str(ss.str());
+  return hash::hash128(str.data(), str.size());
+}
+
+///
+/// Links the persistent cache (if available) to its file.
+///
+/// \remark
+/// Called after the initialization of the validation strategy, at the
+/// beginning of a run.
+///
+template<class T, template<class> class ES>
+void search<T, ES>::open_cache()
+{
+  if (!persistent_cache_)
+    return;
+
+  // The content of the cache must refer to a fixed training set.
+  if (!vs_->concurrent())
+  {
+    if (persistent_cache_->is_open())
+      persistent_cache_->close();
+
+    vitaWARNING << "Cache file ignored (the training set changes during "
+                << "the run)";
+    return;
+  }
+
+  if (!persistent_cache_->open(prob_.env.misc.cache_file, fingerprint()))
+  {
+    vitaWARNING << "Cannot use the cache file "
+                << prob_.env.misc.cache_file;
+  }
+}
+
+///
+/// \param[in] n number of runs
+/// \return      number of runs that can be performed at the same time
+///
+template<class T, template<class> class ES>
+unsigned search<T, ES>::concurrent_runs(unsigned n) const
+{
+  const auto &env(prob_.env);
+
+  unsigned ret(env.parallel_runs ? env.parallel_runs
+                                 : std::thread::hardware_concurrency());
+  ret = std::min(ret, n);
+
+  if (ret <= 1)
+    return 1;
+
+  if (!eva1_factory_ || !vs_->concurrent() || env.arl || migration_
+      || !env.stat.dynamic_file.empty() || !env.stat.layers_file.empty()
+      || !env.stat.population_file.empty())
+  {
+    vitaWARNING << "Runs cannot be performed concurrently";
+    return 1;
+  }
+
+  return ret;
+}
+
 template<class T>
 void search_stats<T>::update(const summary<T> &r)
 {
@@ -264,10 +445,13 @@ bool search<T, ES>::load()
 ///
 /// \return `true` if the object was saved correctly
 ///
+/// After concurrent runs the cache of the training evaluator contains
+/// nothing new: the file isn't touched.
+///
 template<class T, template<class> class ES>
 bool search<T, ES>::save() const
 {
-  if (prob_.env.misc.serialization_file.empty())
+  if (prob_.env.misc.serialization_file.empty() || eva1_idle_)
     return true;
 
   std::ofstream out(prob_.env.misc.serialization_file);
@@ -316,15 +500,71 @@ template<class T, template<class> class ES>
 template<class E, class... Args>
 search<T, ES> &search<T, ES>::training_evaluator(Args && ...args)
 {
-  if (prob_.env.cache_size)
-    eva1_ = std::make_unique<evaluator_proxy<T, E>>(
-      E(std::forward<Args>(args)...), prob_.env.cache_size);
+  const auto &env(prob_.env);
+
+  eva1_type_ = typeid(E).name();
+
+  persistent_cache_ = env.cache_size && !env.misc.cache_file.empty()
+                      ? std::make_shared<persistent_cache>(env.cache_size)
+                      : nullptr;
+
+  // Concurrent runs and islands need their own copy of the training
+  // evaluator. The copies share the same cache, so they reuse each other's
+  // evaluations.
+  // Islands evolve alongside `eva1_`, which must join the shared cache. The
+  // concurrent runs don't use `eva1_` and get their cache when they start
+  // (see `run()`): otherwise `eva1_` keeps a private, resizable, `cache`.
+  if constexpr ((std::is_copy_constructible_v<std::decay_t<Args>> && ...))
+  {
+    shared_cache_ = ES<T>::is_island && env.cache_size && !persistent_cache_
+                    ? std::make_shared<concurrent_cache>(env.cache_size)
+                    : nullptr;
+
+    eva1_factory_ = [this, args...]
+                    {
+                      return std::shared_ptr<evaluator<T>>(
+                        with_cache(E(args...)));
+                    };
+  }
   else
-    eva1_ = std::make_unique<E>(std::forward<Args>(args)...);
+  {
+    shared_cache_ = nullptr;
+    eva1_factory_ = nullptr;
+  }
+
+  eva1_ = with_cache(E(std::forward<Args>(args)...));
 
   return *this;
 }
 
+///
+/// \param[in] eva an evaluator
+/// \return        `eva`, behind a cache if the environment requires it
+///
+/// The cache is the one shared among the training evaluators (possibly
+/// persistent), when available.
+///
+template<class T, template<class> class ES>
+template<class E>
+std::unique_ptr<evaluator<T>> search<T, ES>::with_cache(E eva) const
+{
+  if (prob_.env.cache_size)
+  {
+    if (persistent_cache_)
+      return std::make_unique<evaluator_proxy<T, E, persistent_cache>>(
+        std::move(eva), persistent_cache_);
+
+    if (shared_cache_)
+      return std::make_unique<evaluator_proxy<T, E, concurrent_cache>>(
+        std::move(eva), shared_cache_);
+
+    return std::make_unique<evaluator_proxy<T, E>>(std::move(eva),
+                                                   prob_.env.cache_size);
+  }
+
+  return std::make_unique<E>(std::move(eva));
+}
+
 ///
 /// Sets the validation evaluator (used for validation).
 ///
@@ -0,0 +1,266 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <future>
+
+#include "kernel/src/chunked_dataframe.h"
+#include "kernel/src/dataframe_binary.h"
+
+namespace vita
+{
+
+///
+/// Opens a dataset stored in a binary data file.
+///
+/// \param[in] fn   name of the binary data file
+/// \param[in] rows number of rows of a chunk
+///
+/// \exception exception::data_format wrong / unsupported data file
+///
+chunked_dataframe::chunked_dataframe(const std::filesystem::path &fn,
+                                     std::size_t rows)
+  : file_(std::make_shared<binary_data_file>(fn)), chunk_size_(rows),
+    base_id_(dataframe::new_ids(file_->size()))
+{
+  Expects(rows);
+}
+
+///
+/// \return number of examples of the dataset
+///
+std::size_t chunked_dataframe::size() const
+{
+  return file_->size();
+}
+
+///
+/// \return `true` if the dataset is empty
+///
+bool chunked_dataframe::empty() const
+{
+  return size() == 0;
+}
+
+///
+/// \return number of chunks of the dataset (the last one can be smaller
+///         than the others)
+///
+std::size_t chunked_dataframe::chunks() const
+{
+  return (size() + chunk_size_ - 1) / chunk_size_;
+}
+
+///
+/// \return maximum number of rows of a chunk
+///
+std::size_t chunked_dataframe::chunk_size() const
+{
+  return chunk_size_;
+}
+
+///
+/// \param[in] c index of a chunk
+/// \return      index of the first row and index one past the last row of
+///              the `c`-th chunk
+///
+std::pair<std::size_t, std::size_t> chunked_dataframe::range(
+  std::size_t c) const
+{
+  Expects(c < chunks());
+
+  const auto first(c * chunk_size_);
+  return {first, std::min(first + chunk_size_, size())};
+}
+
+///
+/// \return number of input variables (features)
+///
+unsigned chunked_dataframe::variables() const
+{
+  const auto n(file_->columns().size());
+  return n ? static_cast<unsigned>(n - 1) : 0;
+}
+
+///
+/// \return number of classes (`0` for symbolic regression tasks)
+///
+class_t chunked_dataframe::classes() const
+{
+  return file_->classes().size();
+}
+
+///
+/// \param[in] r index of a row
+/// \return      the ID of the example stored in row `r`
+///
+std::uintmax_t chunked_dataframe::id(std::size_t r) const
+{
+  Expects(r < size());
+  return base_id_ + r;
+}
+
+///
+/// \param[in] id ID of an example loaded from this dataset
+/// \return       the index of the row containing the example
+///
+std::size_t chunked_dataframe::row(std::uintmax_t id) const
+{
+  Expects(base_id_ <= id);
+  Expects(id < base_id_ + size());
+
+  return static_cast<std::size_t>(id - base_id_);
+}
+
+// Removes the examples of `d` and sets the metadata of the dataset.
+void chunked_dataframe::reset(dataframe &d, std::size_t n) const
+{
+  d.clear();
+  d.dataset_.reserve(n);
+  d.columns = file_->columns();
+  d.classes_map_ = file_->classes();
+}
+
+///
+/// Loads a chunk.
+///
+/// \param[in]  c   index of a chunk
+/// \param[out] out the examples of the `c`-th chunk (previous content is
+///                 removed)
+///
+/// Difficulty and age of the loaded examples are `0`.
+///
+void chunked_dataframe::load(std::size_t c, dataframe &out) const
+{
+  const auto [first, last] = range(c);
+
+  reset(out, last - first);
+
+  for (auto r(first); r < last; ++r)
+  {
+    auto e((*file_)[r]);
+    e.id = id(r);
+    out.push_back(e);
+  }
+}
+
+///
+/// Loads a subset of the dataset.
+///
+/// \param[in]  rows indices of the rows to be loaded
+/// \param[out] out  the examples (previous content is removed)
+///
+/// Difficulty and age of the loaded examples are `0`.
+///
+/// \remark
+/// Loading is faster (mostly sequential disk access) when `rows` is sorted.
+///
+void chunked_dataframe::load(const std::vector<std::size_t> &rows,
+                             dataframe &out) const
+{
+  reset(out, rows.size());
+
+  for (const auto r : rows)
+  {
+    auto e((*file_)[r]);
+    e.id = id(r);
+    out.push_back(e);
+  }
+}
+
+///
+/// Starts reading a chunk from disk in the background.
+///
+/// \param[in] c index of a chunk
+///
+/// A following `load(c, ...)` will (likely) find the data in memory.
+///
+void chunked_dataframe::prefetch(std::size_t c) const
+{
+  const auto [first, last] = range(c);
+  file_->will_need(first, last);
+}
+
+///
+/// Accesses the values of a chunk without loading the examples.
+///
+/// \param[in] c index of a chunk
+/// \return      `r[0]` points to the outputs and `r[i + 1]` to the values of
+///              the `i`-th feature of the rows of the `c`-th chunk. The
+///              columns are read in place from the data file (`NaN` is the
+///              empty value). If a column doesn't contain `D_DOUBLE`s the
+///              result is empty (see `load()`)
+///
+std::vector<const D_DOUBLE *> chunked_dataframe::real_columns(
+  std::size_t c) const
+{
+  const auto first(range(c).first);
+
+  std::vector<const D_DOUBLE *> ret(file_->columns().size());
+  for (std::size_t j(0); j < ret.size(); ++j)
+  {
+    const auto *col(file_->reals(j));
+    if (!col)
+      return {};
+
+    ret[j] = col + first;
+  }
+
+  return ret;
+}
+
+///
+/// Performs a complete pass over the dataset.
+///
+/// \param[in] f function called, in order, for every chunk
+///
+/// The next chunk is loaded by another thread while `f` is working on the
+/// current one: apart from the first chunk, disk access and conversion of
+/// the examples overlap with `f`.
+///
+/// \remark
+/// The dataframe passed to `f` is a temporary buffer: its content can be
+/// modified or moved (swapping it with another dataframe allows `f` to keep
+/// the examples without copying them).
+///
+void chunked_dataframe::for_each_chunk(
+  const std::function<void (dataframe &)> &f) const
+{
+  const auto n(chunks());
+  if (!n)
+    return;
+
+  dataframe current, next;
+  load(0, current);
+
+  for (std::size_t c(0); c < n; ++c)
+  {
+    std::future<void> loading;
+    if (c + 1 < n)
+      loading = std::async(std::launch::async,
+                           [this, c, n, &next]
+                           {
+                             if (c + 2 < n)
+                               prefetch(c + 2);
+                             load(c + 1, next);
+                           });
+
+    f(current);
+
+    if (loading.valid())
+    {
+      loading.get();
+      std::swap(current, next);
+    }
+  }
+}
+
+}  // namespace vita
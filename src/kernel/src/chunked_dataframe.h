@@ -0,0 +1,82 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_CHUNKED_DATAFRAME_H)
+#define      VITA_CHUNKED_DATAFRAME_H
+
+#include <memory>
+
+#include "kernel/src/dataframe.h"
+
+namespace vita
+{
+
+class binary_data_file;
+
+///
+/// A dataset kept on disk and loaded in chunks.
+///
+/// The examples are stored in a binary data file (see
+/// `dataframe::write_binary`, a CSV / XRFF file can be converted with
+/// `sr --binary`). The file is memory-mapped and only the required examples
+/// are loaded into a vita::dataframe: a chunk (a range of `chunk_size()`
+/// consecutive rows, see `load(std::size_t, dataframe &)`) or an arbitrary
+/// subset (see `load(const std::vector<std::size_t> &, dataframe &)`).
+///
+/// So the dataset can be much larger than the available memory: a complete
+/// pass (see `for_each_chunk`) keeps at most two chunks in memory.
+///
+/// Every row has a fixed ID (the same for every load, see `id()` / `row()`)
+/// which allows to keep track of an example across different loads.
+///
+/// \remark
+/// The object is a lightweight handle: copies share the same file.
+///
+class chunked_dataframe
+{
+public:
+  explicit chunked_dataframe(const std::filesystem::path &,
+                             std::size_t = 65536);
+
+  std::size_t size() const;
+  bool empty() const;
+  std::size_t chunks() const;
+  std::size_t chunk_size() const;
+  std::pair<std::size_t, std::size_t> range(std::size_t) const;
+
+  unsigned variables() const;
+  class_t classes() const;
+
+  std::uintmax_t id(std::size_t) const;
+  std::size_t row(std::uintmax_t) const;
+
+  void load(std::size_t, dataframe &) const;
+  void load(const std::vector<std::size_t> &, dataframe &) const;
+  void prefetch(std::size_t) const;
+  std::vector<const D_DOUBLE *> real_columns(std::size_t) const;
+
+  void for_each_chunk(const std::function<void (dataframe &)> &) const;
+
+private:
+  void reset(dataframe &, std::size_t) const;
+
+  std::shared_ptr<const binary_data_file> file_;
+
+  std::size_t chunk_size_;
+
+  // ID of the first row (rows have consecutive IDs).
+  std::uintmax_t base_id_;
+};
+
+}  // namespace vita
+
+#endif  // include guard
@@ -0,0 +1,432 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "kernel/src/columnar_dataframe.h"
+
+namespace vita
+{
+///
+/// \return the storage type of the column
+///
+columnar_dataframe::column::storage columnar_dataframe::column::type() const
+{
+  return type_;
+}
+
+///
+/// Converts the column to `storage::generic`.
+///
+void columnar_dataframe::column::to_generic()
+{
+  if (type_ == storage::generic)
+    return;
+
+  const auto n(size());
+  std::vector<value_t> values;
+  values.reserve(n + 1);
+  for (std::size_t i(0); i < n; ++i)
+    values.push_back((*this)[i]);
+
+  *this = column();
+  type_ = storage::generic;
+  generic_ = std::move(values);
+}
+
+///
+/// Appends a value to the column.
+///
+/// \param[in] v the value
+///
+/// The first non-empty value fixes the storage type of the column. Values
+/// which don't fit the current storage type convert the column to
+/// `storage::generic`.
+///
+void columnar_dataframe::column::push_back(const value_t &v)
+{
+  constexpr auto nan(std::numeric_limits<D_DOUBLE>::quiet_NaN());
+
+  if (type_ == storage::none)
+  {
+    if (!has_value(v))
+    {
+      ++empty_;
+      return;
+    }
+
+    if (std::holds_alternative<D_DOUBLE>(v))
+    {
+      type_ = storage::real;
+      reals_.assign(empty_, nan);
+    }
+    else if (empty_)
+      to_generic();
+    else
+      type_ = std::holds_alternative<D_INT>(v) ? storage::integer
+                                               : storage::string;
+    empty_ = 0;
+  }
+
+  switch (type_)
+  {
+  case storage::real:
+    if (!has_value(v))
+    {
+      reals_.push_back(nan);
+      return;
+    }
+
+    // A `NaN` value would be confused with an empty one.
+    if (const auto *d = std::get_if<D_DOUBLE>(&v); d && !std::isnan(*d))
+    {
+      reals_.push_back(*d);
+      return;
+    }
+    break;
+
+  case storage::integer:
+    if (const auto *i = std::get_if<D_INT>(&v))
+    {
+      integers_.push_back(*i);
+      return;
+    }
+    break;
+
+  case storage::string:
+    if (const auto *s = std::get_if<D_STRING>(&v))
+    {
+      const auto code(static_cast<std::uint32_t>(dictionary_.size()));
+      const auto ins(encoding_.try_emplace(*s, code));
+      if (ins.second)
+        dictionary_.push_back(*s);
+
+      codes_.push_back(ins.first->second);
+      return;
+    }
+    break;
+
+  default:
+    break;
+  }
+
+  to_generic();
+  generic_.push_back(v);
+}
+
+///
+/// \param[in] i index of an element
+/// \return      the `i`-th value of the column
+///
+value_t columnar_dataframe::column::operator[](std::size_t i) const
+{
+  Expects(i < size());
+
+  switch (type_)
+  {
+  case storage::real:
+    if (std::isnan(reals_[i]))
+      return {};
+    return reals_[i];
+
+  case storage::integer:
+    return integers_[i];
+
+  case storage::string:
+    return dictionary_[codes_[i]];
+
+  case storage::generic:
+    return generic_[i];
+
+  default:
+    return {};
+  }
+}
+
+///
+/// \return the content of a `storage::real` column (`nullptr` for other
+///         storage types). `NaN` encodes the empty value
+///
+const D_DOUBLE *columnar_dataframe::column::reals() const
+{
+  return type_ == storage::real ? reals_.data() : nullptr;
+}
+
+///
+/// \return the content of a `storage::integer` column (`nullptr` for other
+///         storage types)
+///
+const D_INT *columnar_dataframe::column::integers() const
+{
+  return type_ == storage::integer ? integers_.data() : nullptr;
+}
+
+///
+/// \return the codes of a `storage::string` column (`nullptr` for other
+///         storage types)
+///
+/// \see dictionary()
+///
+const std::uint32_t *columnar_dataframe::column::codes() const
+{
+  return type_ == storage::string ? codes_.data() : nullptr;
+}
+
+///
+/// \return the distinct values of a `storage::string` column (`codes()[i]`
+///         is an index in this vector)
+///
+const std::vector<D_STRING> &columnar_dataframe::column::dictionary() const
+{
+  return dictionary_;
+}
+
+///
+/// \return number of elements of the column
+///
+std::size_t columnar_dataframe::column::size() const
+{
+  switch (type_)
+  {
+  case storage::real:     return reals_.size();
+  case storage::integer:  return integers_.size();
+  case storage::string:   return codes_.size();
+  case storage::generic:  return generic_.size();
+  default:                return empty_;
+  }
+}
+
+///
+/// \return an estimate of the memory (in bytes) used by the column
+///
+std::size_t columnar_dataframe::column::bytes() const
+{
+  std::size_t ret(sizeof(*this)
+                  + reals_.capacity() * sizeof(D_DOUBLE)
+                  + integers_.capacity() * sizeof(D_INT)
+                  + codes_.capacity() * sizeof(std::uint32_t)
+                  + generic_.capacity() * sizeof(value_t));
+
+  for (const auto &s : dictionary_)
+    ret += 2 * (sizeof(s) + s.capacity());  // dictionary and encoding
+
+  for (const auto &v : generic_)
+    if (const auto *s = std::get_if<D_STRING>(&v))
+      ret += s->capacity();
+
+  return ret;
+}
+
+///
+/// Builds the columnar version of a dataframe.
+///
+/// \param[in] d a dataframe
+///
+columnar_dataframe::columnar_dataframe(const dataframe &d)
+{
+  difficulty_.reserve(d.size());
+  age_.reserve(d.size());
+  id_.reserve(d.size());
+
+  for (const auto &e : d)
+    push_back(e);
+
+  Ensures(debug());
+}
+
+///
+/// \return iterator to the first row
+///
+columnar_dataframe::const_iterator columnar_dataframe::begin() const
+{
+  return const_iterator(this, 0);
+}
+
+///
+/// \return iterator to the end of the rows
+///
+columnar_dataframe::const_iterator columnar_dataframe::end() const
+{
+  return const_iterator(this, size());
+}
+
+///
+/// \param[in] i index of a row
+/// \return      the `i`-th row as a `dataframe::example`
+///
+dataframe::example columnar_dataframe::operator[](std::size_t i) const
+{
+  Expects(i < size());
+
+  dataframe::example ret;
+
+  ret.input.reserve(variables());
+  for (std::size_t j(1); j < columns_.size(); ++j)
+    ret.input.push_back(columns_[j][i]);
+
+  ret.output = columns_.front()[i];
+  ret.difficulty = difficulty_[i];
+  ret.age = age_[i];
+  ret.id = id_[i];
+
+  return ret;
+}
+
+///
+/// Removes every row (and the type information of the columns).
+///
+void columnar_dataframe::clear()
+{
+  *this = columnar_dataframe();
+}
+
+///
+/// Appends an example.
+///
+/// \param[in] e the example
+///
+/// \remark
+/// Every example must have the same number of features.
+///
+void columnar_dataframe::push_back(const dataframe::example &e)
+{
+  if (columns_.empty())
+    columns_.resize(e.input.size() + 1);
+
+  Expects(e.input.size() == variables());
+
+  columns_.front().push_back(e.output);
+  for (std::size_t j(0); j < e.input.size(); ++j)
+    columns_[j + 1].push_back(e.input[j]);
+
+  difficulty_.push_back(e.difficulty);
+  age_.push_back(e.age);
+  id_.push_back(e.id);
+}
+
+///
+/// \param[in] i index of a feature
+/// \return      the column of the `i`-th feature
+///
+const columnar_dataframe::column &columnar_dataframe::input(
+  std::size_t i) const
+{
+  Expects(i < variables());
+  return columns_[i + 1];
+}
+
+///
+/// \return the column of the outputs (labels)
+///
+const columnar_dataframe::column &columnar_dataframe::output() const
+{
+  Expects(!columns_.empty());
+  return columns_.front();
+}
+
+///
+/// \return the difficulties of the examples (see `dataframe::example`)
+///
+const std::vector<std::uintmax_t> &columnar_dataframe::difficulty() const
+{
+  return difficulty_;
+}
+
+///
+/// \return the difficulties of the examples (see `dataframe::example`)
+///
+std::vector<std::uintmax_t> &columnar_dataframe::difficulty()
+{
+  return difficulty_;
+}
+
+///
+/// \return the ages of the examples (see `dataframe::example`)
+///
+const std::vector<unsigned> &columnar_dataframe::age() const
+{
+  return age_;
+}
+
+///
+/// \return the ages of the examples (see `dataframe::example`)
+///
+std::vector<unsigned> &columnar_dataframe::age()
+{
+  return age_;
+}
+
+///
+/// \return the IDs of the examples (see `dataframe::example`)
+///
+const std::vector<std::uintmax_t> &columnar_dataframe::ids() const
+{
+  return id_;
+}
+
+///
+/// \return number of rows
+///
+std::size_t columnar_dataframe::size() const
+{
+  return id_.size();
+}
+
+///
+/// \return `true` if there aren't rows
+///
+bool columnar_dataframe::empty() const
+{
+  return id_.empty();
+}
+
+///
+/// \return number of features
+///
+unsigned columnar_dataframe::variables() const
+{
+  return columns_.empty() ? 0 : static_cast<unsigned>(columns_.size() - 1);
+}
+
+///
+/// \return an estimate of the memory (in bytes) used by the object
+///
+std::size_t columnar_dataframe::bytes() const
+{
+  std::size_t ret(sizeof(*this)
+                  + difficulty_.capacity() * sizeof(std::uintmax_t)
+                  + age_.capacity() * sizeof(unsigned)
+                  + id_.capacity() * sizeof(std::uintmax_t));
+
+  for (const auto &c : columns_)
+    ret += c.bytes();
+
+  return ret;
+}
+
+///
+/// \return `true` if the object passes the internal consistency check
+///
+bool columnar_dataframe::debug() const
+{
+  if (difficulty_.size() != size() || age_.size() != size())
+    return false;
+
+  for (const auto &c : columns_)
+    if (c.size() != size())
+      return false;
+
+  return true;
+}
+
+}  // namespace vita
@@ -0,0 +1,177 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_COLUMNAR_DATAFRAME_H)
+#define      VITA_COLUMNAR_DATAFRAME_H
+
+#include <iterator>
+#include <unordered_map>
+
+#include "kernel/src/dataframe.h"
+
+namespace vita
+{
+///
+/// A column-oriented (struct-of-arrays) version of vita::dataframe.
+///
+/// Every feature is stored in a typed column:
+/// - `double` and `int` features in contiguous arrays;
+/// - strings are dictionary-encoded (an array of codes plus the dictionary of
+///   the distinct values);
+/// - features with values of different types (or with empty values not
+///   representable in the typed array) fall back to a column of `value_t`.
+///
+/// Outputs (labels), difficulties, ages and IDs of the examples are separate
+/// arrays.
+///
+/// Compared to a vita::dataframe (an allocation per example and a `value_t`
+/// for every feature) the memory footprint is much smaller and the values of
+/// a feature are adjacent in memory: batch evaluators can work directly on
+/// the columns (see `column::reals`, `src_interpreter::run` and
+/// vita::sum_of_errors_evaluator). The evaluators of a numeric dataset share
+/// a single copy (see `dataframe::real_columns`).
+///
+/// Rows are still accessible as `dataframe::example`s (see `operator[]` and
+/// the iterators) but they're built on the fly, so they're values and not
+/// references.
+///
+class columnar_dataframe
+{
+public:
+  class column;
+  class const_iterator;
+
+  columnar_dataframe() = default;
+  explicit columnar_dataframe(const dataframe &);
+
+  // ---- Iterators ----
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  dataframe::example operator[](std::size_t) const;
+
+  // ---- Modifiers ----
+  void clear();
+  void push_back(const dataframe::example &);
+
+  // ---- Columns ----
+  const column &input(std::size_t) const;
+  const column &output() const;
+
+  const std::vector<std::uintmax_t> &difficulty() const;
+  std::vector<std::uintmax_t> &difficulty();
+  const std::vector<unsigned> &age() const;
+  std::vector<unsigned> &age();
+  const std::vector<std::uintmax_t> &ids() const;
+
+  // ---- Convenience ----
+  std::size_t size() const;
+  bool empty() const;
+  unsigned variables() const;
+
+  std::size_t bytes() const;
+
+  bool debug() const;
+
+private:
+  // `columns_[0]` contains the outputs, `columns_[i + 1]` the `i`-th feature
+  // (the same layout of `dataframe::columns`).
+  std::vector<column> columns_ = {};
+
+  std::vector<std::uintmax_t> difficulty_ = {};
+  std::vector<unsigned>              age_ = {};
+  std::vector<std::uintmax_t>         id_ = {};
+};
+
+///
+/// A typed column of a vita::columnar_dataframe.
+///
+/// The storage type is chosen by the first non-empty value and becomes
+/// `storage::generic` (a column of `value_t`) as soon as a value of a
+/// different type (or an empty value that cannot be encoded) shows up.
+///
+class columnar_dataframe::column
+{
+public:
+  enum class storage {none, real, integer, string, generic};
+
+  storage type() const;
+
+  void push_back(const value_t &);
+  value_t operator[](std::size_t) const;
+
+  const D_DOUBLE *reals() const;
+  const D_INT *integers() const;
+  const std::uint32_t *codes() const;
+  const std::vector<D_STRING> &dictionary() const;
+
+  std::size_t size() const;
+  std::size_t bytes() const;
+
+private:
+  void to_generic();
+
+  storage type_ = storage::none;
+
+  // Number of leading empty values (when `type_ == storage::none`).
+  std::size_t empty_ = 0;
+
+  // Only the array matching `type_` is used. For `storage::real` a `NaN`
+  // encodes the empty value.
+  std::vector<D_DOUBLE>        reals_ = {};
+  std::vector<D_INT>        integers_ = {};
+  std::vector<std::uint32_t>   codes_ = {};
+  std::vector<value_t>       generic_ = {};
+
+  // Distinct strings of a `storage::string` column (`codes_[i]` indexes
+  // `dictionary_`) and the reverse mapping.
+  std::vector<D_STRING> dictionary_ = {};
+  std::unordered_map<D_STRING, std::uint32_t> encoding_ = {};
+};
+
+///
+/// Iterates over the rows of a vita::columnar_dataframe.
+///
+/// Rows are built on demand: `*it` returns a `dataframe::example` by value
+/// and `it->` refers to a temporary copy owned by the iterator.
+///
+class columnar_dataframe::const_iterator
+{
+public:
+  using iterator_category = std::input_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = dataframe::example;
+  using pointer = const value_type *;
+  using reference = value_type;
+
+  const_iterator() = default;
+  const_iterator(const columnar_dataframe *d, std::size_t i) : d_(d), i_(i) {}
+
+  const_iterator &operator++() { ++i_; return *this; }
+  const_iterator operator++(int) { auto tmp(*this); ++i_; return tmp; }
+
+  reference operator*() const { return (*d_)[i_]; }
+  pointer operator->() const { current_ = (*d_)[i_]; return &current_; }
+
+  bool operator==(const const_iterator &rhs) const { return i_ == rhs.i_; }
+  bool operator!=(const const_iterator &rhs) const { return i_ != rhs.i_; }
+
+private:
+  const columnar_dataframe *d_ = nullptr;
+  std::size_t               i_ = 0;
+
+  mutable value_type current_ = {};
+};
+
+}  // namespace vita
+
+#endif  // include guard
@@ -11,14 +11,16 @@
  */
 
 #include <algorithm>
+#include <atomic>
 
 #include "kernel/src/dataframe.h"
+#include "kernel/src/columnar_dataframe.h"
 #include "kernel/exceptions.h"
 #include "kernel/log.h"
 #include "kernel/random.h"
 #include "kernel/symbol.h"
 
-#include "tinyxml2/tinyxml2.h"
+#include "utility/xml_reader.h"
 
 namespace vita
 {
@@ -189,7 +191,8 @@ bool dataframe::columns_info::debug() const
 ///
 /// New empty data instance.
 ///
-dataframe::dataframe() : columns(), classes_map_(), dataset_()
+dataframe::dataframe() : columns(), classes_map_(), dataset_(),
+                         version_(new_version()), columnar_()
 {
   Ensures(debug());
 }
@@ -238,6 +241,7 @@ dataframe::dataframe(const std::filesystem::path &fn) : dataframe(fn, {}) {}
 void dataframe::clear()
 {
   dataset_.clear();
+  version_ = new_version();
 }
 
 ///
@@ -340,9 +344,100 @@ unsigned dataframe::variables() const
 ///
 /// \param[in] e the value of the element to append
 ///
+/// An element without ID gets a new one (see `new_ids`).
+///
 void dataframe::push_back(const example &e)
 {
   dataset_.push_back(e);
+  version_ = new_version();
+
+  if (!e.id)
+    dataset_.back().id = new_ids(1);
+}
+
+///
+/// Reserves a range of example IDs.
+///
+/// \param[in] n number of IDs required
+/// \return      the first ID of the range `[ret, ret + n[` (IDs are unique
+///              within the process and never `0`)
+///
+std::uintmax_t dataframe::new_ids(std::size_t n)
+{
+  static std::atomic<std::uintmax_t> next_id(1);
+
+  return next_id.fetch_add(n);
+}
+
+///
+/// \return a version never used before by any dataframe of the process
+///
+std::uintmax_t dataframe::new_version()
+{
+  static std::atomic<std::uintmax_t> next_version(1);
+
+  return next_version.fetch_add(1, std::memory_order_relaxed);
+}
+
+///
+/// \return the version of the examples
+///
+/// The version changes every time examples are added or removed (it never
+/// takes the same value twice, even across different dataframes). Copies of
+/// a dataframe share the version, as long as they aren't modified.
+///
+/// \remark
+/// Changes of the examples made via iterators aren't tracked: they're
+/// supposed to involve just the `difficulty` / `age` data members.
+///
+std::uintmax_t dataframe::version() const
+{
+  return version_;
+}
+
+struct dataframe::columnar_cache
+{
+  std::uintmax_t version;
+  std::shared_ptr<const columnar_dataframe> data;
+};
+
+///
+/// \return a column-oriented copy of the examples (`nullptr` unless every
+///         feature of every example is a `double`)
+///
+/// The copy is built on demand, only when the examples change (see
+/// `version()`), and is shared among all its users (e.g. the evaluators of
+/// different threads) and among the copies of this dataframe.
+///
+/// \remark Thread safe.
+///
+/// \see vita::sum_of_errors_evaluator
+///
+std::shared_ptr<const columnar_dataframe> dataframe::real_columns() const
+{
+  if (const auto cache = std::atomic_load(&columnar_);
+      cache && cache->version == version_)
+    return cache->data;
+
+  const bool real(std::all_of(begin(), end(),
+                              [](const example &e)
+                              {
+                                return std::all_of(
+                                  e.input.begin(), e.input.end(),
+                                  [](const value_t &v)
+                                  {
+                                    return std::holds_alternative<D_DOUBLE>(v);
+                                  });
+                              }));
+
+  auto cache(std::make_shared<columnar_cache>());
+  cache->version = version_;
+  if (real && !empty())
+    cache->data = std::make_shared<const columnar_dataframe>(*this);
+
+  std::atomic_store(&columnar_,
+                    std::shared_ptr<const columnar_cache>(cache));
+  return cache->data;
 }
 
 ///
@@ -449,16 +544,16 @@ std::string dataframe::class_name(class_t i) const
 ///
 /// \exception exception::data_format wrong data format for data file
 ///
-/// \see `dataframe::load_xrff(tinyxml2::XMLDocument &)` for details.
+/// \see `dataframe::read_xrff(std::istream &, const params &)` for details.
 ///
 std::size_t dataframe::read_xrff(const std::filesystem::path &fn,
                                  const params &p)
 {
-  tinyxml2::XMLDocument doc;
-  if (doc.LoadFile(fn.string().c_str()) != tinyxml2::XML_SUCCESS)
+  std::ifstream in(fn);
+  if (!in)
     throw exception::data_format("XRFF data file format error");
 
-  return read_xrff(doc, p);
+  return read_xrff(in, p);
 }
 
 ///
@@ -470,151 +565,161 @@ std::size_t dataframe::read_xrff(const std::filesystem::path &fn,
 ///
 /// \exception exception::data_format wrong data format for data file
 ///
-/// \see `dataframe::read_xrff(tinyxml2::XMLDocument &)` for details.
-///
-std::size_t dataframe::read_xrff(std::istream &in, const params &p)
-{
-  std::ostringstream ss;
-  ss << in.rdbuf();
-
-  tinyxml2::XMLDocument doc;
-  if (doc.Parse(ss.str().c_str()) != tinyxml2::XML_SUCCESS)
-    throw exception::data_format("XRFF data file format error");
-
-  return read_xrff(doc, p);
-}
-std::size_t dataframe::read_xrff(std::istream &in)
-{
-  return read_xrff(in, {});
-}
-
-///
-/// Loads a XRFF document into the active dataset.
-///
-/// \param[in] doc object containing the xrff file
-/// \param[in] p   additional, optional, parameters (see `params` structure)
-/// \return        number of lines parsed (0 in case of errors)
-///
-/// \exception exception::data_format wrong data format for data file
-///
 /// An XRFF (eXtensible attribute-Relation File Format) file describes a list
 /// of instances sharing a set of attributes.
 /// The original format is defined in
 /// https://waikato.github.io/weka-wiki/formats_and_processing/xrff/
 ///
+/// The stream is read in a single pass by a streaming parser (see
+/// vita::xml_reader): every instance is added to the dataframe as soon as
+/// it's read, so the memory required doesn't depend on the size of the file.
+///
+/// \remark
+/// The `header` element must precede the `body` element.
+///
 /// \warning
 /// To date we don't support compressed and sparse format XRFF files.
 ///
-std::size_t dataframe::read_xrff(tinyxml2::XMLDocument &doc, const params &p)
+std::size_t dataframe::read_xrff(std::istream &in, const params &p)
 {
-  // Iterate over `dataset.header.attributes` selection and store all found
-  // attributes in the header vector.
-  tinyxml2::XMLHandle handle(&doc);
-  auto *attributes(handle.FirstChildElement("dataset")
-                         .FirstChildElement("header")
-                         .FirstChildElement("attributes").ToElement());
-  if (!attributes)
-    throw exception::data_format("Missing `attributes` element in XRFF file");
-
   clear();
 
-  unsigned n_output(0), output_index(0), index(0);
+  xml_reader xml(in);
 
-  for (auto *attribute(attributes->FirstChildElement("attribute"));
-       attribute;
-       attribute = attribute->NextSiblingElement("attribute"), ++index)
-  {
-    columns_info::column_info a;
+  // `true` if the current element is at the given position of the document.
+  const auto at([&xml](std::initializer_list<const char *> names)
+                {
+                  return std::equal(xml.path().begin(), xml.path().end(),
+                                    names.begin(), names.end());
+                });
 
-    const char *s(attribute->Attribute("name"));
-    if (s)
-      a.name = s;
+  // As for the DOM interface of TinyXML-2, whitespace-only text is missing.
+  const auto text([&xml]
+                  {
+                    return trim(xml.text()).empty() ? std::string()
+                                                    : xml.text();
+                  });
 
-    // One can define which attribute should act as output value via the
-    // `class="yes"` attribute in the attribute specification of the header.
-    const bool output(attribute->Attribute("class", "yes"));
+  unsigned n_output(0), output_index(0), index(0);
+  bool header(false), body(false);
+
+  columns_info::column_info a;
+  std::string xml_type;
+  bool output(false);
 
-    s = attribute->Attribute("type");
-    std::string xml_type(s ? s : "");
+  record_t record;
 
-    if (output)
+  for (auto e(xml.next()); e != xml_reader::end_document; e = xml.next())
+    if (e == xml_reader::error)
+      throw exception::data_format("XRFF data file format error");
+    else if (e == xml_reader::start_element)
     {
-      ++n_output;
+      if (at({"dataset", "header", "attributes", "attribute"}))
+      {
+        a = {};
+        a.name = xml.attribute("name").value_or("");
 
-      output_index = index;
+        // One can define which attribute should act as output value via the
+        // `class="yes"` attribute in the attribute specification of the
+        // header.
+        output = xml.attribute("class") == "yes";
 
-      // We can manage only one output column.
-      if (n_output > 1)
-        throw exception::data_format("Multiple output columns in XRFF file");
+        xml_type = xml.attribute("type").value_or("");
 
-      // For classification problems we use discriminant functions, so the
-      // actual output type is always numeric.
-      if (xml_type == "nominal" || xml_type == "string")
-        xml_type = "numeric";
-    }
+        if (output)
+        {
+          ++n_output;
 
-    a.domain = from_weka(xml_type);
-
-    // Store label1... labelN.
-    if (xml_type == "nominal")
-      for (auto *l(attribute->FirstChildElement("label"));
-           l;
-           l = l->NextSiblingElement("label"))
-      {
-        const std::string label(l->GetText() ? l->GetText() : "");
-        a.states.insert(label);
-      }
+          output_index = index;
 
-    // Output column is always the first one.
-    if (output)
-      columns.push_front(a);
-    else
-      columns.push_back(a);
-  }
+          // We can manage only one output column.
+          if (n_output > 1)
+            throw exception::data_format(
+              "Multiple output columns in XRFF file");
 
-  // XRFF needs information about the columns.
-  if (columns.empty())
-    throw exception::data_format("Missing column information in XRFF file");
+          // For classification problems we use discriminant functions, so
+          // the actual output type is always numeric.
+          if (xml_type == "nominal" || xml_type == "string")
+            xml_type = "numeric";
+        }
 
-  // If no output column is specified the default XRFF output column is the
-  // last one (and it's the first element of the `header_` vector).
-  if (n_output == 0)
-  {
-    columns.push_front(columns.back());
-    columns.pop_back();
-    output_index = index - 1;
-  }
+        a.domain = from_weka(xml_type);
+      }
+      else if (at({"dataset", "body", "instances"}))
+      {
+        // Instances are converted while they're read: the information about
+        // the columns must be already available.
+        if (!header)
+          throw exception::data_format(
+            "Missing `attributes` element in XRFF file");
 
-  if (auto *instances = handle.FirstChildElement("dataset")
-                        .FirstChildElement("body")
-                        .FirstChildElement("instances").ToElement())
-  {
-    for (auto *i(instances->FirstChildElement("instance"));
-         i;
-         i = i->NextSiblingElement("instance"))
+        body = true;
+      }
+      else if (at({"dataset", "body", "instances", "instance"}))
+        record.clear();
+    }
+    else  // end_element
     {
-      record_t record;
-
-      for (auto *v(i->FirstChildElement("value"));
-           v;
-           v = v->NextSiblingElement("value"))
-        record.push_back(v->GetText() ? v->GetText() : "");
+      if (at({"dataset", "header", "attributes", "attribute", "label"}))
+      {
+        // Store label1... labelN.
+        if (xml_type == "nominal")
+          a.states.insert(text());
+      }
+      else if (at({"dataset", "header", "attributes", "attribute"}))
+      {
+        // Output column is always the first one.
+        if (output)
+          columns.push_front(a);
+        else
+          columns.push_back(a);
 
-      if (p.filter && p.filter(record) == false)
-        continue;
+        ++index;
+      }
+      else if (at({"dataset", "header", "attributes"}))
+      {
+        // XRFF needs information about the columns.
+        if (columns.empty())
+          throw exception::data_format(
+            "Missing column information in XRFF file");
+
+        // If no output column is specified the default XRFF output column is
+        // the last one (and it's the first element of the `header_` vector).
+        if (n_output == 0)
+        {
+          columns.push_front(columns.back());
+          columns.pop_back();
+          output_index = index - 1;
+        }
+
+        header = true;
+      }
+      else if (at({"dataset", "body", "instances", "instance", "value"}))
+        record.push_back(text());
+      else if (at({"dataset", "body", "instances", "instance"}))
+      {
+        if (p.filter && p.filter(record) == false)
+          continue;
 
-      std::rotate(record.begin(),
-                  std::next(record.begin(), output_index),
-                  std::next(record.begin(), output_index + 1));
+        std::rotate(record.begin(),
+                    std::next(record.begin(), output_index),
+                    std::next(record.begin(), output_index + 1));
 
-      read_record(record, false);
+        read_record(record, false);
+      }
     }
-  }
-  else
+
+  if (!header)
+    throw exception::data_format("Missing `attributes` element in XRFF file");
+  if (!body)
     throw exception::data_format("Missing `instances` element in XRFF file");
 
   return debug() ? size() : static_cast<std::size_t>(0);
 }
+std::size_t dataframe::read_xrff(std::istream &in)
+{
+  return read_xrff(in, {});
+}
 
 ///
 /// Loads a CSV file into the active dataset.
@@ -685,6 +790,10 @@ std::size_t dataframe::read_csv(const std::filesystem::path &fn,
 ///
 /// \note Test set can have an empty output value.
 ///
+/// \remark
+/// Data are parsed by vita::csv_block_parser (in parallel, a large block at a
+/// time).
+///
 std::size_t dataframe::read_csv(std::istream &from, params p)
 {
   clear();
@@ -693,31 +802,40 @@ std::size_t dataframe::read_csv(std::istream &from, params p)
     p.dialect.has_header = csv_sniffer(from).has_header;
 
   std::size_t count(0);
-  for (auto record : csv_parser(from, p.dialect).filter_hook(p.filter))
-  {
-    if (p.output_index)
+  record_t record;
+
+  const auto add(
+    [&](const csv_block_parser::fields_t &fields)
     {
-      assert(p.output_index < record.size());
-      //std::swap(record[0], record[*p.output_index]);
-      if (p.output_index > 0)
-        std::rotate(record.begin(),
-                    std::next(record.begin(), *p.output_index),
-                    std::next(record.begin(), *p.output_index + 1));
-    }
-    else
-      // When the output index is unspecified, all the columns are treated as
-      // input columns (this is obtained adding a surrogate, empty output
-      // column).
-      record.insert(record.begin(), "");
-
-    // Every new record may add further information about the column domain.
-    if (count < 10)
-      columns.build(record, *p.dialect.has_header);
-    if (p.dialect.has_header == false || count)
-      read_record(record, true);
-
-    ++count;
-  }
+      record.resize(fields.size());
+      for (std::size_t i(0); i < fields.size(); ++i)
+        record[i].assign(fields[i]);  // reuses the memory of the last record
+
+      if (p.output_index)
+      {
+        assert(p.output_index < record.size());
+        //std::swap(record[0], record[*p.output_index]);
+        if (p.output_index > 0)
+          std::rotate(record.begin(),
+                      std::next(record.begin(), *p.output_index),
+                      std::next(record.begin(), *p.output_index + 1));
+      }
+      else
+        // When the output index is unspecified, all the columns are treated as
+        // input columns (this is obtained adding a surrogate, empty output
+        // column).
+        record.insert(record.begin(), "");
+
+      // Every new record may add further information about the column domain.
+      if (count < 10)
+        columns.build(record, *p.dialect.has_header);
+      if (p.dialect.has_header == false || count)
+        read_record(record, true);
+
+      ++count;
+    });
+
+  csv_block_parser(from, p.dialect).filter_hook(p.filter).for_each(add);
 
   if (!debug() || !size())
     throw exception::insufficient_data("Empty / undersized CSV data file");
@@ -732,12 +850,16 @@ std::size_t dataframe::read_csv(std::istream &from)
 ///
 /// Loads the content of a file into the active dataset.
 ///
-/// \param[in] fn name of the file containing the data set (CSV / XRFF format)
+/// \param[in] fn name of the file containing the data set (CSV / XRFF /
+///               binary format)
 /// \param[in] p  additional, optional, parameters (see `params` structure)
 /// \return       number of lines parsed
 ///
 /// \exception std::invalid_argument missing dataset file name
 ///
+/// Binary files (see `write_binary`) are recognized by their content, the
+/// other formats by the extension of the file name.
+///
 /// \note Test set can have an empty output value.
 ///
 std::size_t dataframe::read(const std::filesystem::path &fn, const params &p)
@@ -745,6 +867,9 @@ std::size_t dataframe::read(const std::filesystem::path &fn, const params &p)
   if (fn.empty())
     throw std::invalid_argument("Missing dataset filename");
 
+  if (is_binary_dataframe(fn))
+    return read_binary(fn);
+
   const auto ext(fn.extension().string());
   const bool xrff(iequals(ext, ".xrff") || iequals(ext, ".xml"));
 
@@ -772,6 +897,7 @@ bool dataframe::operator!() const
 ///
 dataframe::iterator dataframe::erase(iterator first, iterator last)
 {
+  version_ = new_version();
   return dataset_.erase(first, last);
 }
 
@@ -16,6 +16,7 @@
 #include <filesystem>
 #include <functional>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -29,6 +30,8 @@ namespace vita
 /// The type used as class ID in classification tasks.
 using class_t = std::size_t;
 
+class columnar_dataframe;
+
 ///
 /// A 2-dimensional labeled data structure with columns of potentially
 /// different types.
@@ -39,7 +42,8 @@ using class_t = std::size_t;
 /// - is modelled on the corresponding *pandas* object;
 /// - is a forward iterable collection of "monomorphic" examples (all samples
 ///   have the same type and arity);
-/// - accepts many different kinds of input: CSV and XRFF files.
+/// - accepts many different kinds of input: CSV and XRFF files (and its own
+///   binary format, see `write_binary`).
 ///
 /// \see https://github.com/morinim/vita/wiki/dataframe
 ///
@@ -139,10 +143,17 @@ public:
   std::size_t read_csv(std::istream &, params);
   std::size_t read_xrff(std::istream &);
   std::size_t read_xrff(std::istream &, const params &);
+  std::size_t read_binary(const std::filesystem::path &);
+  bool write_binary(const std::filesystem::path &) const;
   bool operator!() const;
 
   void push_back(const example &);
 
+  static std::uintmax_t new_ids(std::size_t);
+
+  std::uintmax_t version() const;
+  std::shared_ptr<const columnar_dataframe> real_columns() const;
+
   std::size_t size() const;
   bool empty() const;
 
@@ -156,6 +167,8 @@ public:
   columns_info columns;
 
 private:
+  friend class chunked_dataframe;
+
   bool read_record(const record_t &, bool);
   example to_example(const record_t &, bool);
 
@@ -163,7 +176,8 @@ private:
 
   std::size_t read_csv(const std::filesystem::path &, const params &);
   std::size_t read_xrff(const std::filesystem::path &, const params &);
-  std::size_t read_xrff(tinyxml2::XMLDocument &, const params &);
+
+  static std::uintmax_t new_version();
 
   // Integer are simpler to manage than textual data, so, when appropriate,
   // input strings are converted into integers by this map and the `encode`
@@ -172,9 +186,18 @@ private:
 
   // Available data.
   examples_t dataset_;
+
+  // Changes every time examples are added or removed (see `version()`).
+  std::uintmax_t version_;
+
+  // Column-oriented copy of the examples shared by all the readers (see
+  // `real_columns()`).
+  struct columnar_cache;
+  mutable std::shared_ptr<const columnar_cache> columnar_;
 };
 
 domain_t from_weka(const std::string &);
+bool is_binary_dataframe(const std::filesystem::path &);
 
 ///
 /// Stores a single element (row) of the dataset.
@@ -189,6 +212,9 @@ domain_t from_weka(const std::string &);
 /// Supervised Learning in Genetic Programming" - Chris Gathercole, Peter
 /// Ross).
 ///
+/// `id` identifies the example even when it's moved to another dataframe
+/// (see `dataframe::push_back`): copies of an example share the same ID.
+///
 struct dataframe::example
 {
   /// The thing about which we want to make a prediction (aka instance). The
@@ -202,6 +228,8 @@ struct dataframe::example
   std::uintmax_t difficulty  =  0;
   unsigned              age  =  0;
 
+  std::uintmax_t         id  =  0;
+
   void clear() { *this = example(); }
 };
 
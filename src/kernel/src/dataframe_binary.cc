@@ -0,0 +1,587 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#if !defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#include "kernel/src/dataframe_binary.h"
+#include "kernel/exceptions.h"
+
+namespace vita
+{
+
+namespace
+{
+
+constexpr char k_magic[8] = "VITADFB";
+constexpr std::uint32_t k_version = 1;
+constexpr std::uint32_t k_byte_order = 0x01020304;
+
+using storage = columnar_dataframe::column::storage;
+
+struct header
+{
+  char          magic[8];
+  std::uint32_t version;
+  /// Detects files written on a machine with a different endianness.
+  std::uint32_t byte_order;
+  std::uint64_t rows;
+  /// Number of columns (output included, see `dataframe::columns`).
+  std::uint64_t columns;
+  std::uint64_t classes;
+};
+
+// Sequential writer. Arrays are aligned to 8 bytes (relative to the
+// beginning of the file) so that they can be used in place once mapped.
+class writer
+{
+public:
+  explicit writer(std::ostream &out) : out_(out) {}
+
+  void bytes(const void *p, std::size_t n)
+  {
+    out_.write(static_cast<const char *>(p), n);
+    offset_ += n;
+  }
+
+  template<class T> void put(const T &v) { bytes(&v, sizeof(v)); }
+
+  void put(const std::string &s)
+  {
+    put(static_cast<std::uint64_t>(s.size()));
+    bytes(s.data(), s.size());
+  }
+
+  void put(const value_t &v)
+  {
+    put(static_cast<std::uint32_t>(v.index()));
+
+    switch (v.index())
+    {
+    case d_int:     put(std::get<D_INT>(v));     break;
+    case d_double:  put(std::get<D_DOUBLE>(v));  break;
+    case d_string:  put(std::get<D_STRING>(v));  break;
+    }
+  }
+
+  template<class T> void array(const T *p, std::size_t n)
+  {
+    align();
+    bytes(p, n * sizeof(T));
+  }
+
+  void align()
+  {
+    static constexpr char zeros[8] = {};
+    bytes(zeros, (8 - offset_ % 8) % 8);
+  }
+
+private:
+  std::ostream &out_;
+  std::size_t offset_ = 0;
+};
+
+// Sequential reader working on a memory area (usually a mapped file).
+class reader
+{
+public:
+  reader(const char *base, std::size_t size)
+    : base_(base), p_(base), end_(base + size) {}
+
+  const char *bytes(std::size_t n)
+  {
+    if (n > static_cast<std::size_t>(end_ - p_))
+      throw exception::data_format("Truncated binary data file");
+
+    const char *const ret(p_);
+    p_ += n;
+    return ret;
+  }
+
+  template<class T> T get()
+  {
+    T ret;
+    std::memcpy(&ret, bytes(sizeof(T)), sizeof(T));
+    return ret;
+  }
+
+  std::string str()
+  {
+    const auto n(get<std::uint64_t>());
+    const char *const s(bytes(n));
+    return std::string(s, n);
+  }
+
+  value_t value()
+  {
+    switch (get<std::uint32_t>())
+    {
+    case d_void:    return {};
+    case d_int:     return get<D_INT>();
+    case d_double:  return get<D_DOUBLE>();
+    case d_string:  return str();
+    default:
+      throw exception::data_format("Unknown value type in binary data file");
+    }
+  }
+
+  // The returned pointer refers directly to the memory area.
+  template<class T> const T *array(std::size_t n)
+  {
+    align();
+
+    if (n > static_cast<std::size_t>(end_ - p_) / sizeof(T))
+      throw exception::data_format("Truncated binary data file");
+
+    return reinterpret_cast<const T *>(bytes(n * sizeof(T)));
+  }
+
+  void align() { bytes((8 - (p_ - base_) % 8) % 8); }
+
+private:
+  const char *const base_;
+  const char *p_;
+  const char *const end_;
+};
+
+}  // unnamed namespace
+
+namespace detail
+{
+
+// A read-only private mapping of a file.
+//
+// Memory-mapped files are only used on POSIX systems: elsewhere the file is
+// read in memory.
+class mapped_file
+{
+public:
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
+  explicit mapped_file(const std::filesystem::path &f)
+  {
+    std::ifstream in(f, std::ios_base::binary | std::ios_base::ate);
+    if (!in)
+      throw std::runtime_error("Cannot read binary data file");
+
+    size_ = static_cast<std::size_t>(in.tellg());
+
+    // `double`s are read in place: the buffer must be suitably aligned.
+    buffer_.resize(size_ / sizeof(D_DOUBLE) + 1);
+    if (!in.seekg(0)
+        || !in.read(reinterpret_cast<char *>(buffer_.data()),
+                    static_cast<std::streamsize>(size_)))
+      throw std::runtime_error("Cannot read binary data file");
+  }
+
+  const char *data() const
+  { return reinterpret_cast<const char *>(buffer_.data()); }
+#else
+  explicit mapped_file(const std::filesystem::path &f)
+  {
+    const int fd(::open(f.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd < 0)
+      throw std::runtime_error("Cannot read binary data file");
+
+    struct stat st;
+    if (!::fstat(fd, &st) && st.st_size > 0)
+    {
+      size_ = static_cast<std::size_t>(st.st_size);
+      base_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);  // the mapping stays valid
+
+    if (base_ == MAP_FAILED)
+      throw std::runtime_error("Cannot map binary data file");
+
+    ::madvise(base_, size_, MADV_SEQUENTIAL);
+  }
+
+  ~mapped_file() { ::munmap(base_, size_); }
+
+  const char *data() const { return static_cast<const char *>(base_); }
+#endif
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  std::size_t size() const { return size_; }
+
+private:
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
+  std::vector<D_DOUBLE> buffer_ = {};
+#else
+  void *base_ = MAP_FAILED;
+#endif
+  std::size_t size_ = 0;
+};
+
+}  // namespace detail
+
+///
+/// \param[in] fn a file name
+/// \return       `true` if `fn` is a binary data file (see
+///               `dataframe::write_binary`)
+///
+bool is_binary_dataframe(const std::filesystem::path &fn)
+{
+  std::ifstream in(fn, std::ios_base::binary);
+
+  char magic[sizeof(k_magic)];
+  return in.read(magic, sizeof(magic))
+         && !std::memcmp(magic, k_magic, sizeof(k_magic));
+}
+
+///
+/// Saves the dataframe in a binary format.
+///
+/// \param[in] fn name of the output file
+/// \return       `true` if the file has been correctly written
+///
+/// The file contains the metadata (`columns`, classes) and the examples in
+/// columnar form (see vita::columnar_dataframe): numbers are stored as raw
+/// arrays, strings are dictionary-encoded. Reading the file back (see
+/// `read_binary`) doesn't require any parsing.
+///
+/// Difficulty, age and ID of the examples aren't saved.
+///
+/// \remark
+/// The format is versioned and bound to the byte order of the machine.
+///
+bool dataframe::write_binary(const std::filesystem::path &fn) const
+{
+  std::ofstream out(fn, std::ios_base::binary | std::ios_base::trunc);
+  if (!out)
+    return false;
+
+  const columnar_dataframe cd(*this);
+  writer w(out);
+
+  header h{};
+  std::memcpy(h.magic, k_magic, sizeof(k_magic));
+  h.version = k_version;
+  h.byte_order = k_byte_order;
+  h.rows = size();
+  h.columns = columns.size();
+  h.classes = classes_map_.size();
+  w.put(h);
+
+  for (const auto &c : columns)
+  {
+    w.put(c.name);
+    w.put(static_cast<std::uint32_t>(c.domain));
+
+    w.put(static_cast<std::uint64_t>(c.states.size()));
+    for (const auto &s : c.states)
+      w.put(s);
+  }
+
+  for (const auto &[name, cl] : classes_map_)
+  {
+    w.put(name);
+    w.put(static_cast<std::uint64_t>(cl));
+  }
+
+  if (!empty())
+  {
+    Expects(cd.variables() + 1 == columns.size());
+
+    for (std::size_t j(0); j < columns.size(); ++j)
+    {
+      const auto &col(j ? cd.input(j - 1) : cd.output());
+      w.put(static_cast<std::uint32_t>(col.type()));
+
+      switch (col.type())
+      {
+      case storage::real:
+        w.array(col.reals(), size());
+        break;
+
+      case storage::integer:
+        w.array(col.integers(), size());
+        break;
+
+      case storage::string:
+        w.put(static_cast<std::uint64_t>(col.dictionary().size()));
+        for (const auto &s : col.dictionary())
+          w.put(s);
+        w.array(col.codes(), size());
+        break;
+
+      case storage::generic:
+        for (std::size_t i(0); i < size(); ++i)
+          w.put(col[i]);
+        break;
+
+      case storage::none:
+        break;
+      }
+    }
+  }
+
+  return out.good();
+}
+
+///
+/// Loads a binary data file (see `write_binary`) into the dataframe.
+///
+/// \param[in] fn name of the binary data file
+/// \return       number of examples read
+///
+/// \exception exception::data_format wrong / unsupported data file
+///
+/// The file is memory-mapped and the examples are built directly from the
+/// stored columns. Metadata (`columns`, classes) are replaced with the ones
+/// of the file.
+///
+std::size_t dataframe::read_binary(const std::filesystem::path &fn)
+{
+  const binary_data_file file(fn);
+
+  dataset_.clear();
+  dataset_.reserve(file.size());
+  columns = file.columns();
+  classes_map_ = file.classes();
+
+  for (std::size_t i(0); i < file.size(); ++i)
+    push_back(file[i]);
+
+  if (!debug())
+    throw exception::data_format("Inconsistent binary data file");
+
+  return size();
+}
+
+///
+/// \param[in] i index of an element
+/// \return      the `i`-th value of the column
+///
+value_t binary_data_file::column::operator[](std::size_t i) const
+{
+  switch (type)
+  {
+  case storage::real:
+    if (std::isnan(reals[i]))
+      return {};
+    return reals[i];
+
+  case storage::integer:  return integers[i];
+  case storage::string:   return dictionary[codes[i]];
+  case storage::generic:  return generic[i];
+  default:                return {};
+  }
+}
+
+///
+/// \param[in] first index of the first element
+/// \param[in] last  index one past the last element
+/// \return          the memory area (address and size) of the mapped file
+///                  containing the elements in the `[first, last[` range (an
+///                  empty area for columns not stored in place)
+///
+std::pair<const void *, std::size_t> binary_data_file::column::range(
+  std::size_t first, std::size_t last) const
+{
+  switch (type)
+  {
+  case storage::real:
+    return {reals + first, (last - first) * sizeof(*reals)};
+  case storage::integer:
+    return {integers + first, (last - first) * sizeof(*integers)};
+  case storage::string:
+    return {codes + first, (last - first) * sizeof(*codes)};
+  default:
+    return {nullptr, 0};
+  }
+}
+
+///
+/// Opens a binary data file.
+///
+/// \param[in] fn name of the binary data file
+///
+/// \exception exception::data_format wrong / unsupported data file
+///
+binary_data_file::binary_data_file(const std::filesystem::path &fn)
+  : file_(std::make_unique<detail::mapped_file>(fn)), columns_(), classes_(),
+    data_(), rows_(0)
+{
+  reader r(file_->data(), file_->size());
+
+  const auto h(r.get<header>());
+  if (std::memcmp(h.magic, k_magic, sizeof(k_magic)))
+    throw exception::data_format("Not a binary data file");
+  if (h.version != k_version)
+    throw exception::data_format("Unsupported binary data file version");
+  if (h.byte_order != k_byte_order)
+    throw exception::data_format("Binary data file with wrong byte order");
+
+  for (std::size_t j(0); j < h.columns; ++j)
+  {
+    dataframe::columns_info::column_info c;
+    c.name = r.str();
+    c.domain = static_cast<domain_t>(r.get<std::uint32_t>());
+
+    for (auto n(r.get<std::uint64_t>()); n; --n)
+      c.states.insert(r.value());
+
+    columns_.push_back(c);
+  }
+
+  for (std::size_t i(0); i < h.classes; ++i)
+  {
+    auto name(r.str());
+    classes_[std::move(name)] = r.get<std::uint64_t>();
+  }
+
+  rows_ = h.rows;
+  data_.resize(rows_ ? h.columns : 0);
+  for (auto &col : data_)
+  {
+    col.type = static_cast<storage>(r.get<std::uint32_t>());
+
+    switch (col.type)
+    {
+    case storage::real:
+      col.reals = r.array<D_DOUBLE>(rows_);
+      break;
+
+    case storage::integer:
+      col.integers = r.array<D_INT>(rows_);
+      break;
+
+    case storage::string:
+      for (auto n(r.get<std::uint64_t>()); n; --n)
+        col.dictionary.push_back(r.str());
+      col.codes = r.array<std::uint32_t>(rows_);
+
+      for (std::size_t i(0); i < rows_; ++i)
+        if (col.codes[i] >= col.dictionary.size())
+          throw exception::data_format("Wrong code in binary data file");
+      break;
+
+    case storage::generic:
+      col.generic.reserve(rows_);
+      for (std::size_t i(0); i < rows_; ++i)
+        col.generic.push_back(r.value());
+      break;
+
+    case storage::none:
+      break;
+
+    default:
+      throw exception::data_format("Unknown column type in binary data file");
+    }
+  }
+}
+
+binary_data_file::~binary_data_file() = default;
+
+///
+/// \return number of examples in the file
+///
+std::size_t binary_data_file::size() const
+{
+  return rows_;
+}
+
+///
+/// \return information about the columns of the file (see
+///         `dataframe::columns`)
+///
+const dataframe::columns_info &binary_data_file::columns() const
+{
+  return columns_;
+}
+
+///
+/// \return the encoding of the labels of a classification task
+///
+const std::map<std::string, class_t> &binary_data_file::classes() const
+{
+  return classes_;
+}
+
+///
+/// \param[in] i index of an example
+/// \return      the `i`-th example of the file (difficulty, age and ID are
+///              default initialized)
+///
+dataframe::example binary_data_file::operator[](std::size_t i) const
+{
+  Expects(i < size());
+
+  dataframe::example ret;
+
+  ret.input.reserve(data_.size() - 1);
+  for (std::size_t j(1); j < data_.size(); ++j)
+    ret.input.push_back(data_[j][i]);
+  ret.output = data_.front()[i];
+
+  return ret;
+}
+
+///
+/// \param[in] j index of a column (`0` is the output column)
+/// \return      the values of the `j`-th column, read in place, if they're
+///              `D_DOUBLE`s (`NaN` for the empty value); `nullptr` otherwise
+///
+const D_DOUBLE *binary_data_file::reals(std::size_t j) const
+{
+  Expects(j < data_.size());
+
+  return data_[j].type == columnar_dataframe::column::storage::real
+         ? data_[j].reals : nullptr;
+}
+
+///
+/// Tells the operating system that a range of examples will be accessed
+/// soon.
+///
+/// \param[in] first index of the first example
+/// \param[in] last  index one past the last example
+///
+/// The pages containing the examples are read ahead asynchronously, so
+/// disk access can overlap with computation (nothing to do when the file
+/// isn't memory-mapped).
+///
+void binary_data_file::will_need(std::size_t first, std::size_t last) const
+{
+  Expects(first <= last);
+  Expects(last <= size());
+
+#if !defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)
+
+  static const auto page(
+    static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE)));
+
+  for (const auto &col : data_)
+    if (const auto [p, n] = col.range(first, last); n)
+    {
+      // `madvise` requires a page-aligned address.
+      const auto addr(reinterpret_cast<std::uintptr_t>(p));
+      const auto start(addr - addr % page);
+
+      ::madvise(reinterpret_cast<void *>(start), n + (addr - start),
+                MADV_WILLNEED);
+    }
+#endif
+}
+
+}  // namespace vita
@@ -0,0 +1,87 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_DATAFRAME_BINARY_H)
+#define      VITA_DATAFRAME_BINARY_H
+
+#include <memory>
+
+#include "kernel/src/columnar_dataframe.h"
+
+namespace vita
+{
+
+namespace detail
+{
+class mapped_file;
+}  // namespace detail
+
+///
+/// Read-only access to a binary data file (see `dataframe::write_binary`).
+///
+/// The file is memory-mapped and the numeric / string columns are used in
+/// place: opening a file doesn't load the examples and only the pages
+/// actually accessed are read from disk, so the file can be larger than the
+/// available memory.
+///
+/// \remark
+/// * Columns with mixed types (`storage::generic`) are the exception: they're
+///   decoded when the file is opened.
+/// * Memory-mapped files are only used on POSIX systems: elsewhere the whole
+///   file is read in memory.
+///
+class binary_data_file
+{
+public:
+  explicit binary_data_file(const std::filesystem::path &);
+  ~binary_data_file();
+
+  binary_data_file(const binary_data_file &) = delete;
+  binary_data_file &operator=(const binary_data_file &) = delete;
+
+  std::size_t size() const;
+  const dataframe::columns_info &columns() const;
+  const std::map<std::string, class_t> &classes() const;
+
+  dataframe::example operator[](std::size_t) const;
+  const D_DOUBLE *reals(std::size_t) const;
+
+  void will_need(std::size_t, std::size_t) const;
+
+private:
+  // Values of a column of the file.
+  struct column
+  {
+    value_t operator[](std::size_t) const;
+    std::pair<const void *, std::size_t> range(std::size_t,
+                                               std::size_t) const;
+
+    columnar_dataframe::column::storage type = {};
+
+    const D_DOUBLE      *reals = nullptr;
+    const D_INT      *integers = nullptr;
+    const std::uint32_t *codes = nullptr;
+    std::vector<D_STRING> dictionary = {};
+    std::vector<value_t>     generic = {};
+  };
+
+  std::unique_ptr<detail::mapped_file> file_;
+
+  dataframe::columns_info columns_;
+  std::map<std::string, class_t> classes_;
+  std::vector<column> data_;
+  std::size_t rows_;
+};
+
+}  // namespace vita
+
+#endif  // include guard
@@ -19,9 +19,23 @@ namespace vita
 namespace
 {
 
+std::uintmax_t weight(std::uintmax_t difficulty, std::uintmax_t age)
+{
+  return difficulty + age * age * age;
+}
+
 std::uintmax_t weight(const dataframe::example &v)
 {
-  return v.difficulty + v.age * v.age * v.age;
+  return weight(v.difficulty, v.age);
+}
+
+// Expected size of the training subset extracted from `s` examples.
+double target_size(std::size_t s)
+{
+  const double ratio(std::min(0.6, 0.2 + 100.0 / (s + 100.0)));
+  assert(0.2 <= ratio && ratio <= 0.6);
+
+  return std::max(1.0, s * ratio);
 }
 
 }  // unnamed namespace
@@ -138,11 +152,9 @@ void dss::shake_impl()
   // fact, it averages slightly above `target_size` (Gathercole and Ross felt
   // it might improve performance).
   const auto s(validation_.size());
-  const double ratio(std::min(0.6, 0.2 + 100.0 / (s + 100.0)));
-  assert(0.2 <= ratio && ratio <= 0.6);
-  const double target_size(std::max(1.0, s * ratio));
-  assert(1.0 <= target_size && target_size <= s);
-  const double k(target_size / static_cast<double>(weight_sum));
+  const double target(target_size(s));
+  assert(1.0 <= target && target <= s);
+  const double k(target / static_cast<double>(weight_sum));
 
   auto pivot(
     std::partition(validation_.begin(), validation_.end(),
@@ -156,7 +168,7 @@ void dss::shake_impl()
 
   if (pivot == validation_.begin() || pivot == validation_.end())
     pivot = std::next(validation_.begin(),
-                      static_cast<std::ptrdiff_t>(target_size));
+                      static_cast<std::ptrdiff_t>(target));
 
   assert(validation_.size() == s);
   std::move(pivot, validation_.end(), std::back_inserter(training_));
@@ -211,4 +223,191 @@ void dss::close(unsigned)
   clear_evaluators();
 }
 
+///
+/// Sets up a DSS validator working on a disk-resident dataset.
+///
+/// \param[in] prob   current problem
+/// \param[in] source the available examples
+/// \param[in] eva_t  active training evaluator
+/// \param[in] eva_v  active validation evaluator
+///
+/// The training / validation sets of `prob` are replaced by examples of
+/// `source` (see init()).
+///
+chunked_dss::chunked_dss(src_problem &prob, const chunked_dataframe &source,
+                         cached_evaluator &eva_t, cached_evaluator &eva_v)
+  : source_(source), state_(),
+    training_(prob.data(dataset_t::training)),
+    validation_(prob.data(dataset_t::validation)),
+    eva_t_(eva_t), eva_v_(eva_v),
+    env_(prob.env)
+{
+}
+
+void chunked_dss::clear_evaluators()
+{
+  eva_t_.clear();
+  eva_v_.clear();
+}
+
+// Copies the difficulty of the examples of `d` (loaded from `source_`) in the
+// state of the corresponding rows.
+void chunked_dss::save_difficulty(const dataframe &d)
+{
+  for (const auto &e : d)
+    state_[source_.row(e.id)].difficulty = e.difficulty;
+}
+
+// Loads the examples of the given `rows` with their age and
+// difficulty.
+void chunked_dss::load(const std::vector<std::size_t> &rows,
+                       dataframe &d) const
+{
+  source_.load(rows, d);
+
+  auto r(rows.begin());
+  for (auto &e : d)
+  {
+    e.difficulty = state_[*r].difficulty;
+    e.age        = state_[*r].age;
+    ++r;
+  }
+}
+
+// Loads in the validation set a uniform sample (at most one chunk) of the
+// rows not `excluded` (selection sampling technique, see Knuth's TAOCP vol.
+// 2, algorithm S).
+void chunked_dss::load_validation(const std::vector<bool> &excluded)
+{
+  auto available(static_cast<std::size_t>(
+                   std::count(excluded.begin(), excluded.end(), false)));
+  auto needed(std::min(available, source_.chunk_size()));
+
+  std::vector<std::size_t> rows;
+  rows.reserve(needed);
+
+  for (std::size_t r(0); needed && r < excluded.size(); ++r)
+    if (!excluded[r])
+    {
+      if (random::between<std::size_t>(0, available) < needed)
+      {
+        rows.push_back(r);
+        --needed;
+      }
+
+      --available;
+    }
+
+  load(rows, validation_);
+}
+
+///
+/// Selects the initial training / validation sets.
+///
+/// \param[in] run current run
+///
+/// \attention The procedure changes the current training / validation sets.
+///
+void chunked_dss::init(unsigned)
+{
+  Expects(env_.dss.value_or(0) > 0);
+
+  state_.assign(source_.size(), state());
+
+  shake_impl();
+  clear_evaluators();
+}
+
+void chunked_dss::shake_impl()
+{
+  const auto s(state_.size());
+  Expects(s >= 2);
+
+  const auto weight_sum(
+    std::accumulate(state_.begin(), state_.end(), std::uintmax_t(0),
+                    [](std::uintmax_t sum, const state &x)
+                    {
+                      return sum + weight(x.difficulty, x.age);
+                    }));
+  assert(weight_sum);
+
+  // Same selection scheme of `dss::shake_impl` but the training set must fit
+  // in memory: its expected size is limited to one chunk.
+  const double target(std::min(target_size(s),
+                                static_cast<double>(source_.chunk_size())));
+  const double k(target / static_cast<double>(weight_sum));
+
+  // Rows are scanned in order: the selected examples are loaded with a
+  // (mostly) sequential disk access.
+  std::vector<bool> selected(s, false);
+  std::vector<std::size_t> rows;
+  for (std::size_t r(0); r < s; ++r)
+  {
+    const auto w(weight(state_[r].difficulty, state_[r].age));
+
+    if (random::boolean(std::min(static_cast<double>(w) * k, 1.0)))
+    {
+      selected[r] = true;
+      rows.push_back(r);
+    }
+  }
+
+  if (rows.empty() || rows.size() == s)
+  {
+    rows.resize(static_cast<std::size_t>(target));
+    std::iota(rows.begin(), rows.end(), 0);
+
+    selected.assign(s, false);
+    for (const auto r : rows)
+      selected[r] = true;
+  }
+
+  for (const auto r : rows)
+    state_[r] = state();
+
+  load(rows, training_);
+  load_validation(selected);
+
+  vitaDEBUG << "DSS SHAKE (weight sum: " << weight_sum << ", training with: "
+            << training_.size() << ", validating with: " << validation_.size()
+            << ')';
+
+  Ensures(!training_.empty());
+  Ensures(!validation_.empty());
+}
+
+bool chunked_dss::shake(unsigned generation)
+{
+  Expects(env_.dss.value_or(0) > 0);
+
+  if (generation == 0        // already handled by init()
+      || generation % *env_.dss)
+    return false;
+
+  vitaDEBUG << "DSS shaking generation " << generation;
+
+  save_difficulty(training_);
+  save_difficulty(validation_);
+
+  for (auto &x : state_)
+    ++x.age;
+
+  shake_impl();
+  clear_evaluators();
+
+  return true;
+}
+
+///
+/// Clears the training set and fills the validation set with a uniform
+/// sample (at most one chunk) of the available examples.
+///
+void chunked_dss::close(unsigned)
+{
+  training_.clear();
+  load_validation(std::vector<bool>(state_.size(), false));
+
+  clear_evaluators();
+}
+
 }  // namespace vita
@@ -15,6 +15,7 @@
 
 #include "kernel/evaluator.h"
 #include "kernel/validation_strategy.h"
+#include "kernel/src/chunked_dataframe.h"
 #include "kernel/src/problem.h"
 
 namespace vita
@@ -43,6 +44,9 @@ public:
   bool shake(unsigned) override;
   void close(unsigned) override;
 
+  /// The training set changes every few generations.
+  bool concurrent() const override { return false; }
+
 private:
   std::pair<std::uintmax_t, std::uintmax_t> average_age_difficulty(
    dataframe &) const;
@@ -59,6 +63,59 @@ private:
   const environment &env_;
 };
 
+///
+/// Dynamic training Subset Selection for datasets larger than the available
+/// memory.
+///
+/// Like vita::dss but the examples are drawn from a disk-resident dataset
+/// (see vita::chunked_dataframe). Age and difficulty of every example are
+/// kept in memory (a couple of integers per example), the examples are
+/// loaded (with their age and difficulty) only when selected:
+/// - the training set is a weighted subset of (at most about) one chunk of
+///   examples;
+/// - the validation set is a uniform sample of (at most) one chunk of
+///   examples not used for training.
+///
+/// \remark
+/// Loaded examples keep their ID: programs evaluated before a shake reuse
+/// the outputs of the examples still present (see vita::output_store).
+///
+class chunked_dss : public validation_strategy
+{
+public:
+  chunked_dss(src_problem &, const chunked_dataframe &, cached_evaluator &,
+              cached_evaluator &);
+
+  void init(unsigned) override;
+  bool shake(unsigned) override;
+  void close(unsigned) override;
+
+  /// The training set changes every few generations.
+  bool concurrent() const override { return false; }
+
+private:
+  struct state
+  {
+    std::uintmax_t difficulty = 0;
+    std::uintmax_t age = 1;
+  };
+
+  void clear_evaluators();
+  void load(const std::vector<std::size_t> &, dataframe &) const;
+  void load_validation(const std::vector<bool> &);
+  void save_difficulty(const dataframe &);
+  void shake_impl();
+
+  chunked_dataframe source_;
+  std::vector<state> state_;  // `state_[r]` refers to the `r`-th row
+
+  dataframe &training_;
+  dataframe &validation_;
+  cached_evaluator &eva_t_;
+  cached_evaluator &eva_v_;
+  const environment &env_;
+};
+
 }  // namespace vita
 
 #endif  // include guard
@@ -13,7 +13,15 @@
 #if !defined(VITA_SRC_EVALUATOR_H)
 #define      VITA_SRC_EVALUATOR_H
 
+#include <cmath>
+#include <numeric>
+
+#include "kernel/column_store.h"
 #include "kernel/evaluator.h"
+#include "kernel/src/chunked_dataframe.h"
+#include "kernel/src/columnar_dataframe.h"
+#include "kernel/src/output_store.h"
+#include "utility/thread_pool.h"
 
 namespace vita
 {
@@ -32,8 +40,27 @@ class src_evaluator : public evaluator<T>
 public:
   explicit src_evaluator(dataframe &);
 
+  void threads(unsigned);
+
 protected:
+  using block = std::pair<dataframe::iterator, dataframe::iterator>;
+
+  std::vector<block> blocks() const;
+  unsigned workers() const;
+  template<class F> void parallel(std::size_t, F);
+  template<class It> void outputs(const T &, It, It,
+                                  std::vector<value_t> *);
+
+  // Number of examples evaluated together (columnar evaluation / unit of
+  // work of a thread). It bounds the memory used by the interpreter.
+  static constexpr std::size_t k_block = 256;
+
   class dataframe *dat_;
+
+private:
+  // Threads used for the evaluation of a program (`nullptr` for a
+  // single-threaded evaluation).
+  std::shared_ptr<thread_pool> pool_;
 };
 
 ///
@@ -48,15 +75,49 @@ template<class T>
 class sum_of_errors_evaluator : public src_evaluator<T>
 {
 public:
-  explicit sum_of_errors_evaluator(dataframe &d) : src_evaluator<T>(d) {}
+  sum_of_errors_evaluator(dataframe &, std::size_t = 0, std::size_t = 0);
+
+  /// Sum of the errors of a program over a sequence of datasets.
+  struct error_sum
+  {
+    double err = 0.0;
+    std::size_t examples = 0;
+
+    // Illegal values found so far (the penalty grows with their number).
+    int illegals = 0;
+  };
+
+  void errors(const std::vector<const T *> &, std::vector<error_sum> *);
+  std::vector<std::size_t> errors(const std::vector<const T *> &,
+                                  const std::vector<const D_DOUBLE *> &,
+                                  const D_DOUBLE *, std::size_t,
+                                  std::vector<error_sum> *);
 
   fitness_t operator()(const T &) override;
   fitness_t fast(const T &) override;
+  fitness_t race(const T &, const fitness_t &, bool *) override;
+  std::vector<fitness_t> batch(const std::vector<const T *> &) override;
   std::unique_ptr<basic_lambda_f> lambdify(const T &) const override;
+  std::string info() const override;
+
+  void clear() override;
 
 private:
-  virtual double error(const basic_reg_lambda_f<T, false> &,
-                       dataframe::example &, int *) = 0;
+  virtual double error(const value_t &, dataframe::example &, int *) = 0;
+
+  fitness_t evaluate(const T &, const fitness_t *, bool *);
+
+  bool incremental(const T &, std::vector<value_t> *);
+  bool memoized(const T &, std::vector<value_t> *, bool);
+
+  // Gene outputs used for the incremental evaluation of the offspring (see
+  // vita::column_store). `nullptr` when the incremental evaluation is
+  // disabled.
+  std::unique_ptr<column_store> store_;
+
+  // Program outputs surviving the changes of the training set (see
+  // vita::output_store). `nullptr` when disabled.
+  std::unique_ptr<output_store> outputs_;
 };
 
 ///
@@ -80,11 +141,11 @@ template<class T>
 class mae_evaluator : public sum_of_errors_evaluator<T>
 {
 public:
-  explicit mae_evaluator(dataframe &d) : sum_of_errors_evaluator<T>(d) {}
+  explicit mae_evaluator(dataframe &d, std::size_t cs = 0, std::size_t os = 0)
+    : sum_of_errors_evaluator<T>(d, cs, os) {}
 
 private:
-  double error(const basic_reg_lambda_f<T, false> &, dataframe::example &,
-               int *) override;
+  double error(const value_t &, dataframe::example &, int *) override;
 };
 
 ///
@@ -110,11 +171,11 @@ template<class T>
 class rmae_evaluator : public sum_of_errors_evaluator<T>
 {
 public:
-  explicit rmae_evaluator(dataframe &d) : sum_of_errors_evaluator<T>(d) {}
+  explicit rmae_evaluator(dataframe &d, std::size_t cs = 0, std::size_t os = 0)
+    : sum_of_errors_evaluator<T>(d, cs, os) {}
 
 private:
-  double error(const basic_reg_lambda_f<T, false> &, dataframe::example &,
-               int *) override;
+  double error(const value_t &, dataframe::example &, int *) override;
 };
 
 ///
@@ -139,11 +200,11 @@ template<class T>
 class mse_evaluator : public sum_of_errors_evaluator<T>
 {
 public:
-  explicit mse_evaluator(dataframe &d) : sum_of_errors_evaluator<T>(d) {}
+  explicit mse_evaluator(dataframe &d, std::size_t cs = 0, std::size_t os = 0)
+    : sum_of_errors_evaluator<T>(d, cs, os) {}
 
 private:
-  double error(const basic_reg_lambda_f<T, false> &, dataframe::example &,
-               int *) override;
+  double error(const value_t &, dataframe::example &, int *) override;
 };
 
 ///
@@ -157,11 +218,65 @@ template<class T>
 class count_evaluator : public sum_of_errors_evaluator<T>
 {
 public:
-  explicit count_evaluator(dataframe &d) : sum_of_errors_evaluator<T>(d) {}
+  explicit count_evaluator(dataframe &d, std::size_t cs = 0, std::size_t os = 0)
+    : sum_of_errors_evaluator<T>(d, cs, os) {}
 
 private:
-  double error(const basic_reg_lambda_f<T, false> &, dataframe::example &,
-               int *) override;
+  double error(const value_t &, dataframe::example &, int *) override;
+};
+
+///
+/// An evaluator for datasets larger than the available memory.
+///
+/// \tparam T type of individual
+/// \tparam E evaluator used for a single chunk (a sum_of_errors_evaluator,
+///           e.g. `mse_evaluator<T>`)
+///
+/// The dataset (see vita::chunked_dataframe) is evaluated a chunk at a time
+/// and the raw errors (with the count of the illegal values) are accumulated
+/// chunk by chunk: the fitness is the same of an `E` evaluator working on the
+/// whole (in memory) dataset. The next chunk is read while the current one
+/// is being evaluated.
+///
+/// When every column of the data file contains `D_DOUBLE`s, the real-valued
+/// programs (see src_interpreter::real_valued) are executed directly on the
+/// (memory-mapped) columns of the file. Examples are built only for the
+/// other programs / data files.
+///
+/// \remark
+/// * Every evaluation is a complete pass over the dataset: batch() evaluates
+///   all the programs on a chunk before moving to the next one, so programs
+///   evaluated together share the disk access. The incremental evaluation and
+///   the output store of `E` aren't used.
+/// * fast() only uses the first chunk, which is kept in memory (it's reloaded
+///   after a clear()).
+///
+template<class T, class E>
+class chunked_evaluator : public evaluator<T>
+{
+public:
+  static_assert(std::is_base_of_v<sum_of_errors_evaluator<T>, E>);
+
+  explicit chunked_evaluator(const chunked_dataframe &);
+
+  void threads(unsigned);
+
+  fitness_t operator()(const T &) override;
+  fitness_t fast(const T &) override;
+  std::vector<fitness_t> batch(const std::vector<const T *> &) override;
+  std::unique_ptr<basic_lambda_f> lambdify(const T &) const override;
+
+  void clear() override;
+
+private:
+  chunked_dataframe data_;
+
+  // The chunk currently evaluated. Between two evaluations it holds the first
+  // chunk (used by fast()) or nothing, if it hasn't been loaded yet.
+  dataframe chunk_;
+
+  // Evaluator working on `chunk_`.
+  E eva_;
 };
 
 ///
@@ -173,6 +288,9 @@ class classification_evaluator : public src_evaluator<T>
 {
 public:
   explicit classification_evaluator(dataframe &d) : src_evaluator<T>(d) {}
+
+protected:
+  template<class L> std::vector<classification_result> tag(const L &);
 };
 
 ///
@@ -21,21 +21,645 @@
 /// \param[in] d dataset that the evaluator will use
 ///
 template<class T>
-src_evaluator<T>::src_evaluator(dataframe &d) : dat_(&d)
+src_evaluator<T>::src_evaluator(dataframe &d) : dat_(&d), pool_()
 {
 }
 
+///
+/// Sets the number of threads used for the evaluation of a program.
+///
+/// \param[in] n number of threads (`0` is the number of concurrent threads
+///              supported by the hardware)
+///
+/// The examples of the dataset are split among the threads. Results don't
+/// depend on the number of threads.
+///
+template<class T>
+void src_evaluator<T>::threads(unsigned n)
+{
+  if (n == 1)
+    pool_.reset();
+  else
+    pool_ = std::make_shared<thread_pool>(n);
+}
+
+///
+/// \return number of threads used for the evaluation of a program
+///
+template<class T>
+unsigned src_evaluator<T>::workers() const
+{
+  return pool_ ? pool_->size() : 1;
+}
+
+///
+/// \return the active dataset split in blocks of (at most) `k_block`
+///         consecutive examples
+///
+template<class T>
+std::vector<typename src_evaluator<T>::block> src_evaluator<T>::blocks() const
+{
+  std::vector<block> ret;
+
+  for (auto first(dat_->begin()), last(dat_->end()); first != last;)
+  {
+    const auto n(std::min<std::size_t>(k_block,
+                                       std::distance(first, last)));
+    const auto block_end(std::next(first, n));
+
+    ret.emplace_back(first, block_end);
+    first = block_end;
+  }
+
+  return ret;
+}
+
+///
+/// Executes `n` independent tasks (in parallel if more threads are
+/// available).
+///
+/// \param[in] n number of tasks
+/// \param[in] f function executing a task: `f(i, w)` executes the `i`-th
+///              task on the `w`-th worker (`w < workers()`)
+///
+/// Every task has its own random stream, derived from (but not advancing)
+/// the engine of the calling thread: a stochastic task gives the same
+/// results whatever thread runs it.
+///
+template<class T>
+template<class F>
+void src_evaluator<T>::parallel(std::size_t n, F f)
+{
+  if (pool_)
+  {
+    // The calling thread is a worker too: its engine must be preserved.
+    const auto caller(random::engine);
+    auto derived(caller);
+    const auto seed(derived());
+
+    pool_->run(n, [&](std::size_t i, unsigned w)
+                  {
+                    random::engine.seed(seed + i);
+                    f(i, w);
+                  });
+
+    random::engine = caller;
+  }
+  else
+    for (std::size_t i(0); i < n; ++i)
+      f(i, 0);
+}
+
+///
+/// \param[in]  prg   a program
+/// \param[in]  first beginning of a range of examples
+/// \param[in]  last  end of a range of examples
+/// \param[out] out   output values (`(*out)[i]` is the output for the `i`-th
+///                   example of the range)
+///
+/// The examples are evaluated in blocks (every worker has its own agent and
+/// evaluates a block at a time).
+///
+template<class T>
+template<class It>
+void src_evaluator<T>::outputs(const T &prg, It first, It last,
+                               std::vector<value_t> *out)
+{
+  std::vector<std::pair<It, It>> blocks;
+  while (first != last)
+  {
+    const auto n(std::min<std::ptrdiff_t>(this->k_block,
+                                          std::distance(first, last)));
+    blocks.emplace_back(first, std::next(first, n));
+    first = blocks.back().second;
+  }
+
+  // Any worker can run a task: every worker needs its own agent.
+  const std::size_t workers(this->workers());
+
+  std::vector<basic_reg_lambda_f<T, false>> agents;
+  agents.reserve(workers);
+  for (std::size_t w(0); w < workers; ++w)
+    agents.emplace_back(prg);
+
+  std::vector<std::vector<value_t>> outs(blocks.size());
+  this->parallel(blocks.size(), [&](std::size_t i, unsigned w)
+                 {
+                   agents[w](blocks[i].first, blocks[i].second, &outs[i]);
+                 });
+
+  out->clear();
+  for (const auto &o : outs)
+    out->insert(out->end(), o.begin(), o.end());
+}
+
+///
+/// \param[in] d  dataset that the evaluator will use
+/// \param[in] cs memory budget (in bytes) for the incremental evaluation of
+///               the offspring. `0` disables the incremental evaluation
+/// \param[in] os memory budget (in bytes) for the outputs of the recently
+///               evaluated programs. `0` disables the store
+///
+/// \see vita::column_store, vita::output_store
+///
+template<class T>
+sum_of_errors_evaluator<T>::sum_of_errors_evaluator(dataframe &d,
+                                                    std::size_t cs,
+                                                    std::size_t os)
+  : src_evaluator<T>(d),
+    store_(cs ? std::make_unique<column_store>(cs) : nullptr),
+    outputs_(os ? std::make_unique<output_store>(os) : nullptr)
+{
+}
+
+///
+/// Drops the stored gene outputs (they're tied to the current dataset).
+///
+/// \remark
+/// The program outputs of the output store survive: they're linked to the
+/// single examples, not to the dataset.
+///
+template<class T>
+void sum_of_errors_evaluator<T>::clear()
+{
+  if (store_)
+    store_->clear();
+}
+
+///
+/// \return hits / misses of the subtree output cache and reused / computed
+///         outputs of the output store (empty string if both are disabled)
+///
+/// \see vita::column_store, vita::output_store
+///
+template<class T>
+std::string sum_of_errors_evaluator<T>::info() const
+{
+  std::string ret;
+
+  if (store_)
+  {
+    const auto hits(store_->hits());
+    const auto probes(hits + store_->misses());
+
+    ret =
+      "subtree hits " + std::to_string(hits) +
+      ", misses " + std::to_string(store_->misses()) +
+      (probes ? " (ratio " + std::to_string(hits * 100 / probes) + "%)" : "");
+  }
+
+  if (outputs_)
+  {
+    const auto reused(outputs_->reused());
+    const auto total(reused + outputs_->computed());
+
+    ret +=
+      (ret.empty() ? "" : "; ") +
+      std::string("outputs reused ") + std::to_string(reused) +
+      ", computed " + std::to_string(outputs_->computed()) +
+      (total ? " (ratio " + std::to_string(reused * 100 / total) + "%)" : "");
+  }
+
+  return ret;
+}
+
+///
+/// Evaluates `prg` reusing, where possible, the gene outputs of its parent.
+///
+/// \param[in]  prg program used for fitness evaluation
+/// \param[out] out output values (one for each example of the dataset)
+/// \return         `true` if the incremental evaluation has been performed
+///
+/// \remark
+/// Only individuals whose active code works on `double`s can be evaluated
+/// incrementally. Examples are evaluated in blocks of `k_block` elements.
+///
+template<class T>
+bool sum_of_errors_evaluator<T>::incremental(const T &prg,
+                                             std::vector<value_t> *out)
+{
+  if constexpr (std::is_same_v<T, i_mep>)
+  {
+    if (!store_)
+      return false;
+
+    src_interpreter<T> intr(&prg);
+    return intr.run(this->dat_->begin(), this->dat_->end(), out, *store_,
+                    this->k_block);
+  }
+  else
+  {
+    (void)prg;
+    (void)out;
+    return false;
+  }
+}
+
+///
+/// Calculates the outputs of `prg` reusing the ones calculated by previous
+/// evaluations (possibly on a different training set).
+///
+/// \param[in]  prg    program used for fitness evaluation
+/// \param[out] out    output values (one for each example of the dataset)
+/// \param[in]  create if `false` only programs already present in the store
+///                    are evaluated
+/// \return            `true` if the outputs have been calculated
+///
+/// Only the examples never seen by `prg` are evaluated. Outputs are then
+/// stored for subsequent evaluations: after a change of the training set
+/// (e.g. a DSS shake) the fitness of a known program is rebuilt cheaply and
+/// it's identical to the one of a complete evaluation.
+///
+/// \see vita::output_store
+///
+template<class T>
+bool sum_of_errors_evaluator<T>::memoized(const T &prg,
+                                          std::vector<value_t> *out,
+                                          bool create)
+{
+  if (!outputs_)
+    return false;
+
+  const auto sig(prg.signature());
+  const auto prev(outputs_->find(sig));
+  if (!prev && !create)
+    return false;
+
+  const auto &cols(outputs_->columns(*this->dat_));
+  const auto n(cols.size());
+
+  program_outputs po(prev ? *prev : program_outputs());
+  po.values.resize(outputs_->width());
+  po.known.resize(outputs_->width(), false);
+
+  std::vector<std::size_t> missing;
+  for (std::size_t i(0); i < n; ++i)
+    if (!po.known[cols[i]])
+      missing.push_back(i);
+
+  std::vector<value_t> computed;
+  if (missing.size() == n)
+    this->outputs(prg, this->dat_->begin(), this->dat_->end(), &computed);
+  else if (!missing.empty())
+  {
+    dataframe::examples_t subset;
+    subset.reserve(missing.size());
+    for (const auto i : missing)
+      subset.push_back(*std::next(this->dat_->begin(), i));
+
+    this->outputs(prg, subset.begin(), subset.end(), &computed);
+  }
+  assert(computed.size() == missing.size());
+
+  // Only `double` outputs can be stored.
+  bool storable(true);
+
+  out->resize(n);
+  for (std::size_t i(0), j(0); i < n; ++i)
+    if (j < missing.size() && missing[j] == i)
+    {
+      const auto &v(computed[j++]);
+
+      if (std::holds_alternative<D_DOUBLE>(v))
+        po.values[cols[i]] = std::get<D_DOUBLE>(v);
+      else if (!has_value(v))
+        po.values[cols[i]] = std::numeric_limits<D_DOUBLE>::quiet_NaN();
+      else
+        storable = false;
+
+      po.known[cols[i]] = true;
+      (*out)[i] = v;
+    }
+    else if (const auto v = po.values[cols[i]]; std::isnan(v))
+      (*out)[i] = value_t();
+    else
+      (*out)[i] = v;
+
+  outputs_->count(n - missing.size(), missing.size());
+  if (storable && !missing.empty())
+    outputs_->insert(sig, std::move(po));
+
+  return true;
+}
+
 ///
 /// \param[in] prg program (individual/team) used for fitness evaluation
 /// \return        the fitness (greater is better, max is `0`)
 ///
 template<class T>
 fitness_t sum_of_errors_evaluator<T>::operator()(const T &prg)
+{
+  return evaluate(prg, nullptr, nullptr);
+}
+
+///
+/// Adds the errors of some programs over a dataset stored by columns to a
+/// running sum.
+///
+/// \param[in]     prgs   programs (individuals/teams) to be evaluated
+/// \param[in]     vars   `vars[v]` is the column (`n` elements, `NaN` for the
+///                       empty value) of the `v`-th variable
+/// \param[in]     labels column of the expected outputs (`n` elements)
+/// \param[in]     n      number of examples
+/// \param[in,out] sums   `(*sums)[i]` is the running sum of `*prgs[i]`
+/// \return               indices of the programs that cannot be evaluated
+///                       on the columns (they aren't real-valued). Their
+///                       running sums aren't changed
+///
+/// Same as `errors(const std::vector<const T *> &, std::vector<error_sum> *)`
+/// but the examples aren't built: the real-valued programs read the columns
+/// in place (e.g. from a memory-mapped vita::binary_data_file). The active
+/// dataset isn't used.
+///
+template<class T>
+std::vector<std::size_t> sum_of_errors_evaluator<T>::errors(
+  const std::vector<const T *> &prgs, const std::vector<const D_DOUBLE *> &vars,
+  const D_DOUBLE *labels, std::size_t n, std::vector<error_sum> *sums)
+{
+  Expects(labels);
+  Expects(n);
+  Expects(sums);
+  Expects(sums->size() == prgs.size());
+
+  const auto blocks((n + this->k_block - 1) / this->k_block);
+
+  const auto run([&](const basic_reg_lambda_f<T, false> &agent,
+                     std::size_t b, std::vector<value_t> *out)
+  {
+    const auto first(b * this->k_block);
+
+    auto cols(vars);
+    for (auto &c : cols)
+      c += first;
+
+    return agent(cols, std::min(this->k_block, n - first), out);
+  });
+
+  const auto accumulate([&](const std::vector<value_t> &out, error_sum *s)
+  {
+    assert(out.size() == n);
+
+    dataframe::example t;
+    for (std::size_t i(0); i < n; ++i)
+    {
+      t.output = std::isnan(labels[i]) ? value_t() : value_t(labels[i]);
+      s->err += error(out[i], t, &s->illegals);
+    }
+
+    s->examples += n;
+  });
+
+  std::vector<std::size_t> skipped;
+  const std::size_t workers(this->workers());
+
+  if (prgs.size() < 2)
+  {
+    for (std::size_t p(0); p < prgs.size(); ++p)
+    {
+      std::vector<basic_reg_lambda_f<T, false>> agents;
+      agents.reserve(workers);
+      for (std::size_t w(0); w < workers; ++w)
+        agents.emplace_back(*prgs[p]);
+
+      std::vector<std::vector<value_t>> outs(blocks);
+      std::vector<char> done(blocks);
+      this->parallel(blocks, [&](std::size_t i, unsigned w)
+                     {
+                       done[i] = run(agents[w], i, &outs[i]);
+                     });
+
+      if (std::find(done.begin(), done.end(), false) != done.end())
+      {
+        skipped.push_back(p);
+        continue;
+      }
+
+      std::vector<value_t> out;
+      out.reserve(n);
+      for (const auto &o : outs)
+        out.insert(out.end(), o.begin(), o.end());
+
+      accumulate(out, &(*sums)[p]);
+    }
+
+    return skipped;
+  }
+
+  // A wave contains (at most) a program for each worker.
+  std::vector<std::vector<value_t>> outs(std::min(workers, prgs.size()));
+  std::vector<char> done(outs.size());
+  for (std::size_t p(0); p < prgs.size(); p += outs.size())
+  {
+    const auto wave(std::min(outs.size(), prgs.size() - p));
+
+    this->parallel(wave, [&](std::size_t i, unsigned)
+                   {
+                     const basic_reg_lambda_f<T, false> agent(*prgs[p + i]);
+
+                     outs[i].clear();
+                     done[i] = true;
+                     std::vector<value_t> out;
+                     for (std::size_t b(0); done[i] && b < blocks; ++b)
+                     {
+                       done[i] = run(agent, b, &out);
+                       outs[i].insert(outs[i].end(), out.begin(), out.end());
+                     }
+                   });
+
+    for (std::size_t i(0); i < wave; ++i)
+      if (done[i])
+        accumulate(outs[i], &(*sums)[p + i]);
+      else
+        skipped.push_back(p + i);
+  }
+
+  return skipped;
+}
+
+///
+/// \param[in]  prg     program (individual/team) used for fitness evaluation
+/// \param[in]  bound   fitness `prg` must beat
+/// \param[out] partial `true` if the evaluation has been stopped early
+/// \return             the fitness (greater is better, max is `0`) or an
+///                     upper bound of it (when `*partial` is `true`)
+///
+/// Errors are non-negative, so the partial sum of the errors gives an upper
+/// bound of the fitness: the evaluation stops at the end of the first block
+/// of examples (group of blocks when multithreading) proving that `prg`
+/// cannot beat `bound`.
+///
+/// \remark
+/// The difficulty of the examples after the stopping point isn't updated:
+/// racing shouldn't be used with the DSS algorithm (see `tournament::run`).
+///
+/// \see evaluator::race
+///
+template<class T>
+fitness_t sum_of_errors_evaluator<T>::race(const T &prg,
+                                           const fitness_t &bound,
+                                           bool *partial)
+{
+  Expects(bound.size() == 1);
+  Expects(partial);
+
+  return evaluate(prg, &bound, partial);
+}
+
+///
+/// \param[in] prgs programs (individuals/teams) used for fitness evaluation
+/// \return         `r[i]` is the fitness of `*prgs[i]`
+///
+/// With many threads, every worker evaluates a whole program (better than
+/// splitting the examples of a single program among the threads). Errors are
+/// accumulated, and the difficulty of the examples updated, on the calling
+/// thread in the order of `prgs`: results are the same of operator().
+///
+/// \remark
+/// The incremental evaluation and the output store aren't thread-safe: when
+/// enabled programs are evaluated one at a time.
+///
+/// \see evaluator::batch
+///
+template<class T>
+std::vector<fitness_t> sum_of_errors_evaluator<T>::batch(
+  const std::vector<const T *> &prgs)
 {
   Expects(!this->dat_->classes());
   Expects(this->dat_->begin() != this->dat_->end());
 
-  const basic_reg_lambda_f<T, false> agent(prg);
+  const std::size_t workers(this->workers());
+  if (workers == 1 || store_ || outputs_ || prgs.size() < 2)
+    return evaluator<T>::batch(prgs);
+
+  std::vector<error_sum> sums(prgs.size());
+  errors(prgs, &sums);
+
+  std::vector<fitness_t> ret;
+  ret.reserve(sums.size());
+  for (const auto &s : sums)
+    ret.push_back({-s.err / s.examples});
+
+  return ret;
+}
+
+///
+/// Adds the errors of some programs over the active dataset to a running sum.
+///
+/// \param[in]     prgs programs (individuals/teams) to be evaluated
+/// \param[in,out] sums `(*sums)[i]` is the running sum of `*prgs[i]`
+///
+/// The running sums allow to evaluate a program over a sequence of datasets
+/// (e.g. the chunks of a vita::chunked_dataframe): the penalty for illegal
+/// values continues from the previous datasets and the final fitness
+/// (`-err / examples`) is the same of an evaluation over the whole sequence.
+///
+/// With many programs, every worker evaluates a whole program. A single
+/// program has its blocks of examples split among the workers. Errors are
+/// accumulated on the calling thread in the order of `prgs`.
+///
+/// \remark
+/// The incremental evaluation and the output store aren't used.
+///
+template<class T>
+void sum_of_errors_evaluator<T>::errors(const std::vector<const T *> &prgs,
+                                        std::vector<error_sum> *sums)
+{
+  Expects(!this->dat_->classes());
+  Expects(this->dat_->begin() != this->dat_->end());
+  Expects(sums);
+  Expects(sums->size() == prgs.size());
+
+  const auto blocks(this->blocks());
+  const auto cols(this->dat_->real_columns());
+  const auto begin(this->dat_->begin());
+
+  const auto run([&](const basic_reg_lambda_f<T, false> &agent,
+                     const typename src_evaluator<T>::block &b,
+                     std::vector<value_t> *out)
+  {
+    if (!cols
+        || !agent(*cols, std::distance(begin, b.first),
+                  std::distance(begin, b.second), out))
+      agent(b.first, b.second, out);
+  });
+
+  const auto accumulate([&](const std::vector<value_t> &out, error_sum *s)
+  {
+    auto example(this->dat_->begin());
+    for (const auto &o : out)
+      s->err += error(o, *example++, &s->illegals);
+
+    assert(example == this->dat_->end());
+    s->examples += out.size();
+  });
+
+  const std::size_t workers(this->workers());
+
+  if (prgs.size() < 2)
+  {
+    for (std::size_t p(0); p < prgs.size(); ++p)
+    {
+      std::vector<basic_reg_lambda_f<T, false>> agents;
+      agents.reserve(workers);
+      for (std::size_t w(0); w < workers; ++w)
+        agents.emplace_back(*prgs[p]);
+
+      std::vector<std::vector<value_t>> outs(blocks.size());
+      this->parallel(blocks.size(), [&](std::size_t i, unsigned w)
+                     {
+                       run(agents[w], blocks[i], &outs[i]);
+                     });
+
+      std::vector<value_t> out;
+      for (const auto &o : outs)
+        out.insert(out.end(), o.begin(), o.end());
+
+      accumulate(out, &(*sums)[p]);
+    }
+
+    return;
+  }
+
+  // A wave contains (at most) a program for each worker.
+  std::vector<std::vector<value_t>> outs(std::min(workers, prgs.size()));
+  for (std::size_t p(0); p < prgs.size(); p += outs.size())
+  {
+    const auto wave(std::min(outs.size(), prgs.size() - p));
+
+    this->parallel(wave, [&](std::size_t i, unsigned)
+                   {
+                     const basic_reg_lambda_f<T, false> agent(*prgs[p + i]);
+
+                     outs[i].clear();
+                     std::vector<value_t> out;
+                     for (const auto &b : blocks)
+                     {
+                       run(agent, b, &out);
+                       outs[i].insert(outs[i].end(), out.begin(), out.end());
+                     }
+                   });
+
+    for (std::size_t i(0); i < wave; ++i)
+      accumulate(outs[i], &(*sums)[p + i]);
+  }
+}
+
+///
+/// \param[in]  prg     program (individual/team) used for fitness evaluation
+/// \param[in]  bound   fitness `prg` must beat (`nullptr` for a complete
+///                     evaluation)
+/// \param[out] partial `true` if the evaluation has been stopped early (can
+///                     be `nullptr` when `bound` is `nullptr`)
+/// \return             the fitness (greater is better, max is `0`)
+///
+template<class T>
+fitness_t sum_of_errors_evaluator<T>::evaluate(const T &prg,
+                                              const fitness_t *bound,
+                                              bool *partial)
+{
+  Expects(!this->dat_->classes());
+  Expects(this->dat_->begin() != this->dat_->end());
+  Expects(!bound || partial);
 
   fitness_t::value_type err(0.0);
   int illegals(0);
@@ -45,11 +669,75 @@ fitness_t sum_of_errors_evaluator<T>::operator()(const T &prg)
   // appropriate with the DSS algorithm).
   unsigned total_nr(0);
 
-  for (auto &example : *this->dat_)
+  if (partial)
+    *partial = false;
+
+  // Errors are accumulated in the same order of the row-by-row evaluation
+  // (the result doesn't depend on the number of threads).
+  const auto accumulate([&](const std::vector<value_t> &out, auto first,
+                            auto last)
+  {
+    for (std::size_t i(0); first != last; ++first, ++i)
+    {
+      err += error(out[i], *first, &illegals);
+
+      ++total_nr;
+    }
+  });
+
+  // The incremental evaluation needs the output of the program for every
+  // example: racing doesn't help. The same is true for the output store but
+  // only programs whose outputs are (partially) known are worth it.
+  if (std::vector<value_t> out; incremental(prg, &out)
+                                || memoized(prg, &out, !bound))
+    accumulate(out, this->dat_->begin(), this->dat_->end());
+  else
   {
-    err += error(agent, example, &illegals);
+    // Examples are evaluated in blocks (see `src_interpreter::run`). Every
+    // worker has its own agent and evaluates a block at a time, possibly
+    // reading the columns of the dataset.
+    const auto blocks(this->blocks());
+    const std::size_t workers(this->workers());
+    const auto cols(this->dat_->real_columns());
+    const auto begin(this->dat_->begin());
 
-    ++total_nr;
+    std::vector<basic_reg_lambda_f<T, false>> agents;
+    agents.reserve(workers);
+    for (std::size_t w(0); w < workers; ++w)
+      agents.emplace_back(prg);
+
+    const auto examples(bound ? std::distance(this->dat_->begin(),
+                                              this->dat_->end())
+                              : 0);
+
+    // A wave contains (at most) a block for each worker.
+    std::vector<std::vector<value_t>> outs(std::min(workers, blocks.size()));
+    for (std::size_t b(0); b < blocks.size(); b += outs.size())
+    {
+      const auto wave(std::min(outs.size(), blocks.size() - b));
+
+      this->parallel(wave, [&](std::size_t i, unsigned w)
+                     {
+                       const auto &[first, last] = blocks[b + i];
+
+                       if (!cols
+                           || !agents[w](*cols,
+                                         std::distance(begin, first),
+                                         std::distance(begin, last),
+                                         &outs[i]))
+                         agents[w](first, last, &outs[i]);
+                     });
+
+      for (std::size_t i(0); i < wave; ++i)
+        accumulate(outs[i], blocks[b + i].first, blocks[b + i].second);
+
+      if (bound && b + wave < blocks.size())
+        if (const fitness_t f{-err / examples}; f < *bound)
+        {
+          *partial = true;
+          return f;
+        }
+    }
   }
 
   assert(total_nr);
@@ -81,7 +769,7 @@ fitness_t sum_of_errors_evaluator<T>::fast(const T &prg)
   for (auto &example : *this->dat_)
     if (this->dat_->size() <= 20 || (counter++ % 5) == 0)
     {
-      err += error(agent, example, &illegals);
+      err += error(agent(example), example, &illegals);
 
       ++total_nr;
     }
@@ -107,8 +795,8 @@ std::unique_ptr<basic_lambda_f> sum_of_errors_evaluator<T>::lambdify(
 }
 
 ///
-/// \param[in] agent        lambda function used for the evaluation of the
-///                         current program
+/// \param[in] res          output of the current program for the training
+///                         case `t`
 /// \param[in] t            the current training case
 /// \param[in,out] illegals number of illegals values found evaluating the
 ///                         current program so far
@@ -117,12 +805,12 @@ std::unique_ptr<basic_lambda_f> sum_of_errors_evaluator<T>::lambdify(
 ///                         the `[0;+inf[` range
 ///
 template<class T>
-double mae_evaluator<T>::error(const basic_reg_lambda_f<T, false> &agent,
-                               dataframe::example &t, int *illegals)
+double mae_evaluator<T>::error(const value_t &res, dataframe::example &t,
+                               int *illegals)
 {
   number err;
 
-  if (const auto res = agent(t); has_value(res))
+  if (has_value(res))
     err = std::fabs(lexical_cast<D_DOUBLE>(res) - label_as<D_DOUBLE>(t));
   else
     err = std::pow(100.0, ++(*illegals));
@@ -134,20 +822,19 @@ double mae_evaluator<T>::error(const basic_reg_lambda_f<T, false> &agent,
 }
 
 ///
-/// \param[in] agent lambda function used for the evaluation of the current
-///                  program
-/// \param[in] t     the current training case
-/// \return          a measurement of the error of the current program on the
-///                  training case `t`. The value returned is in the `[0;200]`
-///                  range
+/// \param[in] res output of the current program for the training case `t`
+/// \param[in] t   the current training case
+/// \return        a measurement of the error of the current program on the
+///                training case `t`. The value returned is in the `[0;200]`
+///                range
 ///
 template<class T>
-double rmae_evaluator<T>::error(const basic_reg_lambda_f<T, false> &agent,
-                                dataframe::example &t, int *)
+double rmae_evaluator<T>::error(const value_t &res, dataframe::example &t,
+                                int *)
 {
   number err;
 
-  if (const auto res = agent(t); has_value(res))
+  if (has_value(res))
   {
     const auto approx(lexical_cast<D_DOUBLE>(res));
     const auto target(label_as<D_DOUBLE>(t));
@@ -177,8 +864,8 @@ double rmae_evaluator<T>::error(const basic_reg_lambda_f<T, false> &agent,
 }
 
 ///
-/// \param[in] agent        lambda function used for the evaluation of the
-///                         current program
+/// \param[in] res          output of the current program for the training
+///                         case `t`
 /// \param[in] t            the current training case
 /// \param[in,out] illegals number of illegals values found evaluating the
 ///                         current program so far
@@ -186,12 +873,12 @@ double rmae_evaluator<T>::error(const basic_reg_lambda_f<T, false> &agent,
 ///                         on the training case `t`
 ///
 template<class T>
-double mse_evaluator<T>::error(const basic_reg_lambda_f<T, false> &agent,
-                               dataframe::example &t, int *illegals)
+double mse_evaluator<T>::error(const value_t &res, dataframe::example &t,
+                               int *illegals)
 {
   number err;
 
-  if (const auto res = agent(t); has_value(res))
+  if (has_value(res))
   {
     err = lexical_cast<D_DOUBLE>(res) - label_as<D_DOUBLE>(t);
     err *= err;
@@ -206,18 +893,15 @@ double mse_evaluator<T>::error(const basic_reg_lambda_f<T, false> &agent,
 }
 
 ///
-/// \param[in] agent lambda function used for the evaluation of the current
-///                  program
-/// \param[in] t     the current training case
-/// \return          a measurement of the error of the current program on the
-///                  training case `t`
+/// \param[in] res output of the current program for the training case `t`
+/// \param[in] t   the current training case
+/// \return        a measurement of the error of the current program on the
+///                training case `t`
 ///
 template<class T>
-double count_evaluator<T>::error(const basic_reg_lambda_f<T, false> &agent,
-                                 dataframe::example &t, int *)
+double count_evaluator<T>::error(const value_t &res, dataframe::example &t,
+                                 int *)
 {
-  const auto res(agent(t));
-
   const bool err(!has_value(res) ||
                  !issmall(lexical_cast<D_DOUBLE>(res) - label_as<D_DOUBLE>(t)));
 
@@ -227,6 +911,183 @@ double count_evaluator<T>::error(const basic_reg_lambda_f<T, false> &agent,
   return err ? 1.0 : 0.0;
 }
 
+///
+/// \param[in] d the dataset that the evaluator will use
+///
+template<class T, class E>
+chunked_evaluator<T, E>::chunked_evaluator(const chunked_dataframe &d)
+  : data_(d), chunk_(), eva_(chunk_)
+{
+  Expects(!data_.empty());
+}
+
+///
+/// Sets the number of threads used for the evaluation of a chunk.
+///
+/// \param[in] n number of threads (see src_evaluator::threads)
+///
+template<class T, class E>
+void chunked_evaluator<T, E>::threads(unsigned n)
+{
+  eva_.threads(n);
+}
+
+///
+/// \param[in] prg program (individual/team) used for fitness evaluation
+/// \return        the fitness (greater is better, max is `0`)
+///
+template<class T, class E>
+fitness_t chunked_evaluator<T, E>::operator()(const T &prg)
+{
+  return batch({&prg}).front();
+}
+
+///
+/// \param[in] prgs programs (individuals/teams) used for fitness evaluation
+/// \return         `r[i]` is the fitness of `*prgs[i]`
+///
+template<class T, class E>
+std::vector<fitness_t> chunked_evaluator<T, E>::batch(
+  const std::vector<const T *> &prgs)
+{
+  // The raw errors, and the number of illegal values, are accumulated over
+  // the chunks: the penalty for illegal values is the same of a single pass.
+  std::vector<typename E::error_sum> sums(prgs.size());
+
+  // Evaluates (a subset of) the programs on the examples of a chunk.
+  const auto rows([&](dataframe &d, const std::vector<std::size_t> &subset)
+  {
+    std::vector<const T *> some;
+    std::vector<typename E::error_sum> some_sums;
+    for (const auto i : subset)
+    {
+      some.push_back(prgs[i]);
+      some_sums.push_back(sums[i]);
+    }
+
+    std::swap(chunk_, d);
+    eva_.clear();
+    eva_.errors(some, &some_sums);
+    std::swap(chunk_, d);
+
+    for (std::size_t i(0); i < subset.size(); ++i)
+      sums[subset[i]] = some_sums[i];
+  });
+
+  const auto n(data_.chunks());
+
+  if (data_.real_columns(0).empty())
+  {
+    std::vector<std::size_t> all(prgs.size());
+    std::iota(all.begin(), all.end(), 0);
+
+    data_.for_each_chunk([&](dataframe &d) { rows(d, all); });
+  }
+  else
+    for (std::size_t c(0); c < n; ++c)
+    {
+      if (c + 1 < n)
+        data_.prefetch(c + 1);
+
+      const auto cols(data_.real_columns(c));
+      const std::vector<const D_DOUBLE *> vars(cols.begin() + 1, cols.end());
+      const auto [first, last] = data_.range(c);
+
+      if (const auto others(eva_.errors(prgs, vars, cols.front(),
+                                        last - first, &sums));
+          !others.empty())
+      {
+        dataframe d;
+        data_.load(c, d);
+        rows(d, others);
+      }
+    }
+
+  std::vector<fitness_t> ret;
+  ret.reserve(sums.size());
+  for (const auto &s : sums)
+    ret.push_back({-s.err / s.examples});
+
+  return ret;
+}
+
+///
+/// \param[in] prg program (individual/team) used for fitness evaluation
+/// \return        the fitness (greater is better, max is `0`)
+///
+/// Only the first chunk of the dataset is used (see
+/// sum_of_errors_evaluator::fast). It's loaded by the first call and then
+/// kept in memory.
+///
+template<class T, class E>
+fitness_t chunked_evaluator<T, E>::fast(const T &prg)
+{
+  if (chunk_.empty())
+  {
+    data_.load(0, chunk_);
+    eva_.clear();
+  }
+
+  return eva_.fast(prg);
+}
+
+///
+/// Releases the first chunk of the dataset (it'll be reloaded by the next
+/// call to fast()).
+///
+template<class T, class E>
+void chunked_evaluator<T, E>::clear()
+{
+  chunk_.clear();
+  eva_.clear();
+}
+
+///
+/// \param[in] prg program(individual/team) to be transformed in a lambda
+///                function
+/// \return        the lambda function associated with `prg`
+///
+template<class T, class E>
+std::unique_ptr<basic_lambda_f> chunked_evaluator<T, E>::lambdify(
+  const T &prg) const
+{
+  return eva_.lambdify(prg);
+}
+
+///
+/// \param[in] lambda a classification lambda function
+/// \return           `r[i]` is the classification result for the `i`-th
+///                   example of the active dataset
+///
+/// The examples are split among the available threads (every worker uses a
+/// copy of `lambda`).
+///
+template<class T>
+template<class L>
+std::vector<classification_result> classification_evaluator<T>::tag(
+  const L &lambda)
+{
+  const auto blocks(this->blocks());
+  const auto begin(this->dat_->begin());
+
+  std::vector<classification_result> ret(std::distance(begin,
+                                                       this->dat_->end()));
+
+  const std::vector<L> copies(this->workers() - 1, lambda);
+
+  this->parallel(blocks.size(), [&](std::size_t b, unsigned w)
+                 {
+                   const L &l(w ? copies[w - 1] : lambda);
+
+                   auto out(std::next(ret.begin(),
+                                      std::distance(begin, blocks[b].first)));
+                   for (auto it(blocks[b].first); it != blocks[b].second; ++it)
+                     *out++ = l.tag(*it);
+                 });
+
+  return ret;
+}
+
 ///
 /// \param[in] p      current dataset
 /// \param[in] x_slot basic parameter for the Slotted Dynamic Class Boundary
@@ -246,11 +1107,18 @@ dyn_slot_evaluator<T>::dyn_slot_evaluator(dataframe &d, unsigned x_slot)
 template<class T>
 fitness_t dyn_slot_evaluator<T>::operator()(const T &ind)
 {
-  basic_dyn_slot_lambda_f<T, false, false> lambda(ind, *this->dat_, x_slot_);
+  // The training pass is split among the available threads too.
+  std::vector<value_t> outs;
+  this->outputs(ind, this->dat_->begin(), this->dat_->end(), &outs);
+
+  basic_dyn_slot_lambda_f<T, false, false> lambda(ind, *this->dat_, x_slot_,
+                                                  outs);
+  const auto res(this->tag(lambda));
 
   fitness_t::value_type err(0.0);
+  std::size_t i(0);
   for (auto &example : *this->dat_)
-    if (lambda.tag(example).label != label(example))
+    if (res[i++].label != label(example))
     {
       ++err;
       ++example.difficulty;
@@ -292,11 +1160,17 @@ fitness_t gaussian_evaluator<T>::operator()(const T &ind)
   assert(ind.debug());
   assert(this->dat_->classes() >= 2);
 
-  basic_gaussian_lambda_f<T, false, false> lambda(ind, *this->dat_);
+  // The training pass is split among the available threads too.
+  std::vector<value_t> outs;
+  this->outputs(ind, this->dat_->begin(), this->dat_->end(), &outs);
+
+  basic_gaussian_lambda_f<T, false, false> lambda(ind, *this->dat_, outs);
+  const auto results(this->tag(lambda));
 
   fitness_t::value_type d(0.0);
+  std::size_t i(0);
   for (auto &example : *this->dat_)
-    if (const auto res = lambda.tag(example); res.label == label(example))
+    if (const auto res = results[i++]; res.label == label(example))
     {
       // Note:
       // * (1.0 - confidence) is the sum of the errors;
@@ -341,10 +1215,12 @@ fitness_t binary_evaluator<T>::operator()(const T &ind)
   Expects(this->dat_->classes() == 2);
 
   basic_binary_lambda_f<T, false, false> agent(ind, *this->dat_);
-  fitness_t::value_type err(0.0);
+  const auto res(this->tag(agent));
 
+  fitness_t::value_type err(0.0);
+  std::size_t i(0);
   for (auto &example : *this->dat_)
-    if (label(example) != agent.tag(example).label)
+    if (label(example) != res[i++].label)
     {
       ++example.difficulty;
       ++err;
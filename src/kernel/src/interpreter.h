@@ -13,7 +13,10 @@
 #if !defined(VITA_SRC_INTERPRETER_H)
 #define      VITA_SRC_INTERPRETER_H
 
+#include "kernel/column_store.h"
 #include "kernel/interpreter.h"
+#include "kernel/src/columnar_dataframe.h"
+#include "kernel/src/real_program.h"
 
 namespace vita
 {
@@ -32,14 +35,21 @@ template<class T>
 class src_interpreter : public interpreter<T>
 {
 public:
-  explicit src_interpreter(const T *prg, interpreter<T> *ctx = nullptr)
-    : interpreter<T>(prg, ctx), example_(nullptr)
-  {}
+  explicit src_interpreter(const T *, interpreter<T> * = nullptr);
 
   value_t run(const std::vector<value_t> &);
+  template<class It> void run(It, It, std::vector<value_t> *);
+  void run(const columnar_dataframe &, std::size_t, std::size_t,
+           std::vector<value_t> *);
+  bool run(const std::vector<const D_DOUBLE *> &, std::size_t,
+           std::vector<value_t> *);
+  template<class It> bool run(It, It, std::vector<value_t> *,
+                              column_store &, std::size_t);
 
   value_t fetch_var(unsigned);
 
+  bool real_valued() const;
+
 private:
   // Tells the compiler we want both the run function from interpreter and
   // src_interpreter.
@@ -51,6 +61,9 @@ private:
   using interpreter<T>::run;
 
   const std::vector<value_t> *example_;
+
+  // The `double`-only version of the program (empty if not available).
+  real_program real_;
 };
 
 #include "kernel/src/interpreter.tcc"
@@ -17,6 +17,27 @@
 #if !defined(VITA_SRC_INTERPRETER_TCC)
 #define      VITA_SRC_INTERPRETER_TCC
 
+///
+/// \param[in] prg program to be evaluated
+/// \param[in] ctx context in which we calculate the output value (used for
+///                the evaluation of ADF). It can be empty (`nullptr`)
+///
+/// When the active code of `prg` is made up only of symbols working on
+/// `double`s (typical for symbolic regression), a faster, specialized version
+/// of the program is also prepared (see vita::real_program).
+///
+template<class T>
+src_interpreter<T>::src_interpreter(const T *prg, interpreter<T> *ctx)
+  : interpreter<T>(prg, ctx), example_(nullptr), real_()
+{
+  for (const auto &ins : *this->code_)
+    if (!real_.push_back(ins.sym, ins.par, ins.args.data()))
+    {
+      real_.clear();
+      break;
+    }
+}
+
 ///
 /// Calculates the output of a program (individual) given a specific input.
 ///
@@ -26,10 +47,281 @@
 template<class T>
 value_t src_interpreter<T>::run(const std::vector<value_t> &ex)
 {
+  if (!real_.empty())
+  {
+    const std::vector<value_t> *const input(&ex);
+    value_t ret;
+
+    if (real_.run(&input, 1, &ret))
+      return ret;
+
+    real_.clear();  // input data aren't `double`s
+  }
+
   example_ = &ex;
   return this->run();
 }
 
+///
+/// Calculates the output of a program (individual) for a range of examples.
+///
+/// \param[in]  first beginning of the range of examples
+/// \param[in]  last  end of the range of examples
+/// \param[out] out   output values (`out[i]` is the output for the `i`-th
+///                   example of the range)
+///
+/// The range should be reasonably small (a block of the dataset): the
+/// interpreter stores a column of values for every active gene.
+///
+/// \remark
+/// Elements of the range must have an `input` data member (a vector of values
+/// for the problem's variables) as `dataframe::example` does.
+///
+template<class T>
+template<class It>
+void src_interpreter<T>::run(It first, It last, std::vector<value_t> *out)
+{
+  std::vector<const std::vector<value_t> *> inputs;
+  for (; first != last; ++first)
+    inputs.push_back(&first->input);
+
+  if (!real_.empty())
+  {
+    out->resize(inputs.size());
+    if (real_.run(inputs.data(), inputs.size(), out->data()))
+      return;
+
+    real_.clear();  // input data aren't `double`s
+  }
+
+  this->run_columns(inputs.size(),
+                    [&](std::size_t i) { example_ = inputs[i]; }, out);
+}
+
+///
+/// Calculates the output of a program (individual) for a range of rows of a
+/// columnar dataframe.
+///
+/// \param[in]  d     a columnar dataframe
+/// \param[in]  first index of the first row of the range
+/// \param[in]  last  index one past the last row of the range
+/// \param[out] out   output values (`out[i]` is the output for the
+///                   `first + i`-th row)
+///
+/// The `double`-only fast path reads the variables directly from the columns
+/// of `d`. Otherwise the rows are converted to `dataframe::example`s and
+/// evaluated by the general interpreter.
+///
+template<class T>
+void src_interpreter<T>::run(const columnar_dataframe &d, std::size_t first,
+                             std::size_t last, std::vector<value_t> *out)
+{
+  Expects(first <= last);
+  Expects(last <= d.size());
+
+  if (!real_.empty())
+  {
+    std::vector<const D_DOUBLE *> vars(d.variables());
+    for (std::size_t v(0); v < vars.size(); ++v)
+      if (const auto *col = d.input(v).reals())
+        vars[v] = col + first;
+
+    if (run(vars, last - first, out))
+      return;
+  }
+
+  std::vector<dataframe::example> rows;
+  rows.reserve(last - first);
+  for (auto i(first); i < last; ++i)
+    rows.push_back(d[i]);
+
+  run(rows.begin(), rows.end(), out);
+}
+
+///
+/// Calculates the output of a program (individual) for a group of examples
+/// whose variables are stored by columns.
+///
+/// \param[in]  vars `vars[v]` is the column (`n` elements, `NaN` for the
+///                  empty value) of the `v`-th variable or `nullptr` if the
+///                  variable doesn't contain `D_DOUBLE`s
+/// \param[in]  n    number of examples
+/// \param[out] out  output values (`out[i]` is the output for the `i`-th
+///                  example)
+/// \return          `true` if the `double`-only fast path is available
+///                  (otherwise `out` is unspecified)
+///
+/// Variables are read in place (e.g. from a memory-mapped file): no example
+/// is built.
+///
+template<class T>
+bool src_interpreter<T>::run(const std::vector<const D_DOUBLE *> &vars,
+                             std::size_t n, std::vector<value_t> *out)
+{
+  if (real_.empty())
+    return false;
+
+  out->resize(n);
+  if (real_.run(vars.data(), n, out->data()))
+    return true;
+
+  real_.clear();  // input data aren't `double`s
+  return false;
+}
+
+///
+/// Calculates the output of a program for a range of examples reusing the
+/// outputs of the unchanged genes of its parent.
+///
+/// \param[in]     first beginning of the range of examples
+/// \param[in]     last  end of the range of examples
+/// \param[out]    out   output values (`out[i]` is the output for the `i`-th
+///                      example of the range)
+/// \param[in,out] store gene outputs of the recently evaluated individuals
+/// \param[in]     block number of examples evaluated together
+/// \return              `true` if the `double`-only fast path is available
+///                      (otherwise nothing is done)
+///
+/// The output column of an active gene is reused when the parent contains the
+/// same gene at the same locus and the columns of all its arguments are
+/// reused. Otherwise the column is searched by subtree signature (it could
+/// have been computed by any individual of the population). The outputs of
+/// the program are then added to `store` and linked to the program (so that
+/// they can be inherited by the offspring).
+///
+/// The range is evaluated `block` examples at a time, so the working memory
+/// of the interpreter doesn't depend on the size of the range. The complete
+/// columns of the recomputed genes are built only when the outputs of the
+/// program fit in the memory budget of `store`.
+///
+/// \remark
+/// * `[first, last)` must be the same range for every call sharing `store`
+///   (`store` has to be cleared when the range changes).
+/// * Only available for vita::i_mep.
+///
+template<class T>
+template<class It>
+bool src_interpreter<T>::run(It first, It last, std::vector<value_t> *out,
+                             column_store &store, std::size_t block)
+{
+  Expects(block);
+
+  if (real_.empty())
+    return false;
+
+  std::vector<const std::vector<value_t> *> inputs;
+  for (; first != last; ++first)
+    inputs.push_back(&first->input);
+
+  const auto n(inputs.size());
+  const auto &prg(this->program());
+  const auto &code(*this->code_);
+
+  std::vector<gene_outputs::column> reused(code.size());
+  std::vector<const D_DOUBLE *> known(code.size(), nullptr);
+  std::vector<hash_t> signatures(code.size());
+  std::vector<bool> inherited(code.size(), false);
+
+  const auto parent(store.find(prg.outputs()));
+
+  for (std::size_t pc(0); pc < code.size(); ++pc)
+  {
+    const locus l(code[pc].loc);
+
+    // Arguments must be inherited too: a column found via signature could
+    // differ from the one the parent used.
+    if (parent)
+      if (const auto it = parent->loci.find(l);
+          it != parent->loci.end() && it->second.values
+          && it->second.values->size() == n
+          && it->second.g == prg[l]
+          && std::all_of(code[pc].args.begin(), code[pc].args.end(),
+                         [&](unsigned a) { return inherited[a]; }))
+      {
+        reused[pc] = it->second.values;
+        known[pc] = reused[pc]->data();
+        inherited[pc] = true;
+        continue;
+      }
+
+    // Same subexpression already evaluated by another individual?
+    signatures[pc] = prg.signature(l);
+    if (auto col = store.find(signatures[pc]); col && col->size() == n)
+    {
+      reused[pc] = std::move(col);
+      known[pc] = reused[pc]->data();
+    }
+  }
+
+  // Same computation of `gene_outputs::bytes()`.
+  const std::size_t bytes(
+    sizeof(gene_outputs)
+    + code.size() * (sizeof(typename decltype(gene_outputs::loci)::value_type)
+                     + n * sizeof(D_DOUBLE)));
+  const bool storable(bytes <= store.budget());
+
+  std::vector<std::vector<D_DOUBLE>> fresh(storable ? code.size() : 0);
+  for (std::size_t pc(0); pc < fresh.size(); ++pc)
+    if (!reused[pc])
+      fresh[pc].resize(n);
+
+  out->resize(n);
+  std::vector<const D_DOUBLE *> known_block(code.size());
+  for (std::size_t b(0); b < n; b += block)
+  {
+    const auto m(std::min(block, n - b));
+
+    for (std::size_t pc(0); pc < code.size(); ++pc)
+      known_block[pc] = known[pc] ? known[pc] + b : nullptr;
+
+    if (!real_.run(inputs.data() + b, m, out->data() + b,
+                   known_block.data()))
+    {
+      real_.clear();  // input data aren't `double`s
+      return false;
+    }
+
+    for (std::size_t pc(0); pc < fresh.size(); ++pc)
+      if (!reused[pc])
+        std::copy_n(real_.column(pc), m, fresh[pc].begin() + b);
+  }
+
+  if (!storable)
+    return true;
+
+  gene_outputs go;
+  for (std::size_t pc(0); pc < code.size(); ++pc)
+  {
+    auto values(reused[pc]);
+    if (!values)
+    {
+      values = std::make_shared<const std::vector<D_DOUBLE>>(
+        std::move(fresh[pc]));
+
+      store.insert(signatures[pc], values);
+    }
+
+    go.loci.emplace(code[pc].loc,
+                    gene_outputs::elem{prg[code[pc].loc], values});
+  }
+
+  prg.outputs(store.insert(std::move(go)));
+  return true;
+}
+
+///
+/// \return `true` if the `double`-only fast path is available (see
+///         vita::real_program)
+///
+/// When available, the evaluation of a range of rows of a columnar dataframe
+/// reads the variables directly from the columns.
+///
+template<class T>
+bool src_interpreter<T>::real_valued() const
+{
+  return !real_.empty();
+}
+
 ///
 /// Used by the vita::variable class to retrieve the value of a variable.
 ///
@@ -0,0 +1,201 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <algorithm>
+
+#include "kernel/src/output_store.h"
+
+namespace vita
+{
+///
+/// \return an estimate of the memory (in bytes) used by the object
+///
+std::size_t program_outputs::bytes() const
+{
+  return sizeof(*this) + values.capacity() * sizeof(D_DOUBLE)
+         + known.capacity() / 8;
+}
+
+///
+/// \param[in] budget maximum memory (in bytes) used by the store
+///
+output_store::output_store(std::size_t budget)
+  : lru_(), where_(), directory_(), slice_ids_(), slice_columns_(),
+    budget_(budget), used_(0), reused_(0), computed_(0)
+{
+  Expects(budget);
+}
+
+///
+/// \param[in] d a dataset
+/// \return      `r[i]` is the column associated with the `i`-th example of
+///              `d`
+///
+/// Examples never seen before get a new column.
+///
+/// \remark
+/// The association is recalculated only when the examples of the dataset
+/// (or their order) change.
+///
+const std::vector<std::size_t> &output_store::columns(const dataframe &d)
+{
+  const bool same(slice_ids_.size() == d.size()
+                  && std::equal(d.begin(), d.end(), slice_ids_.begin(),
+                                [](const dataframe::example &e,
+                                   std::uintmax_t id)
+                                {
+                                  return e.id == id;
+                                }));
+
+  if (!same)
+  {
+    slice_ids_.clear();
+    slice_columns_.clear();
+
+    for (const auto &e : d)
+    {
+      Expects(e.id);
+
+      const auto next(directory_.size());
+      const auto col(directory_.try_emplace(e.id, next).first->second);
+
+      slice_ids_.push_back(e.id);
+      slice_columns_.push_back(col);
+    }
+  }
+
+  Ensures(slice_columns_.size() == d.size());
+  return slice_columns_;
+}
+
+///
+/// \return number of columns (i.e. number of distinct examples seen)
+///
+std::size_t output_store::width() const
+{
+  return directory_.size();
+}
+
+///
+/// \param[in] h signature of a program
+/// \return      the outputs of the program (`nullptr` if not available)
+///
+/// A successful search marks the element as recently used.
+///
+std::shared_ptr<const program_outputs> output_store::find(const hash_t &h)
+{
+  const auto it(where_.find(h));
+  if (it == where_.end())
+    return nullptr;
+
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second;
+}
+
+///
+/// Inserts (or replaces) an element of the store.
+///
+/// \param[in] h  signature of a program
+/// \param[in] po outputs of the program
+///
+/// Least recently used elements are evicted to stay within the budget.
+///
+void output_store::insert(const hash_t &h, program_outputs po)
+{
+  if (const auto it = where_.find(h); it != where_.end())
+  {
+    used_ -= it->second->second->bytes();
+    lru_.erase(it->second);
+    where_.erase(it);
+  }
+
+  const auto bytes(po.bytes());
+  if (bytes > budget_)
+    return;  // too big to be stored
+
+  lru_.emplace_front(h, std::make_shared<const program_outputs>(std::move(po)));
+  where_[h] = lru_.begin();
+  used_ += bytes;
+
+  while (used_ > budget_)
+  {
+    const auto &victim(lru_.back());
+
+    used_ -= victim.second->bytes();
+    where_.erase(victim.first);
+    lru_.pop_back();
+  }
+
+  Ensures(used_ <= budget_);
+}
+
+///
+/// Removes every element from the store.
+///
+/// \note
+/// There is no need to call this function when the training set changes.
+///
+void output_store::clear()
+{
+  lru_.clear();
+  where_.clear();
+  directory_.clear();
+  slice_ids_.clear();
+  slice_columns_.clear();
+  used_ = 0;
+}
+
+///
+/// \return the memory budget (in bytes)
+///
+std::size_t output_store::budget() const
+{
+  return budget_;
+}
+
+///
+/// \return an estimate of the memory used (in bytes)
+///
+std::size_t output_store::used() const
+{
+  return used_;
+}
+
+///
+/// Updates the statistics of the store.
+///
+/// \param[in] reused   number of outputs taken from the store
+/// \param[in] computed number of outputs calculated
+///
+void output_store::count(std::size_t reused, std::size_t computed)
+{
+  reused_ += reused;
+  computed_ += computed;
+}
+
+///
+/// \return number of outputs taken from the store
+///
+std::uintmax_t output_store::reused() const
+{
+  return reused_;
+}
+
+///
+/// \return number of outputs calculated
+///
+std::uintmax_t output_store::computed() const
+{
+  return computed_;
+}
+
+}  // namespace vita
@@ -0,0 +1,104 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_OUTPUT_STORE_H)
+#define      VITA_OUTPUT_STORE_H
+
+#include <list>
+#include <unordered_map>
+
+#include "kernel/cache_hash.h"
+#include "kernel/src/dataframe.h"
+
+namespace vita
+{
+///
+/// Outputs of a program for the single examples of a dataset.
+///
+/// `values[c]` is the output for the example associated with column `c` (see
+/// `output_store::columns`), `NaN` encodes the empty value. `known[c]` is
+/// `false` if the output hasn't been calculated.
+///
+struct program_outputs
+{
+  std::vector<D_DOUBLE> values = {};
+  std::vector<bool>      known = {};
+
+  std::size_t bytes() const;
+};
+
+///
+/// A memory-bounded store of the outputs of the recently evaluated programs.
+///
+/// Outputs are linked to the examples via their ID (see `dataframe::example`)
+/// and not via their position in the dataset: they survive the changes of
+/// the training set (e.g. the DSS algorithm moves examples between the
+/// training and the validation set every few generations). So the fitness of
+/// a known program can be rebuilt evaluating only the examples the program
+/// has never seen.
+///
+/// When the memory budget is exceeded the least recently used elements are
+/// evicted.
+///
+/// \remark
+/// The input of an example must not change after the example has been added
+/// to a dataframe.
+///
+class output_store
+{
+public:
+  explicit output_store(std::size_t);
+
+  const std::vector<std::size_t> &columns(const dataframe &);
+  std::size_t width() const;
+
+  std::shared_ptr<const program_outputs> find(const hash_t &);
+  void insert(const hash_t &, program_outputs);
+
+  void clear();
+
+  std::size_t budget() const;
+  std::size_t used() const;
+
+  void count(std::size_t, std::size_t);
+  std::uintmax_t reused() const;
+  std::uintmax_t computed() const;
+
+private:
+  struct hash_key
+  {
+    std::size_t operator()(const hash_t &h) const { return h.data[0]; }
+  };
+
+  using element = std::pair<hash_t, std::shared_ptr<const program_outputs>>;
+  using lru_list = std::list<element>;
+
+  lru_list lru_;  // most recently used elements are at the front
+  std::unordered_map<hash_t, lru_list::iterator, hash_key> where_;
+
+  // Example ID to column.
+  std::unordered_map<std::uintmax_t, std::size_t> directory_;
+
+  // IDs / columns of the examples of the last dataset seen by `columns`.
+  std::vector<std::uintmax_t> slice_ids_;
+  std::vector<std::size_t> slice_columns_;
+
+  std::size_t budget_;  // memory budget in bytes
+  std::size_t used_;
+
+  std::uintmax_t reused_;    // outputs taken from the store
+  std::uintmax_t computed_;  // outputs calculated
+};
+
+}  // namespace vita
+
+#endif  // include guard
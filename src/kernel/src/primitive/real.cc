@@ -0,0 +1,206 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include "kernel/src/primitive/real.h"
+
+/// Function multi-versioning (GCC, x86-64 Linux only). The compiler generates
+/// a version of the function for every listed instruction set and the best
+/// one for the running CPU is selected at load time. So a binary built for a
+/// generic target still uses the AVX2 / AVX-512 registers, when available.
+///
+/// \remark
+/// The kernels are written without branches (results are selected via masks)
+/// so that the compiler can vectorize them. There is no explicit intrinsic
+/// code: the same source gives the scalar fallback (the `default` clone) and
+/// the SIMD versions. Since floating-point contraction is disabled
+/// (ISO C++ mode) every version produces exactly the same results.
+///
+/// \note
+/// Other compilers / platforms get a single version, auto-vectorized for the
+/// target instruction set (e.g. NEON on AArch64, SSE2 on a generic x86-64
+/// build): there is neither run-time dispatch nor NEON specific code.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) \
+    && defined(__linux__)
+#  define VITA_COLUMN_KERNEL \
+     __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#  define VITA_COLUMN_KERNEL
+#endif
+
+namespace vita::real::column
+{
+
+namespace
+{
+
+constexpr base_t max_value = std::numeric_limits<base_t>::max();
+
+// Branch-free version of `finite_or_empty` (`NaN` doesn't pass the test).
+inline base_t finite_mask(base_t v)
+{
+  return std::fabs(v) <= max_value ? v : empty_value;
+}
+
+// Branch-free version of `a || b`.
+inline bool either(bool a, bool b)
+{
+  return a | b;
+}
+
+}  // unnamed namespace
+
+VITA_COLUMN_KERNEL
+void abs(const base_t *a, base_t *out, std::size_t n)
+{
+  for (std::size_t i(0); i < n; ++i)
+    out[i] = std::fabs(a[i]);
+}
+
+VITA_COLUMN_KERNEL
+void add(const base_t *a, const base_t *b, base_t *out, std::size_t n)
+{
+  for (std::size_t i(0); i < n; ++i)
+    out[i] = finite_mask(a[i] + b[i]);
+}
+
+VITA_COLUMN_KERNEL
+void aq(const base_t *a, const base_t *b, base_t *out, std::size_t n)
+{
+  for (std::size_t i(0); i < n; ++i)
+    out[i] = finite_mask(a[i] / std::sqrt(1.0 + b[i] * b[i]));
+}
+
+VITA_COLUMN_KERNEL
+void div(const base_t *a, const base_t *b, base_t *out, std::size_t n)
+{
+  for (std::size_t i(0); i < n; ++i)
+    out[i] = finite_mask(a[i] / b[i]);
+}
+
+VITA_COLUMN_KERNEL
+void idiv(const base_t *a, const base_t *b, base_t *out, std::size_t n)
+{
+  for (std::size_t i(0); i < n; ++i)
+    out[i] = finite_mask(std::floor(a[i] / b[i]));
+}
+
+VITA_COLUMN_KERNEL
+void ifb(const base_t *const args[], base_t *out, std::size_t n)
+{
+  const base_t *a0(args[0]);
+  const base_t *a1(args[1]);
+  const base_t *a2(args[2]);
+  const base_t *a3(args[3]);
+  const base_t *a4(args[4]);
+
+  for (std::size_t i(0); i < n; ++i)
+  {
+    const auto v0(a0[i]), v1(a1[i]), v2(a2[i]), v3(a3[i]), v4(a4[i]);
+
+    const auto min(v1 < v2 ? v1 : v2);
+    const auto max(v1 < v2 ? v2 : v1);
+    const auto res(either(v0 < min, v0 > max) ? v4 : v3);
+
+    out[i] = either(either(std::isnan(v0), std::isnan(v1)), std::isnan(v2))
+             ? empty_value : res;
+  }
+}
+
+VITA_COLUMN_KERNEL
+void ife(const base_t *const args[], base_t *out, std::size_t n)
+{
+  const base_t *a0(args[0]);
+  const base_t *a1(args[1]);
+  const base_t *a2(args[2]);
+  const base_t *a3(args[3]);
+
+  constexpr auto e(2.0 * std::numeric_limits<base_t>::epsilon());
+
+  for (std::size_t i(0); i < n; ++i)
+  {
+    const auto v0(a0[i]), v1(a1[i]), v2(a2[i]), v3(a3[i]);
+    const auto res(std::fabs(v0 - v1) < e ? v2 : v3);
+
+    out[i] = either(std::isnan(v0), std::isnan(v1)) ? empty_value : res;
+  }
+}
+
+VITA_COLUMN_KERNEL
+void ifl(const base_t *const args[], base_t *out, std::size_t n)
+{
+  const base_t *a0(args[0]);
+  const base_t *a1(args[1]);
+  const base_t *a2(args[2]);
+  const base_t *a3(args[3]);
+
+  for (std::size_t i(0); i < n; ++i)
+  {
+    const auto v0(a0[i]), v1(a1[i]), v2(a2[i]), v3(a3[i]);
+    const auto res(v0 < v1 ? v2 : v3);
+
+    out[i] = either(std::isnan(v0), std::isnan(v1)) ? empty_value : res;
+  }
+}
+
+VITA_COLUMN_KERNEL
+void ifz(const base_t *const args[], base_t *out, std::size_t n)
+{
+  const base_t *a0(args[0]);
+  const base_t *a1(args[1]);
+  const base_t *a2(args[2]);
+
+  constexpr auto e(2.0 * std::numeric_limits<base_t>::epsilon());
+
+  for (std::size_t i(0); i < n; ++i)
+  {
+    const auto v0(a0[i]), v1(a1[i]), v2(a2[i]);
+    const auto res(std::fabs(v0) < e ? v1 : v2);
+
+    out[i] = std::isnan(v0) ? empty_value : res;
+  }
+}
+
+VITA_COLUMN_KERNEL
+void max(const base_t *a, const base_t *b, base_t *out, std::size_t n)
+{
+  for (std::size_t i(0); i < n; ++i)
+  {
+    const auto v0(a[i]), v1(b[i]);
+    const auto res(v0 < v1 ? v1 : v0);
+
+    out[i] = either(std::isnan(v0), std::isnan(v1)) ? empty_value
+                                                    : finite_mask(res);
+  }
+}
+
+VITA_COLUMN_KERNEL
+void mul(const base_t *a, const base_t *b, base_t *out, std::size_t n)
+{
+  for (std::size_t i(0); i < n; ++i)
+    out[i] = finite_mask(a[i] * b[i]);
+}
+
+VITA_COLUMN_KERNEL
+void sqrt(const base_t *a, base_t *out, std::size_t n)
+{
+  for (std::size_t i(0); i < n; ++i)
+    out[i] = a[i] < 0.0 ? empty_value : std::sqrt(a[i]);
+}
+
+VITA_COLUMN_KERNEL
+void sub(const base_t *a, const base_t *b, base_t *out, std::size_t n)
+{
+  for (std::size_t i(0); i < n; ++i)
+    out[i] = finite_mask(a[i] - b[i]);
+}
+
+}  // namespace vita::real::column
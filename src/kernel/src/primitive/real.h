@@ -13,12 +13,14 @@
 #if !defined(VITA_REAL_PRIMITIVE_H)
 #define      VITA_REAL_PRIMITIVE_H
 
+#include <algorithm>
 #include <string>
 
 #include "kernel/function.h"
 #include "kernel/interpreter.h"
 #include "kernel/random.h"
 #include "kernel/terminal.h"
+#include "kernel/src/real_program.h"
 #include "kernel/src/primitive/comp_penalty.h"
 #include "utility/utility.h"
 
@@ -51,6 +53,45 @@ inline base_t base(const value_t &v)
   return std::get<base_t>(v);
 }
 
+///
+/// The *empty* value for the `double`-only fast path (see vita::column_op).
+///
+constexpr base_t empty_value = std::numeric_limits<base_t>::quiet_NaN();
+
+///
+/// \param[in] v a value
+/// \return      `v` if it's a finite value, an empty value otherwise
+///
+inline base_t finite_or_empty(base_t v)
+{
+  return std::isfinite(v) ? v : empty_value;
+}
+
+/// Vectorizable kernels used by the `double`-only fast path (see
+/// vita::column_op). Every function computes `n` elements of the output column
+/// `out`.
+///
+/// \remark
+/// `cos`, `ln`, `sigmoid` and `sin` have no kernel: their columns are computed
+/// element by element via the scalar `std` functions (a vector math library
+/// wouldn't give the same results).
+namespace column
+{
+void abs(const base_t *, base_t *, std::size_t);
+void add(const base_t *, const base_t *, base_t *, std::size_t);
+void aq(const base_t *, const base_t *, base_t *, std::size_t);
+void div(const base_t *, const base_t *, base_t *, std::size_t);
+void idiv(const base_t *, const base_t *, base_t *, std::size_t);
+void ifb(const base_t *const [], base_t *, std::size_t);
+void ife(const base_t *const [], base_t *, std::size_t);
+void ifl(const base_t *const [], base_t *, std::size_t);
+void ifz(const base_t *const [], base_t *, std::size_t);
+void max(const base_t *, const base_t *, base_t *, std::size_t);
+void mul(const base_t *, const base_t *, base_t *, std::size_t);
+void sqrt(const base_t *, base_t *, std::size_t);
+void sub(const base_t *, const base_t *, base_t *, std::size_t);
+}  // namespace column
+
 ///
 /// Ephemeral random constant.
 ///
@@ -63,7 +104,7 @@ inline base_t base(const value_t &v)
 /// these random constants are moved around from genome to genome by the
 /// crossover operator.
 ///
-class real : public terminal
+class real : public terminal, public column_op
 {
 public:
   explicit real(const cvect &c, base_t m = -1000.0, base_t u = 1000.0)
@@ -87,6 +128,12 @@ public:
              static_cast<interpreter<i_mep> *>(i)->fetch_param());
   }
 
+  void eval_column(const base_t *const [], terminal::param_t p, base_t *out,
+                   std::size_t n) const final
+  {
+    std::fill(out, out + n, static_cast<base_t>(p));
+  }
+
 private:
   const base_t min, upp;
 };
@@ -96,7 +143,7 @@ private:
 ///
 /// This is like real::real but restricted to integer numbers.
 ///
-class integer : public terminal
+class integer : public terminal, public column_op
 {
 public:
   explicit integer(const cvect &c, int m = -128, int u = 127)
@@ -120,6 +167,12 @@ public:
              static_cast<interpreter<i_mep> *>(i)->fetch_param());
   }
 
+  void eval_column(const base_t *const [], terminal::param_t p, base_t *out,
+                   std::size_t n) const final
+  {
+    std::fill(out, out + n, static_cast<base_t>(p));
+  }
+
 private:
   const int min, upp;
 };
@@ -127,7 +180,7 @@ private:
 ///
 /// The absolute value of a real number.
 ///
-class abs : public function
+class abs : public function, public column_op
 {
 public:
   explicit abs(const cvect &c = {0}) : function("FABS", c[0], {c[0]})
@@ -149,12 +202,18 @@ public:
     const auto a(static_cast<interpreter<i_mep> *>(i)->fetch_arg(0));
     return has_value(a) ? std::fabs(base(a)) : a;
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    column::abs(a[0], out, n);
+  }
 };
 
 ///
 /// Sum of two real numbers.
 ///
-class add : public function
+class add : public function, public column_op
 {
 public:
   explicit add(const cvect &c = {0}) : function("FADD", c[0], {c[0], c[0]}) {}
@@ -181,6 +240,12 @@ public:
 
     return ret;
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    column::add(a[0], a[1], out, n);
+  }
 };
 
 ///
@@ -192,7 +257,7 @@ public:
 /// protected or unprotected division. Further, the AQ operator is
 /// differentiable.
 ///
-class aq : public function
+class aq : public function, public column_op
 {
 public:
   explicit aq(const cvect &c = {0}) : function("AQ", c[0], {c[0], c[0]})
@@ -224,12 +289,18 @@ public:
 
     return ret;
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    column::aq(a[0], a[1], out, n);
+  }
 };
 
 ///
 /// `cos()` of a real number.
 ///
-class cos : public function
+class cos : public function, public column_op
 {
 public:
   explicit cos(const cvect &c = {0}) : function("FCOS", c[0], {c[0]})
@@ -252,12 +323,19 @@ public:
 
     return std::cos(base(a));
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    for (std::size_t i(0); i < n; ++i)
+      out[i] = std::cos(a[0][i]);
+  }
 };
 
 ///
 /// Unprotected division (UPD) between two real numbers.
 ///
-class div : public function
+class div : public function, public column_op
 {
 public:
   explicit div(const cvect &c = {0}) : function("FDIV", c[0], {c[0], c[0]})
@@ -283,6 +361,12 @@ public:
 
     return ret;
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    column::div(a[0], a[1], out, n);
+  }
 };
 
 ///
@@ -323,7 +407,7 @@ public:
 ///
 /// Quotient of the division between two real numbers.
 ///
-class idiv : public function
+class idiv : public function, public column_op
 {
 public:
   explicit idiv(const cvect &c = {0}) : function("FIDIV", c[0], {c[0], c[0]})
@@ -355,6 +439,12 @@ public:
 
     return ret;
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    column::idiv(a[0], a[1], out, n);
+  }
 };
 
 ///
@@ -362,7 +452,7 @@ public:
 ///
 /// \warning Requires five input arguments.
 ///
-class ifb : public function
+class ifb : public function, public column_op
 {
 public:
   explicit ifb(const cvect &c = {0, 0})
@@ -406,12 +496,18 @@ public:
     else
       return i->fetch_arg(3);
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    column::ifb(a, out, n);
+  }
 };
 
 ///
 /// "If equal" operator.
 ///
-class ife : public function
+class ife : public function, public column_op
 {
 public:
   explicit ife(const cvect &c = {0, 0})
@@ -450,6 +546,12 @@ public:
       return i->fetch_arg(3);
   }
 
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    column::ife(a, out, n);
+  }
+
   double penalty_nvi(core_interpreter *ci) const final
   {
     return comparison_function_penalty(ci);
@@ -459,7 +561,7 @@ public:
 ///
 /// "If less then" operator.
 ///
-class ifl : public function
+class ifl : public function, public column_op
 {
 public:
   explicit ifl(const cvect &c  = {0, 0})
@@ -492,6 +594,12 @@ public:
       return i->fetch_arg(3);
   }
 
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    column::ifl(a, out, n);
+  }
+
   double penalty_nvi(core_interpreter *ci) const final
   {
     return comparison_function_penalty(ci);
@@ -501,7 +609,7 @@ public:
 ///
 /// "If zero" operator.
 ///
-class ifz : public function
+class ifz : public function, public column_op
 {
 public:
   explicit ifz(const cvect &c = {0})
@@ -536,6 +644,12 @@ public:
     else
       return i->fetch_arg(2);
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    column::ifz(a, out, n);
+  }
 };
 
 ///
@@ -570,7 +684,7 @@ public:
 ///
 /// Natural logarithm of a real number.
 ///
-class ln : public function
+class ln : public function, public column_op
 {
 public:
   explicit ln(const cvect &c = {0}) : function("FLN", c[0], {c[0]})
@@ -601,6 +715,13 @@ public:
 
     return ret;
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    for (std::size_t i(0); i < n; ++i)
+      out[i] = finite_or_empty(std::log(a[0][i]));
+  }
 };
 
 ///
@@ -641,7 +762,7 @@ public:
 ///
 /// The larger of two floating point values.
 ///
-class max : public function
+class max : public function, public column_op
 {
 public:
   explicit max(const cvect &c = {0}) : function("FMAX", c[0], {c[0], c[0]})
@@ -666,17 +787,26 @@ public:
     const auto a1(i->fetch_arg(1));
     if (!has_value(a1))  return a1;
 
-    const base_t ret(std::fmax(base(a0), base(a1)));
+    // Same expression of the column kernel (`std::fmax` could return either
+    // zero when comparing `-0.0` and `+0.0`).
+    const base_t v0(base(a0)), v1(base(a1));
+    const base_t ret(v0 < v1 ? v1 : v0);
     if (!std::isfinite(ret))  return {};
 
     return ret;
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    column::max(a[0], a[1], out, n);
+  }
 };
 
 ///
 /// Remainder of the division between real numbers.
 ///
-class mod : public function
+class mod : public function, public column_op
 {
 public:
   explicit mod(const cvect &c = {0}) : function("FMOD", c[0], {c[0], c[0]})
@@ -708,12 +838,19 @@ public:
 
     return ret;
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    for (std::size_t i(0); i < n; ++i)
+      out[i] = finite_or_empty(std::fmod(a[0][i], a[1][i]));
+  }
 };
 
 ///
 /// Product of real numbers.
 ///
-class mul : public function
+class mul : public function, public column_op
 {
 public:
   explicit mul(const cvect &c = {0}) : function("FMUL", c[0], {c[0], c[0]})
@@ -739,12 +876,18 @@ public:
 
     return ret;
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    column::mul(a[0], a[1], out, n);
+  }
 };
 
 ///
 /// sin() of a real number.
 ///
-class sin : public function
+class sin : public function, public column_op
 {
 public:
   explicit sin(const cvect &c = {0}) : function("FSIN", c[0], {c[0]})
@@ -767,12 +910,19 @@ public:
 
     return std::sin(base(a));
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    for (std::size_t i(0); i < n; ++i)
+      out[i] = std::sin(a[0][i]);
+  }
 };
 
 ///
 /// Square root of a real number.
 ///
-class sqrt : public function
+class sqrt : public function, public column_op
 {
 public:
   explicit sqrt(const cvect &c = {0}) : function("FSQRT", c[0], {c[0]})
@@ -799,12 +949,18 @@ public:
 
     return std::sqrt(v);
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    column::sqrt(a[0], out, n);
+  }
 };
 
 ///
 /// Subtraction between real numbers.
 ///
-class sub : public function
+class sub : public function, public column_op
 {
 public:
   explicit sub(const cvect &c = {0}) : function("FSUB", c[0], {c[0], c[0]})
@@ -830,13 +986,19 @@ public:
 
     return ret;
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    column::sub(a[0], a[1], out, n);
+  }
 };
 
 
 ///
 /// Sigmoid function.
 ///
-class sigmoid : public function
+class sigmoid : public function, public column_op
 {
 public:
   explicit sigmoid(const cvect &c = {0}) : function("FSIGMOID", c[0], {c[0]})
@@ -870,6 +1032,17 @@ public:
 
     return std::exp(x) / (1.0 + std::exp(x));
   }
+
+  void eval_column(const base_t *const a[], terminal::param_t, base_t *out,
+                   std::size_t n) const final
+  {
+    for (std::size_t i(0); i < n; ++i)
+    {
+      const auto x(a[0][i]);
+      out[i] = x >= 0.0 ? 1.0 / (1.0 + std::exp(-x))
+                        : std::exp(x) / (1.0 + std::exp(x));
+    }
+  }
 };
 
 }  // namespace vita::real
@@ -0,0 +1,235 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "kernel/src/real_program.h"
+#include "kernel/src/constant.h"
+#include "kernel/src/variable.h"
+
+namespace vita
+{
+///
+/// Appends an instruction to the program.
+///
+/// \param[in] sym  symbol of the instruction
+/// \param[in] par  parameter of the gene
+/// \param[in] args registers of the arguments (the number of elements is
+///                 the arity of `sym`)
+/// \return         `false` if `sym` doesn't support the `double`-only fast
+///                 path (in this case the program is left unchanged)
+///
+/// \remark
+/// Instructions must be appended in execution order. The output of the `i`-th
+/// instruction goes in the `i`-th register.
+///
+bool real_program::push_back(const symbol *sym, terminal::param_t par,
+                             const unsigned args[])
+{
+  Expects(sym);
+
+  instr_ ins;
+  ins.op = nullptr;
+  ins.var = 0;
+  ins.par = par;
+  ins.args = decltype(ins.args)(sym->arity());
+
+  if (const auto *op = dynamic_cast<const column_op *>(sym))
+  {
+    ins.k = kind::op;
+    ins.op = op;
+  }
+  else if (const auto *v = dynamic_cast<const variable *>(sym))
+  {
+    ins.k = kind::var;
+    ins.var = v->index();
+  }
+  else if (const auto *c = dynamic_cast<const constant<D_DOUBLE> *>(sym))
+  {
+    ins.k = kind::constant;
+    ins.par = std::get<D_DOUBLE>(c->eval(nullptr));
+  }
+  else
+    return false;
+
+  for (unsigned i(0); i < sym->arity(); ++i)
+  {
+    assert(args[i] < code_.size());
+    ins.args[i] = args[i];
+  }
+
+  code_.push_back(ins);
+  return true;
+}
+
+///
+/// Removes every instruction (so the fast path is disabled).
+///
+void real_program::clear()
+{
+  code_.clear();
+  regs_.clear();
+  cols_.clear();
+  args_.clear();
+}
+
+///
+/// \return `true` if the program is empty (i.e. the fast path isn't
+///         available)
+///
+bool real_program::empty() const
+{
+  return code_.empty();
+}
+
+///
+/// Executes the program for a group of examples.
+///
+/// \param[in]  n     number of examples
+/// \param[out] out   `out[i]` is the output value for the `i`-th example
+/// \param[in]  known if not `nullptr`, `known[pc]` is either `nullptr` or the
+///                   (already available) output column of the `pc`-th
+///                   instruction. Known columns aren't recomputed
+/// \param[in]  var   `var(v, col)` returns the column of the `v`-th variable
+///                   (possibly filling and returning the buffer `col`) or
+///                   `nullptr` if the values aren't `D_DOUBLE`s
+/// \return           `false` if an input value isn't a `D_DOUBLE`
+///
+template<class F>
+bool real_program::exec(std::size_t n, value_t out[],
+                        const D_DOUBLE *const known[], F var)
+{
+  Expects(!empty());
+
+  regs_.resize(code_.size() * n);
+  cols_.resize(code_.size());
+
+  for (std::size_t pc(0); pc < code_.size(); ++pc)
+  {
+    if (known && known[pc])
+    {
+      cols_[pc] = known[pc];
+      continue;
+    }
+
+    const instr_ &ins(code_[pc]);
+    D_DOUBLE *const col(&regs_[pc * n]);
+    cols_[pc] = col;
+
+    switch (ins.k)
+    {
+    case kind::op:
+    {
+      args_.resize(ins.args.size());
+      for (std::size_t i(0); i < ins.args.size(); ++i)
+        args_[i] = cols_[ins.args[i]];
+
+      ins.op->eval_column(args_.data(), ins.par, col, n);
+      break;
+    }
+
+    case kind::var:
+      if (!(cols_[pc] = var(ins.var, col)))
+        return false;
+      break;
+
+    case kind::constant:
+      std::fill(col, col + n, ins.par);
+      break;
+    }
+  }
+
+  const D_DOUBLE *const res(cols_.back());
+  for (std::size_t r(0); r < n; ++r)
+    out[r] = std::isnan(res[r]) ? value_t() : value_t(res[r]);
+
+  return true;
+}
+
+///
+/// Executes the program for a group of examples.
+///
+/// \param[in]  inputs `inputs[i]` is the input vector of the `i`-th example
+/// \param[in]  n      number of examples
+/// \param[out] out    `out[i]` is the output value for the `i`-th example
+/// \param[in]  known  if not `nullptr`, `known[pc]` is either `nullptr` or
+///                    the (already available) output column of the `pc`-th
+///                    instruction. Known columns aren't recomputed
+/// \return            `false` if an input value isn't a `D_DOUBLE` (the fast
+///                    path cannot be used and `out` is unspecified)
+///
+/// \see column()
+///
+bool real_program::run(const std::vector<value_t> *const inputs[],
+                       std::size_t n, value_t out[],
+                       const D_DOUBLE *const known[])
+{
+  constexpr auto nan(std::numeric_limits<D_DOUBLE>::quiet_NaN());
+
+  return exec(n, out, known,
+              [&](unsigned v, D_DOUBLE *col) -> const D_DOUBLE *
+              {
+                for (std::size_t r(0); r < n; ++r)
+                {
+                  const value_t &x((*inputs[r])[v]);
+
+                  if (const auto *d = std::get_if<D_DOUBLE>(&x))
+                    col[r] = *d;
+                  else if (!has_value(x))
+                    col[r] = nan;
+                  else
+                    return nullptr;
+                }
+
+                return col;
+              });
+}
+
+///
+/// Executes the program for a group of examples stored by columns.
+///
+/// \param[in]  vars `vars[v]` is the column (`n` elements, `NaN` for the empty
+///                  value) of the `v`-th variable or `nullptr` if the
+///                  variable doesn't contain `D_DOUBLE`s
+/// \param[in]  n    number of examples
+/// \param[out] out  `out[i]` is the output value for the `i`-th example
+/// \return          `false` if a used variable isn't a `D_DOUBLE` column (the
+///                  fast path cannot be used and `out` is unspecified)
+///
+/// Variables are read directly from their columns (no copy is performed).
+///
+/// \see columnar_dataframe
+///
+bool real_program::run(const D_DOUBLE *const vars[], std::size_t n,
+                       value_t out[])
+{
+  return exec(n, out, nullptr,
+              [vars](unsigned v, D_DOUBLE *) { return vars[v]; });
+}
+
+///
+/// \param[in] pc index of an instruction
+/// \return       the output column of the `pc`-th instruction computed by the
+///               last call of `run()`
+///
+/// \remark
+/// The column is valid until the next call of `run()`.
+///
+const D_DOUBLE *real_program::column(std::size_t pc) const
+{
+  Expects(pc < cols_.size());
+  return cols_[pc];
+}
+
+}  // namespace vita
@@ -0,0 +1,101 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_SRC_REAL_PROGRAM_H)
+#define      VITA_SRC_REAL_PROGRAM_H
+
+#include "kernel/gene.h"
+#include "kernel/terminal.h"
+
+namespace vita
+{
+///
+/// Interface of the symbols that can be evaluated directly on raw
+/// floating-point values.
+///
+/// Values are organized in columns (one element per example). `NaN` encodes
+/// the *empty* value.
+///
+/// \see real_program
+///
+class column_op
+{
+public:
+  /// \param[in]  args columns of the arguments (`args[i][j]` is the value of
+  ///                  the `i`-th argument for the `j`-th example)
+  /// \param[in]  p    the parameter of the gene (used by parametric terminals)
+  /// \param[out] out  output column
+  /// \param[in]  n    number of examples (length of every column)
+  virtual void eval_column(const D_DOUBLE *const args[], terminal::param_t p,
+                           D_DOUBLE *out, std::size_t n) const = 0;
+
+protected:
+  ~column_op() = default;
+};
+
+///
+/// The active code of a program translated for the `double`-only fast path.
+///
+/// When every active symbol of a program is a vita::column_op, a
+/// vita::variable or a `constant<D_DOUBLE>`, the program can be executed
+/// without the `value_t` boxing and the `std::variant` tag checks. This is
+/// the typical situation for symbolic regression.
+///
+/// \remark
+/// A `NaN` value, as far as the fast path is concerned, is an empty value. The
+/// general interpreter could, in some corner cases (e.g. `cos(inf)`), return
+/// a `NaN` value instead of an empty one.
+///
+class real_program
+{
+public:
+  bool push_back(const symbol *, terminal::param_t, const unsigned []);
+  void clear();
+  bool empty() const;
+
+  bool run(const std::vector<value_t> *const [], std::size_t, value_t [],
+           const D_DOUBLE *const [] = nullptr);
+  bool run(const D_DOUBLE *const [], std::size_t, value_t []);
+  const D_DOUBLE *column(std::size_t) const;
+
+private:
+  template<class F> bool exec(std::size_t, value_t [], const D_DOUBLE *const [],
+                              F);
+
+  enum class kind {op, var, constant};
+
+  struct instr_
+  {
+    kind k;
+    const column_op *op;
+    unsigned var;
+    terminal::param_t par;  // gene's parameter / value of a constant
+    small_vector<unsigned, gene::k_args> args;
+  };
+
+  std::vector<instr_> code_;
+
+  // `regs_[r * n + row]` is the content of register `r` for the `row`-th
+  // example (`n` is the number of examples).
+  std::vector<D_DOUBLE> regs_;
+
+  // `cols_[r]` points to the content of register `r` (usually inside `regs_`
+  // but it could be a column supplied by the user).
+  std::vector<const D_DOUBLE *> cols_;
+
+  // Columns of the arguments of the current instruction.
+  std::vector<const D_DOUBLE *> args_;
+};
+
+}  // namespace vita
+
+#endif  // include guard
@@ -65,6 +65,9 @@ public:
 
   src_search &evaluator(evaluator_id, const std::string & = "");
   src_search &validation_strategy(validator_id);
+  src_search &validation_strategy(const chunked_dataframe &);
+
+  hash_t fingerprint() const override;
 
   bool debug() const override;
 
@@ -101,6 +104,11 @@ private:
 
   // Metrics we have to calculate during the search.
   metric_flags metrics;
+
+  // Signature of the training data and version (see `dataframe::version`) of
+  // the training set it refers to (`0` if not yet calculated).
+  mutable std::uintmax_t data_version_;
+  mutable hash_t data_fingerprint_;
 };
 
 #include "kernel/src/search.tcc"
@@ -32,7 +32,8 @@ constexpr std::underlying_type_t<metric_flags> operator&(metric_flags f1,
 template<class T, template<class> class ES>
 src_search<T, ES>::src_search(src_problem &p, metric_flags m)
   : search<T, ES>(p),
-    p_symre(evaluator_id::rmae), p_class(evaluator_id::gaussian), metrics(m)
+    p_symre(evaluator_id::rmae), p_class(evaluator_id::gaussian), metrics(m),
+    data_version_(0), data_fingerprint_()
 {
   Expects(p.debug());
 
@@ -95,6 +96,82 @@ std::unique_ptr<basic_src_lambda_f> src_search<T, ES>::lambdify(
   return std::unique_ptr<basic_src_lambda_f>(p);
 }
 
+///
+/// \return a signature of the training data, of the training evaluator and
+///         of the symbol set
+///
+/// The signature of the training data is calculated once per training set
+/// (it's recalculated only when `dataframe::version` changes): every example
+/// is hashed, in order, from the raw bytes of its values.
+///
+/// \see search::fingerprint
+///
+template<class T, template<class> class ES>
+hash_t src_search<T, ES>::fingerprint() const
+{
+  const auto &d(training_data());
+
+  if (data_version_ != d.version())
+  {
+    // Buffer containing the signature of the previous examples followed by
+    // the values of the current one (so the signature depends on the order
+    // of the examples).
+    std::vector<unsigned char> buf;
+
+    const auto append([&buf](const void *p, std::size_t n)
+    {
+      const auto *b(static_cast<const unsigned char *>(p));
+      buf.insert(buf.end(), b, b + n);
+    });
+
+    const auto pack([&](const value_t &v)
+    {
+      const auto type(static_cast<unsigned char>(v.index()));
+      append(&type, sizeof(type));
+
+      switch (v.index())
+      {
+      case d_int:
+        append(&std::get<D_INT>(v), sizeof(D_INT));
+        break;
+
+      case d_double:
+        append(&std::get<D_DOUBLE>(v), sizeof(D_DOUBLE));
+        break;
+
+      case d_string:
+      {
+        const auto &str(std::get<D_STRING>(v));
+        const std::uint64_t len(str.size());
+        append(&len, sizeof(len));
+        append(str.data(), str.size());
+        break;
+      }
+      }
+    });
+
+    hash_t h;
+    for (const auto &e : d)
+    {
+      buf.clear();
+      append(h.data, sizeof(h.data));
+
+      for (const auto &v : e.input)
+        pack(v);
+      pack(e.output);
+
+      h = hash::hash128(buf.data(), buf.size());
+    }
+
+    data_fingerprint_ = h;
+    data_version_ = d.version();
+  }
+
+  auto ret(search<T, ES>::fingerprint());
+  ret.combine(data_fingerprint_);
+  return ret;
+}
+
 template<class T, template<class> class ES>
 bool src_search<T, ES>::can_validate() const
 {
@@ -426,15 +503,78 @@ src_search<T, ES> &src_search<T, ES>::validation_strategy(validator_id id)
   return *this;
 }
 
+///
+/// Activates the DSS validation strategy on a disk-resident dataset.
+///
+/// \param[in] source the available examples
+/// \return           a reference to the search class (used for method
+///                   chaining)
+///
+/// The training / validation sets are subsets of `source` (see
+/// vita::chunked_dss) selected at the beginning of every run.
+///
+/// \remark
+/// Parameters tuning and symbol set need some examples: the problem can be
+/// initialized with the first chunk of `source` (see
+/// `chunked_dataframe::load`).
+///
+template<class T, template<class> class ES>
+src_search<T, ES> &src_search<T, ES>::validation_strategy(
+  const chunked_dataframe &source)
+{
+  assert(this->eva1_);
+  assert(this->eva2_);
+  search<T, ES>::template validation_strategy<chunked_dss>(
+    prob(), source, *this->eva1_, *this->eva2_);
+
+  return *this;
+}
+
 template<class T, template<class> class ES>
 template<class E, class... Args>
 void src_search<T, ES>::set_evaluator(Args && ...args)
 {
-  search<T, ES>::template training_evaluator<E>(
-    training_data(), std::forward<Args>(args)...);
+  const auto make([this, args...](dataframe &d)
+  {
+    E ret([&]
+    {
+      // Incremental evaluation of the offspring is only useful for the
+      // training evaluator (the validation evaluator works on the best
+      // individuals).
+      if constexpr (std::is_base_of_v<sum_of_errors_evaluator<T>, E>
+                    && sizeof...(Args) == 0)
+        return E(d, std::size_t(prob().env.column_store_size) << 20,
+                 std::size_t(prob().env.output_store_size) << 20);
+      else
+        return E(d, args...);
+    }());
+
+    ret.threads(prob().env.threads);
+    return ret;
+  });
+
+  E validation(validation_data(), std::forward<Args>(args)...);
+  validation.threads(prob().env.threads);
+
+  search<T, ES>::template training_evaluator<E>(make(training_data()));
+  search<T, ES>::template validation_evaluator<E>(std::move(validation));
+
+  // Evaluators update the difficulty of the examples: every concurrent run
+  // works on its own copy of the training set.
+  this->eva1_factory_ = [this, make]
+  {
+    struct worker
+    {
+      dataframe data;
+      std::unique_ptr<vita::evaluator<T>> eva;
+    };
+
+    auto w(std::make_shared<worker>());
+    w->data = training_data();
+    w->eva = this->with_cache(make(w->data));
 
-  search<T, ES>::template validation_evaluator<E>(
-    validation_data(), std::forward<Args>(args)...);
+    return std::shared_ptr<vita::evaluator<T>>(w, w->eva.get());
+  };
 }
 
 ///
@@ -32,6 +32,9 @@ public:
 
   bool input() const override { return true; }
 
+  /// \return the index of the variable in the input vector
+  unsigned index() const { return var_; }
+
   /// \return the name of the variable
   std::string display(terminal::param_t, format) const final
   { return name(); }
@@ -53,6 +53,12 @@ public:
   ///
   /// \note Called at the end of the evolution (one time per run).
   virtual void close(unsigned /* run */) {}
+
+  /// \return `true` if the training environment doesn't change during a run
+  ///         (i.e. `shake` never changes it)
+  ///
+  /// Only such strategies allow concurrent runs (see search::run).
+  virtual bool concurrent() const { return true; }
 };
 
 ///
@@ -21,6 +21,8 @@ class i_mep;
 class i_ga;
 template<class T> class team;
 
+struct gene_outputs;
+
 template<class T> class interpreter;
 
 template<class T> class evaluator;
@@ -38,6 +40,7 @@ template<class T,
          template<class> class RS> class evolution_strategy;
 template<class T, template<class> class CS> class basic_alps_es;
 template<class T> class std_es;
+template<class T> class island_es;
 
 template<class T, template<class> class ES> class src_search;
 
@@ -0,0 +1,197 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <cctype>
+#include <limits>
+
+#include "kernel/wire.h"
+
+namespace vita::wire
+{
+
+namespace
+{
+
+const char magic[] = "VMG";
+constexpr unsigned char version = 1;
+
+enum token_tag : unsigned char {integer_tag = 0, string_tag = 1};
+
+// Checks if `s` is the canonical representation of a 64 bit integer (i.e.
+// `std::to_string` gives back the same string).
+bool canonical_integer(const std::string &s, std::int64_t *v)
+{
+  const bool neg(s[0] == '-');
+  const std::size_t digits(s.length() - neg);
+
+  if (digits == 0 || digits > 18)
+    return false;
+  if (s[neg] == '0' && (digits > 1 || neg))
+    return false;
+
+  std::int64_t x(0);
+  for (std::size_t i(neg); i < s.length(); ++i)
+  {
+    if (!std::isdigit(static_cast<unsigned char>(s[i])))
+      return false;
+
+    x = 10 * x + (s[i] - '0');
+  }
+
+  *v = neg ? -x : x;
+  return true;
+}
+
+}  // unnamed namespace
+
+namespace detail
+{
+
+void put_varint(std::string *out, std::uint64_t v)
+{
+  while (v >= 0x80)
+  {
+    out->push_back(static_cast<char>((v & 0x7f) | 0x80));
+    v >>= 7;
+  }
+
+  out->push_back(static_cast<char>(v));
+}
+
+bool get_varint(const std::string &in, std::size_t *pos, std::uint64_t *v)
+{
+  std::uint64_t ret(0);
+
+  for (unsigned shift(0); *pos < in.size() && shift < 64; shift += 7)
+  {
+    const auto byte(static_cast<unsigned char>(in[(*pos)++]));
+    ret |= std::uint64_t(byte & 0x7f) << shift;
+
+    if (!(byte & 0x80))
+    {
+      *v = ret;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void put_header(std::string *out, std::size_t count)
+{
+  out->append(magic, sizeof(magic) - 1);
+  out->push_back(static_cast<char>(version));
+  put_varint(out, count);
+}
+
+bool get_header(const std::string &in, std::size_t *pos, std::size_t *count)
+{
+  const std::size_t n(sizeof(magic) - 1);
+
+  if (in.size() <= n || in.compare(0, n, magic) != 0
+      || static_cast<unsigned char>(in[n]) != version)
+    return false;
+
+  *pos = n + 1;
+
+  std::uint64_t c;
+  if (!get_varint(in, pos, &c) || c > in.size())
+    return false;
+
+  *count = static_cast<std::size_t>(c);
+  return true;
+}
+
+}  // namespace detail
+
+///
+/// \param[in] text serialized individual (see individual::save)
+/// \return         the binary representation of `text`
+///
+/// \remark
+/// Whitespaces aren't preserved: the decoded text contains the same tokens
+/// separated by single spaces (that's enough for the `load` functions).
+///
+std::string encode(const std::string &text)
+{
+  std::string ret;
+  ret.reserve(text.size() / 2);
+
+  std::istringstream in(text);
+  std::string token;
+  while (in >> token)
+  {
+    std::int64_t v;
+    if (canonical_integer(token, &v))
+    {
+      ret.push_back(integer_tag);
+
+      // Zigzag encoding: small negative values get short varints too.
+      detail::put_varint(&ret, (static_cast<std::uint64_t>(v) << 1)
+                               ^ static_cast<std::uint64_t>(v >> 63));
+    }
+    else
+    {
+      ret.push_back(string_tag);
+      detail::put_varint(&ret, token.size());
+      ret += token;
+    }
+  }
+
+  return ret;
+}
+
+///
+/// \param[in]  bin  a binary string produced by `encode`
+/// \param[out] text the decoded text
+/// \return          `true` if `bin` is well formed
+///
+bool decode(const std::string &bin, std::string *text)
+{
+  Expects(text);
+
+  std::string ret;
+  for (std::size_t pos(0); pos < bin.size();)
+  {
+    if (!ret.empty())
+      ret.push_back(' ');
+
+    const auto tag(static_cast<unsigned char>(bin[pos++]));
+
+    std::uint64_t v;
+    if (!detail::get_varint(bin, &pos, &v))
+      return false;
+
+    switch (tag)
+    {
+    case integer_tag:
+      ret += std::to_string(static_cast<std::int64_t>(v >> 1)
+                            ^ -static_cast<std::int64_t>(v & 1));
+      break;
+
+    case string_tag:
+      if (v > bin.size() - pos)
+        return false;
+      ret.append(bin, pos, v);
+      pos += v;
+      break;
+
+    default:
+      return false;
+    }
+  }
+
+  *text = ret;
+  return true;
+}
+
+}  // namespace vita::wire
@@ -0,0 +1,51 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_WIRE_H)
+#define      VITA_WIRE_H
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "kernel/symbol_set.h"
+
+///
+/// Compact binary format used to move individuals between processes.
+///
+/// The format is built on top of the (textual) serialization of individuals
+/// and teams (`save` / `load` member functions), which remains the single
+/// description of their layout. The text is split in whitespace separated
+/// tokens and every token is stored as:
+/// - `0x00` followed by a zigzag / LEB128 varint, if it's an integer (most
+///   of the tokens: opcodes, loci, ages...);
+/// - `0x01` followed by a varint length and the raw characters, otherwise.
+///
+/// A *frame* groups many encoded individuals:
+///
+///     "VMG" version varint(count) [varint(length) encoded-individual]...
+///
+namespace vita::wire
+{
+
+std::string encode(const std::string &);
+bool decode(const std::string &, std::string *);
+
+template<class T> std::string pack(const std::vector<T> &);
+template<class T> bool unpack(const std::string &, const symbol_set &,
+                              std::vector<T> *);
+
+#include "kernel/wire.tcc"
+
+}  // namespace vita::wire
+
+#endif  // include guard
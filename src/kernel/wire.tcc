@@ -0,0 +1,96 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_WIRE_H)
+#  error "Don't include this file directly, include the specific .h instead"
+#endif
+
+#if !defined(VITA_WIRE_TCC)
+#define      VITA_WIRE_TCC
+
+namespace detail
+{
+void put_header(std::string *, std::size_t);
+void put_varint(std::string *, std::uint64_t);
+bool get_header(const std::string &, std::size_t *, std::size_t *);
+bool get_varint(const std::string &, std::size_t *, std::uint64_t *);
+}
+
+///
+/// \param[in] v individuals (or teams) to be sent
+/// \return      a frame containing the encoded individuals
+///
+template<class T>
+std::string pack(const std::vector<T> &v)
+{
+  std::string ret;
+  detail::put_header(&ret, v.size());
+
+  for (const auto &prg : v)
+  {
+    std::ostringstream ss;
+    prg.save(ss);
+
+    const auto bin(encode(ss.str()));
+    detail::put_varint(&ret, bin.size());
+    ret += bin;
+  }
+
+  return ret;
+}
+
+///
+/// \param[in]  frame a frame produced by `pack`
+/// \param[in]  ss    the active symbol set
+/// \param[out] v     the decoded individuals (or teams)
+/// \return           `true` if the whole frame has been decoded correctly
+///
+/// If the operation fails `v` isn't modified.
+///
+template<class T>
+bool unpack(const std::string &frame, const symbol_set &ss,
+            std::vector<T> *v)
+{
+  Expects(v);
+
+  std::size_t pos, count;
+  if (!detail::get_header(frame, &pos, &count))
+    return false;
+
+  std::vector<T> ret;
+  for (std::size_t i(0); i < count; ++i)
+  {
+    std::uint64_t n;
+    if (!detail::get_varint(frame, &pos, &n) || n > frame.size() - pos)
+      return false;
+
+    std::string text;
+    if (!decode(frame.substr(pos, n), &text))
+      return false;
+    pos += n;
+
+    std::istringstream in(text);
+    T prg;
+    if (!prg.load(in, ss))
+      return false;
+
+    ret.push_back(prg);
+  }
+
+  if (pos != frame.size())
+    return false;
+
+  *v = ret;
+  return true;
+}
+
+#endif  // include guard
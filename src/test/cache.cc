@@ -10,13 +10,19 @@
  *  You can obtain one at http://mozilla.org/MPL/2.0/
  */
 
+#include <algorithm>
 #include <cstdlib>
+#include <fstream>
+#include <numeric>
 #include <sstream>
+#include <thread>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "third_party/doctest/doctest.h"
 
 #include "kernel/cache.h"
+#include "kernel/concurrent_cache.h"
+#include "kernel/persistent_cache.h"
 #include "kernel/i_mep.h"
 #include "kernel/interpreter.h"
 #include "kernel/problem.h"
@@ -52,13 +58,13 @@ TEST_CASE("Murmur Hash")
   {
     key[i] = static_cast<byte>(i);
 
-    auto h(vita::hash::hash128(key, i, 256 - i));
+    auto h(vita::murmurhash3::hash128(key, i, 256 - i));
     reinterpret_cast<std::uint64_t *>(&hashes[i * hashbytes])[0] = h.data[0];
     reinterpret_cast<std::uint64_t *>(&hashes[i * hashbytes])[1] = h.data[1];
   }
 
   // Then hash the result array.
-  auto h(vita::hash::hash128(hashes, hashbytes * 256, 0));
+  auto h(vita::murmurhash3::hash128(hashes, hashbytes * 256, 0));
   reinterpret_cast<std::uint64_t *>(final)[0] = h.data[0];
   reinterpret_cast<std::uint64_t *>(final)[1] = h.data[1];
 
@@ -78,6 +84,87 @@ TEST_CASE("Murmur Hash")
   CHECK(verification == 0x6384BA69);
 }  // TEST_CASE("Murmur Hash")
 
+TEST_CASE("Mulx Hash")
+{
+  using vita::hash_t;
+  using vita::mulxhash;
+
+  // Long enough to involve more than one block of stripes.
+  std::vector<unsigned char> key(2200);
+  std::iota(key.begin(), key.end(), 0);
+
+  const auto same([](hash_t h1, hash_t h2) { return h1 == h2; });
+
+  SUBCASE("Distinct prefixes and seeds")
+  {
+    std::vector<hash_t> hashes;
+    for (std::size_t len(0); len <= key.size(); ++len)
+    {
+      const auto h(mulxhash::hash128(key.data(), len));
+      CHECK(h == mulxhash::hash128(key.data(), len));
+      CHECK(h != mulxhash::hash128(key.data(), len, 1));
+
+      hashes.push_back(h);
+    }
+
+    std::sort(hashes.begin(), hashes.end(),
+              [](hash_t h1, hash_t h2)
+              {
+                return h1.data[0] < h2.data[0]
+                       || (h1.data[0] == h2.data[0] && h1.data[1] < h2.data[1]);
+              });
+    CHECK(std::adjacent_find(hashes.begin(), hashes.end(), same)
+          == hashes.end());
+  }
+
+  SUBCASE("Unaligned data")
+  {
+    std::vector<unsigned char> shifted(key.size() + 1);
+
+    for (std::size_t len : {3u, 7u, 16u, 33u, 128u, 129u, 600u, 1500u})
+    {
+      std::copy(key.begin(), key.begin() + len, shifted.begin() + 1);
+      CHECK(mulxhash::hash128(key.data(), len)
+            == mulxhash::hash128(shifted.data() + 1, len));
+    }
+  }
+
+  SUBCASE("Avalanche")
+  {
+    const auto popcount([](std::uint64_t x)
+                        {
+                          unsigned n(0);
+                          for (; x; x &= x - 1)
+                            ++n;
+                          return n;
+                        });
+
+    for (std::size_t len : {1u, 3u, 8u, 12u, 16u, 17u, 40u, 128u, 256u,
+                            600u, 2100u})
+    {
+      std::vector<unsigned char> k(key.begin(), key.begin() + len);
+      const auto h(mulxhash::hash128(k.data(), len));
+
+      unsigned min_changed(128), total(0);
+      for (std::size_t bit(0); bit < len * 8; ++bit)
+      {
+        k[bit / 8] ^= 1u << (bit % 8);
+        const auto h1(mulxhash::hash128(k.data(), len));
+        k[bit / 8] ^= 1u << (bit % 8);
+
+        const auto changed(popcount(h.data[0] ^ h1.data[0])
+                           + popcount(h.data[1] ^ h1.data[1]));
+        min_changed = std::min(min_changed, changed);
+        total += changed;
+      }
+
+      // About half of the output bits should change for every flipped bit.
+      CHECK(min_changed >= 32);
+      CHECK(total / double(len * 8) == doctest::Approx(64.0).epsilon(0.1));
+    }
+  }
+}
+
 
 TEST_CASE_FIXTURE(fixture2, "Insert/Find cycle")
 {
@@ -176,6 +263,400 @@ TEST_CASE_FIXTURE(fixture2, "Serialization")
     }
 }
 
+TEST_CASE("Partial results")
+{
+  using namespace vita;
+
+  cache cache(14);
+  const hash_t h(123, 345);
+  const fitness_t bound{-10.0}, exact{-5.0};
+
+  cache.insert(h, bound, true);
+  CHECK(!cache.find(h).size());
+
+  bool partial(false);
+  CHECK(cache.find(h, &partial) == bound);
+  CHECK(partial);
+
+  cache.insert(h, exact);
+  CHECK(cache.find(h) == exact);
+  CHECK(cache.find(h, &partial) == exact);
+  CHECK(!partial);
+
+  // Partial results aren't serialized.
+  cache.insert(h, bound, true);
+  std::stringstream ss;
+  CHECK(cache.save(ss));
+
+  vita::cache cache2(14);
+  CHECK(cache2.load(ss));
+  CHECK(!cache2.find(h, &partial).size());
+}
+
+TEST_CASE("Set-associative replacement")
+{
+  using namespace vita;
+
+  const fitness_t f{1.0};
+
+  // 16 slots. Signatures built by `sig` belong to the same set.
+  const auto sig([](std::uint64_t k) { return hash_t(k << 4, k); });
+
+  cache c4(4, 4);
+  CHECK(c4.ways() == 4);
+
+  // A frequently requested individual...
+  c4.insert(sig(1), f);
+  CHECK(c4.find(sig(1)) == f);
+
+  // ... survives a flood of one-off individuals.
+  for (unsigned k(2); k <= 100; ++k)
+    c4.insert(sig(k), f);
+  CHECK(c4.find(sig(1)) == f);
+  CHECK(c4.find(sig(100)) == f);
+  CHECK(!c4.find(sig(96)).size());
+  CHECK(c4.evictions() == 96);
+
+  // Updating an entry isn't an eviction.
+  c4.insert(sig(100), fitness_t{2.0});
+  CHECK(c4.evictions() == 96);
+  CHECK(c4.find(sig(100)) == fitness_t{2.0});
+
+  // When every slot has been hit the least recently used is replaced.
+  CHECK(c4.find(sig(99)) == f);
+  CHECK(c4.find(sig(98)) == f);
+  CHECK(c4.find(sig(1)) == f);
+  c4.insert(sig(101), f);
+  CHECK(!c4.find(sig(100)).size());
+
+  // Stale slots are reused without evictions.
+  c4.clear();
+  CHECK(c4.evictions() == 0);
+  for (unsigned k(1); k <= 4; ++k)
+    c4.insert(sig(k), f);
+  CHECK(c4.evictions() == 0);
+  for (unsigned k(1); k <= 4; ++k)
+    CHECK(c4.find(sig(k)) == f);
+
+  // A direct-mapped table.
+  cache c1(4, 1);
+  c1.insert(sig(1), f);
+  CHECK(c1.find(sig(1)) == f);
+  c1.insert(sig(2), f);
+  CHECK(!c1.find(sig(1)).size());
+  CHECK(c1.evictions() == 1);
+}
+
+TEST_CASE("Resize")
+{
+  using namespace vita;
+
+  const auto sig([](std::uint64_t k)
+                 {
+                   return hash_t(k * 0x9e3779b97f4a7c15, k);
+                 });
+
+  cache c(10, 4);
+  CHECK(c.bits() == 10);
+  CHECK(c.live() == 0);
+
+  for (unsigned k(1); k <= 500; ++k)
+    c.insert(sig(k), fitness_t{static_cast<double>(k)});
+  const auto before(c.live());
+
+  SUBCASE("Growing")
+  {
+    c.resize(12);
+    CHECK(c.bits() == 12);
+    CHECK(c.debug());
+    CHECK(c.live() == before);
+
+    for (unsigned k(1); k <= 500; ++k)
+      if (const auto f = c.find(sig(k)); f.size())
+        CHECK(f == fitness_t{static_cast<double>(k)});
+  }
+
+  SUBCASE("Shrinking")
+  {
+    CHECK(c.find(sig(1)).size());  // hit entries are preferred
+    const auto evictions(c.evictions());
+
+    c.resize(4);
+    CHECK(c.bits() == 4);
+    CHECK(c.debug());
+    CHECK(c.live() == 16);
+    CHECK(c.evictions() == evictions);
+
+    CHECK(c.find(sig(1)) == fitness_t{1.0});
+    CHECK(c.find(sig(500)) == fitness_t{500.0});
+  }
+}
+
+TEST_CASE("Adaptive sizing")
+{
+  using namespace vita;
+
+  const fitness_t f{1.0};
+
+  cache c(10, 4);
+  const auto budget(c.bytes() * 4);
+
+  // Looks for the individuals in `[first, last)` inserting the missing ones.
+  const auto probe([&c, &f](std::uint64_t first, std::uint64_t last)
+                   {
+                     for (auto k(first); k < last; ++k)
+                       if (const hash_t h(k * 0x9e3779b97f4a7c15, k);
+                           !c.find(h).size())
+                         c.insert(h, f);
+                   });
+
+  // Not enough statistics.
+  probe(1, 100);
+  CHECK(c.adapt(budget).empty());
+  CHECK(c.bits() == 10);
+
+  // Thrashing.
+  probe(100, 5000);
+  CHECK(!c.adapt(budget).empty());
+  CHECK(c.bits() == 11);
+  probe(5000, 10000);
+  CHECK(!c.adapt(budget).empty());
+  CHECK(c.bits() == 12);
+
+  // ... but within the budget.
+  probe(10000, 20000);
+  CHECK(c.adapt(budget).empty());
+  CHECK(c.bits() == 12);
+
+  // Over budget.
+  probe(20000, 20500);
+  CHECK(!c.adapt(budget / 2).empty());
+  CHECK(c.bits() == 11);
+
+  // Mostly empty table.
+  c.clear();
+  for (std::uint64_t k(0); k < 1000; ++k)
+    CHECK(!c.find(hash_t(k, k)).size());
+  CHECK(!c.adapt(budget).empty());
+  CHECK(c.bits() == 10);
+
+  // Never below the minimum size.
+  for (std::uint64_t k(0); k < 1000; ++k)
+    CHECK(!c.find(hash_t(k, k)).size());
+  CHECK(c.adapt(budget).empty());
+  CHECK(c.bits() == 10);
+}
+
+TEST_CASE("Concurrent cache")
+{
+  using namespace vita;
+
+  concurrent_cache cache(14);
+  const hash_t h(123, 345);
+  const fitness_t bound{-10.0}, exact{-5.0, 2.0};
+
+  CHECK(!cache.find(h).size());
+
+  cache.insert(h, bound, true);
+  CHECK(!cache.find(h).size());
+
+  bool partial(false);
+  CHECK(cache.find(h, &partial) == bound);
+  CHECK(partial);
+
+  cache.insert(h, exact);
+  CHECK(cache.find(h) == exact);
+  CHECK(cache.find(h, &partial) == exact);
+  CHECK(!partial);
+
+  CHECK(cache.probes() == 5);
+  CHECK(cache.hits() == 3);
+
+  // Too many components.
+  const hash_t h2(321, 543);
+  cache.insert(h2, fitness_t(with_size(concurrent_cache::k_components + 1)));
+  CHECK(!cache.find(h2).size());
+
+  cache.clear(h);
+  CHECK(!cache.find(h).size());
+
+  cache.insert(h, exact);
+  cache.clear();
+  CHECK(!cache.find(h).size());
+  CHECK(cache.probes() == 1);
+  CHECK(cache.hits() == 0);
+
+  // Same format of the `cache` class.
+  cache.insert(h, exact);
+  cache.insert(h2, bound, true);
+  std::stringstream ss;
+  CHECK(cache.save(ss));
+
+  vita::cache cache2(14);
+  CHECK(cache2.load(ss));
+  CHECK(cache2.find(h) == exact);
+  CHECK(!cache2.find(h2, &partial).size());
+
+  ss.str("");
+  ss.clear();
+  CHECK(cache2.save(ss));
+  concurrent_cache cache3(14);
+  CHECK(cache3.load(ss));
+  CHECK(cache3.find(h) == exact);
+}
+
+TEST_CASE("Concurrent cache (multithreading)")
+{
+  using namespace vita;
+
+  // A small table: slots are often overwritten while being read.
+  concurrent_cache cache(8);
+
+  // Every signature identifies a fitness: readers must never see a mix.
+  const auto fit([](std::uint64_t k)
+  {
+    return fitness_t{double(k), -double(k), double(k) * 2.0};
+  });
+
+  const unsigned threads(4), n(20000);
+  std::vector<std::uintmax_t> hits(threads), errors(threads);
+
+  std::vector<std::thread> pool;
+  for (unsigned t(0); t < threads; ++t)
+    pool.emplace_back([&, t]
+    {
+      for (unsigned i(0); i < n; ++i)
+      {
+        const std::uint64_t k((i * 7 + t) % 300 + 1);
+        const hash_t h(k, k * 31);
+
+        if (const auto f(cache.find(h)); f.size())
+        {
+          ++hits[t];
+          if (f != fit(k))
+            ++errors[t];
+        }
+        else
+          cache.insert(h, fit(k));
+      }
+    });
+
+  for (auto &th : pool)
+    th.join();
+
+  CHECK(std::accumulate(errors.begin(), errors.end(), std::uintmax_t(0)) == 0);
+  CHECK(cache.probes() == threads * n);
+  CHECK(cache.hits()
+        == std::accumulate(hits.begin(), hits.end(), std::uintmax_t(0)));
+  CHECK(cache.hits() > 0);
+}
+
+TEST_CASE("Persistent cache")
+{
+  using namespace vita;
+
+  const auto file(std::filesystem::temp_directory_path()
+                  / "vita_persistent_cache.bin");
+  std::filesystem::remove(file);
+
+  const hash_t fp1(1, 2), fp2(3, 4);
+  const hash_t h1(123, 345), h2(124, 346), h3(125, 347);
+  const fitness_t f1{-1.0, 2.0}, f2{-3.0}, bound{-10.0};
+
+  {
+    persistent_cache c(10);
+    CHECK(!c.is_open());
+
+    // In memory.
+    c.insert(h1, f1);
+    CHECK(c.find(h1) == f1);
+
+    REQUIRE(c.open(file, fp1));
+    CHECK(c.is_open());
+    CHECK(!c.find(h1).size());
+
+    c.insert(h1, f1);
+    c.insert(h2, f2);
+    c.insert(h3, bound, true);
+    CHECK(c.find(h1) == f1);
+
+    // Only one user at a time.
+    persistent_cache c2(10);
+    CHECK(!c2.open(file, fp1));
+  }
+
+  SUBCASE("Warm restart")
+  {
+    persistent_cache c(10);
+    REQUIRE(c.open(file, fp1));
+
+    CHECK(c.find(h1) == f1);
+    CHECK(c.find(h2) == f2);
+    CHECK(!c.find(h3).size());
+
+    bool partial;
+    CHECK(c.find(h3, &partial) == bound);
+    CHECK(partial);
+
+    c.clear(h2);
+    CHECK(!c.find(h2).size());
+    c.clear();
+    CHECK(!c.find(h1).size());
+  }
+
+  SUBCASE("Different fingerprint")
+  {
+    persistent_cache c(10);
+    REQUIRE(c.open(file, fp2));
+    CHECK(!c.find(h1).size());
+    CHECK(!c.find(h2).size());
+    c.close();
+
+    REQUIRE(c.open(file, fp1));
+    CHECK(!c.find(h1).size());
+  }
+
+  SUBCASE("Different size")
+  {
+    persistent_cache c(11);
+    REQUIRE(c.open(file, fp1));
+    CHECK(!c.find(h1).size());
+  }
+
+  SUBCASE("Partial writes")
+  {
+    const auto slot_offset([](const hash_t &h)
+    {
+      return 64 + 64 * (h.data[0] & 1023);
+    });
+
+    // A slot interrupted in the middle of a write...
+    {
+      std::fstream f(file, std::ios::in | std::ios::out | std::ios::binary);
+      f.seekp(slot_offset(h1) + 20);
+      f.put('\x55');
+    }
+
+    persistent_cache c(10);
+    REQUIRE(c.open(file, fp1));
+    CHECK(!c.find(h1).size());
+    CHECK(c.find(h2) == f2);
+    c.close();
+
+    // ... and a damaged header.
+    {
+      std::fstream f(file, std::ios::in | std::ios::out | std::ios::binary);
+      f.seekp(12);
+      f.put('\x55');
+    }
+
+    REQUIRE(c.open(file, fp1));
+    CHECK(!c.find(h2).size());
+  }
+
+  std::filesystem::remove(file);
+}
+
 TEST_CASE("Type hash_t")
 {
   const vita::hash_t empty;
@@ -10,6 +10,7 @@
  *  You can obtain one at http://mozilla.org/MPL/2.0/
  */
 
+#include <random>
 #include <sstream>
 
 #include "utility/csv_parser.h"
@@ -309,4 +310,131 @@ TEST_CASE("Sniffer")
   CHECK(csv6.dialect().has_header == true);
 }
 
+TEST_CASE("Block parser")
+{
+  using namespace vita;
+
+  using records = std::vector<csv_parser::record_t>;
+
+  const auto reference([](const std::string &data, const csv_dialect &d,
+                          csv_parser::filter_hook_t filter)
+                       {
+                         std::istringstream is(data);
+                         records ret;
+                         for (const auto &r :
+                                csv_parser(is, d).filter_hook(filter))
+                           ret.push_back(r);
+                         return ret;
+                       });
+
+  const auto blocks([](const std::string &data, const csv_dialect &d,
+                       csv_parser::filter_hook_t filter,
+                       std::size_t size, unsigned threads)
+                    {
+                      std::istringstream is(data);
+                      records ret;
+                      const auto n(
+                        csv_block_parser(is, d).filter_hook(filter)
+                        .block_size(size).threads(threads).for_each(
+                          [&](const csv_block_parser::fields_t &fields)
+                          {
+                            ret.emplace_back(fields.begin(), fields.end());
+                          }));
+                      CHECK(n == ret.size());
+                      return ret;
+                    });
+
+  std::vector<csv_dialect> dialects(4);
+  dialects[1].trim_ws = true;
+  dialects[2].quoting = csv_dialect::KEEP_QUOTES;
+  dialects[3].trim_ws = true;
+  dialects[3].quoting = csv_dialect::KEEP_QUOTES;
+
+  SUBCASE("Same records of csv_parser")
+  {
+    for (const auto &data : {s_abalone_h, s_iris_nh, s_car_speed_h,
+                             s_colors_h, s_addresses, s_air_travel})
+      for (const auto &d : dialects)
+      {
+        const auto expected(reference(data, d, nullptr));
+
+        for (std::size_t size : {1u, 7u, 64u, 1u << 24})
+          CHECK(blocks(data, d, nullptr, size, 1) == expected);
+      }
+  }
+
+  SUBCASE("Parallel chunks")
+  {
+    // Large enough to be split into many chunks. Contains every feature of
+    // the dialect (quotes, escaped quotes, spaces, empty lines, `\r\n`
+    // terminators...).
+    const std::vector<std::string> fields =
+    {
+      "", "1", "-2.5e3", "abc", " spaced ", "\"quoted\"", "\"a,b\"",
+      "\"say \"\"hi\"\"\"", "  \"lead\"", "\"\"", "in\"side", "\"x\"y\"z",
+      "\"\" \"\"", "\t"
+    };
+
+    std::mt19937 engine(1234);
+    std::string data;
+    while (data.size() < (1u << 20))
+    {
+      switch (engine() % 16)
+      {
+      case 0:   data += "\n";      continue;
+      case 1:   data += "  \r\n";  continue;
+      }
+
+      for (unsigned n(engine() % 8 + 1), i(0); i < n; ++i)
+      {
+        if (i)
+          data += ',';
+        data += fields[engine() % fields.size()];
+      }
+      data += engine() % 4 ? "\n" : "\r\n";
+    }
+    data += "last,line,without,newline";
+
+    for (const auto &d : dialects)
+    {
+      const auto expected(reference(data, d, nullptr));
+      CHECK(!expected.empty());
+
+      for (std::size_t size : {1000u, 100000u, 1u << 24})
+        for (unsigned threads : {1u, 4u})
+          CHECK(blocks(data, d, nullptr, size, threads) == expected);
+    }
+  }
+
+  SUBCASE("Filter")
+  {
+    // A stateful filter (the order of the calls matters) changing the
+    // records.
+    const auto make_filter([]
+                           {
+                             return [n = 0](csv_parser::record_t &r) mutable
+                                    {
+                                      r.push_back(std::to_string(n));
+                                      return ++n % 3 != 0;
+                                    };
+                           });
+
+    std::string data;
+    for (unsigned i(0); i < 50000; ++i)
+      data += std::to_string(i) + ",\"value " + std::to_string(i) + "\"\n";
+
+    const auto expected(reference(data, {}, make_filter()));
+    CHECK(expected.size() == 50000 - 50000 / 3);
+
+    for (unsigned threads : {1u, 4u})
+      CHECK(blocks(data, {}, make_filter(), 65536, threads) == expected);
+  }
+
+  SUBCASE("Empty input")
+  {
+    CHECK(blocks("", {}, nullptr, 16, 2).empty());
+    CHECK(blocks("\n  \n\r\n", {}, nullptr, 16, 2).empty());
+  }
+}
+
 }  // TEST_SUITE("CSV_PARSER")
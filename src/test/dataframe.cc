@@ -10,9 +10,14 @@
  *  You can obtain one at http://mozilla.org/MPL/2.0/
  */
 
+#include <cmath>
+#include <filesystem>
 #include <sstream>
 
+#include "kernel/exceptions.h"
 #include "kernel/random.h"
+#include "kernel/src/chunked_dataframe.h"
+#include "kernel/src/columnar_dataframe.h"
 #include "kernel/src/dataframe.h"
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
@@ -380,4 +385,360 @@ TEST_CASE("load_xrff_classification")
   CHECK(d.class_name(2) == "Iris-virginica");
 }
 
+TEST_CASE("load_xrff_streaming")
+{
+  using namespace vita;
+
+  SUBCASE("XML features")
+  {
+    std::istringstream xrff(R"(<?xml version="1.0" encoding="utf-8"?>
+<!-- Generated file -->
+<dataset name="test">
+  <header>
+    <attributes>
+      <attribute name="x" type="numeric"/>
+      <attribute name='name' type="string"/>
+      <attribute name="y" type="numeric"/>
+    </attributes>
+  </header>
+  <body>
+    <instances>
+      <instance><value>1</value><value>a &amp; b</value><value>2</value></instance>
+      <!-- <instance><value>9</value><value>c</value><value>9</value></instance> -->
+      <instance><value>3</value><value><![CDATA[<c>]]></value><value>4</value></instance>
+      <instance><value>5</value><value/><value>6</value></instance>
+    </instances>
+  </body>
+</dataset>)");
+
+    dataframe d;
+    REQUIRE(d.read_xrff(xrff) == 3);
+
+    // No `class="yes"` attribute: the last column is the output.
+    CHECK(d.columns[0].name == "y");
+    CHECK(d.columns[1].name == "x");
+    CHECK(d.columns[2].name == "name");
+
+    auto it(d.begin());
+    CHECK(it->output == value_t(2.0));
+    CHECK(it->input[0] == value_t(1.0));
+    CHECK(it->input[1] == value_t(std::string("a & b")));
+
+    ++it;
+    CHECK(it->input[1] == value_t(std::string("<c>")));
+
+    ++it;
+    CHECK(it->input[1] == value_t(std::string()));
+  }
+
+  SUBCASE("Filter")
+  {
+    std::istringstream is(iris_xrff.str());
+
+    dataframe::params p;
+    p.filter = [](dataframe::record_t &r) { return r[0] != "Iris-setosa"; };
+
+    dataframe d;
+    CHECK(d.read_xrff(is, p) == 7);
+  }
+
+  SUBCASE("Wrong files")
+  {
+    const std::string header(R"(
+<header><attributes><attribute name="x" type="numeric"/></attributes></header>)");
+
+    const std::string body(R"(
+<body><instances><instance><value>1</value></instance></instances></body>)");
+
+    for (const auto &doc : {"<dataset>" + header + body,  // unclosed
+                            "<dataset>" + body + header + "</dataset>",
+                            "<dataset>" + header + "</dataset>",
+                            "<dataset>" + body + "</dataset>",
+                            std::string("<dataset><header><attributes/>")
+                            + "</header>" + body + "</dataset>"})
+    {
+      std::istringstream is(doc);
+      dataframe d;
+      CHECK_THROWS_AS(d.read_xrff(is), exception::data_format);
+    }
+  }
+}
+
+TEST_CASE("columnar")
+{
+  using namespace vita;
+  using storage = columnar_dataframe::column::storage;
+
+  dataframe d;
+  CHECK(d.read("./test_resources/iris.csv") == 150);
+
+  d.front().difficulty = 10;
+  d.front().age = 2;
+
+  const columnar_dataframe c(d);
+  CHECK(c.debug());
+
+  CHECK(c.size() == d.size());
+  CHECK(!c.empty());
+  CHECK(c.variables() == d.variables());
+
+  CHECK(c.output().type() == storage::integer);
+  for (unsigned i(0); i < c.variables(); ++i)
+  {
+    CHECK(c.input(i).type() == storage::real);
+    CHECK(c.input(i).reals());
+    CHECK(!c.input(i).integers());
+  }
+
+  // Rows are the original examples.
+  std::size_t i(0);
+  for (const auto &e : d)
+  {
+    const auto row(c[i]);
+
+    CHECK(row.input == e.input);
+    CHECK(row.output == e.output);
+    CHECK(row.difficulty == e.difficulty);
+    CHECK(row.age == e.age);
+    CHECK(row.id == e.id);
+    CHECK(c.ids()[i] == e.id);
+    CHECK(c.input(0).reals()[i]
+          == doctest::Approx(std::get<D_DOUBLE>(e.input[0])));
+
+    ++i;
+  }
+  CHECK(c.difficulty().front() == 10);
+  CHECK(c.age().front() == 2);
+
+  CHECK(std::equal(c.begin(), c.end(), d.begin(),
+                   [](const dataframe::example &e1,
+                      const dataframe::example &e2)
+                   {
+                     return e1.input == e2.input && e1.output == e2.output;
+                   }));
+  CHECK(c.begin()->input == d.front().input);
+
+  // Doubles take 8 bytes instead of a `value_t` each.
+  CHECK(c.bytes() < d.size() * d.variables() * sizeof(value_t));
+
+  SUBCASE("Strings and mixed values")
+  {
+    columnar_dataframe m;
+
+    const std::vector<dataframe::example> examples =
+    {
+      {{"red",   1, {}},  1.0},
+      {{"green", 2, 1.5}, 2.0},
+      {{"red",   3, 2.5},  {}},
+      {{"blue", {}, 3.5}, 4.0}
+    };
+
+    for (const auto &e : examples)
+      m.push_back(e);
+    CHECK(m.debug());
+
+    CHECK(m.input(0).type() == storage::string);
+    CHECK(m.input(0).dictionary().size() == 3);
+    CHECK(m.input(0).codes()[0] == m.input(0).codes()[2]);
+    CHECK(m.input(1).type() == storage::generic);  // empty integer
+    CHECK(m.input(2).type() == storage::real);
+    CHECK(std::isnan(m.input(2).reals()[0]));
+    CHECK(m.output().type() == storage::real);
+
+    for (std::size_t j(0); j < examples.size(); ++j)
+    {
+      CHECK(m[j].input == examples[j].input);
+      CHECK(m[j].output == examples[j].output);
+    }
+
+    m.clear();
+    CHECK(m.empty());
+    CHECK(m.variables() == 0);
+  }
+}
+
+TEST_CASE("binary")
+{
+  using namespace vita;
+
+  const auto same([](const dataframe &d1, const dataframe &d2)
+  {
+    if (d1.size() != d2.size() || d1.columns.size() != d2.columns.size()
+        || d1.classes() != d2.classes())
+      return false;
+
+    for (std::size_t j(0); j < d1.columns.size(); ++j)
+      if (d1.columns[j].name != d2.columns[j].name
+          || d1.columns[j].domain != d2.columns[j].domain
+          || d1.columns[j].states != d2.columns[j].states)
+        return false;
+
+    for (class_t c(0); c < d1.classes(); ++c)
+      if (d1.class_name(c) != d2.class_name(c))
+        return false;
+
+    return std::equal(d1.begin(), d1.end(), d2.begin(),
+                      [](const dataframe::example &e1,
+                         const dataframe::example &e2)
+                      {
+                        return e1.input == e2.input && e1.output == e2.output;
+                      });
+  });
+
+  const auto fn(std::filesystem::temp_directory_path() / "vita_test.vdf");
+
+  SUBCASE("CSV")
+  {
+    dataframe d;
+    REQUIRE(d.read("./test_resources/iris.csv") == 150);
+
+    REQUIRE(d.write_binary(fn));
+    CHECK(is_binary_dataframe(fn));
+    CHECK(!is_binary_dataframe("./test_resources/iris.csv"));
+
+    dataframe b;
+    CHECK(b.read_binary(fn) == d.size());
+    CHECK(b.debug());
+    CHECK(same(d, b));
+
+    // Binary files are recognized by `read`.
+    dataframe b2(fn);
+    CHECK(same(d, b2));
+
+    // Examples get new IDs.
+    CHECK(b.front().id);
+    CHECK(b.front().id != d.front().id);
+  }
+
+  SUBCASE("XRFF")
+  {
+    dataframe d;
+    REQUIRE(d.read("./test_resources/src_problem.xrff"));
+
+    REQUIRE(d.write_binary(fn));
+
+    dataframe b;
+    CHECK(b.read_binary(fn) == d.size());
+    CHECK(same(d, b));
+  }
+
+  SUBCASE("Strings and empty output")
+  {
+    std::istringstream ss(R"(
+      "a",1.5,"x",1
+      "b",2,"y",2
+      "c",2.5,"x",3
+      "a",3.5,"z",4)");
+
+    dataframe d;
+    dataframe::params p;
+    p.output_index = std::nullopt;
+    REQUIRE(d.read_csv(ss, p) == 4);
+
+    REQUIRE(d.write_binary(fn));
+
+    dataframe b;
+    CHECK(b.read_binary(fn) == d.size());
+    CHECK(same(d, b));
+  }
+
+  SUBCASE("Wrong files")
+  {
+    dataframe d;
+    REQUIRE(d.read("./test_resources/iris.csv") == 150);
+    REQUIRE(d.write_binary(fn));
+
+    std::filesystem::resize_file(fn, std::filesystem::file_size(fn) / 2);
+
+    dataframe b;
+    CHECK_THROWS_AS(b.read_binary(fn), exception::data_format);
+    CHECK_THROWS(b.read_binary("./test_resources/iris.csv"));
+  }
+
+  std::filesystem::remove(fn);
+}
+
+TEST_CASE("chunked")
+{
+  using namespace vita;
+
+  dataframe d;
+  REQUIRE(d.read("./test_resources/iris.csv") == 150);
+
+  const auto fn(std::filesystem::temp_directory_path() / "vita_test.vdf");
+  REQUIRE(d.write_binary(fn));
+
+  const chunked_dataframe c(fn, 40);
+  CHECK(c.size() == d.size());
+  CHECK(!c.empty());
+  CHECK(c.chunk_size() == 40);
+  CHECK(c.chunks() == 4);
+  CHECK(c.variables() == d.variables());
+  CHECK(c.classes() == d.classes());
+
+  const auto same_example([](const dataframe::example &e1,
+                             const dataframe::example &e2)
+  {
+    return e1.input == e2.input && e1.output == e2.output;
+  });
+
+  SUBCASE("Complete pass")
+  {
+    std::vector<dataframe::example> all;
+    std::size_t chunks(0);
+
+    c.for_each_chunk([&](dataframe &chunk)
+                     {
+                       CHECK(chunk.size() <= c.chunk_size());
+                       CHECK(chunk.columns.size() == d.columns.size());
+                       CHECK(chunk.classes() == d.classes());
+
+                       all.insert(all.end(), chunk.begin(), chunk.end());
+                       ++chunks;
+                     });
+
+    CHECK(chunks == c.chunks());
+    REQUIRE(all.size() == d.size());
+    CHECK(std::equal(all.begin(), all.end(), d.begin(), same_example));
+
+    for (std::size_t r(0); r < all.size(); ++r)
+    {
+      CHECK(all[r].id == c.id(r));
+      CHECK(c.row(all[r].id) == r);
+    }
+  }
+
+  SUBCASE("Single chunk")
+  {
+    dataframe chunk;
+    c.prefetch(3);
+    c.load(3, chunk);
+
+    REQUIRE(chunk.size() == 30);
+    CHECK(std::equal(chunk.begin(), chunk.end(), std::next(d.begin(), 120),
+                     same_example));
+    CHECK(chunk.front().id == c.id(120));
+  }
+
+  SUBCASE("Subset")
+  {
+    const std::vector<std::size_t> rows = {0, 7, 41, 99, 149};
+
+    dataframe subset;
+    subset.push_back(d.front());  // previous content is removed
+    c.load(rows, subset);
+
+    REQUIRE(subset.size() == rows.size());
+    auto e(subset.begin());
+    for (const auto r : rows)
+    {
+      CHECK(same_example(*e, *std::next(d.begin(), r)));
+      CHECK(c.row(e->id) == r);
+      ++e;
+    }
+  }
+
+  std::filesystem::remove(fn);
+}
+
 }  // TEST_SUITE("DATAFRAME")
@@ -0,0 +1,963 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include "kernel/column_store.h"
+#include "kernel/evaluator_proxy.h"
+#include "kernel/i_mep.h"
+#include "kernel/src/columnar_dataframe.h"
+#include "kernel/src/dss.h"
+#include "kernel/src/evaluator.h"
+#include "kernel/src/problem.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "third_party/doctest/doctest.h"
+
+// Other test suites contain statistical checks that rely on the sequence of
+// pseudo-random numbers: the state of the engine is restored after every test.
+struct fixture_evaluator
+{
+  fixture_evaluator() : state(vita::random::engine) {}
+  ~fixture_evaluator() { vita::random::engine = state; }
+
+  vita::random::engine_t state;
+};
+
+// Counts the calls to the standard and to the approximated evaluation.
+template<class E>
+class counting_evaluator : public E
+{
+public:
+  template<class... Args>
+  explicit counting_evaluator(unsigned *full, unsigned *approx, Args &&... args)
+    : E(std::forward<Args>(args)...), full_(full), approx_(approx) {}
+
+  vita::fitness_t operator()(const vita::i_mep &prg) override
+  {
+    ++*full_;
+    return E::operator()(prg);
+  }
+
+  vita::fitness_t fast(const vita::i_mep &prg) override
+  {
+    ++*approx_;
+    return E::fast(prg);
+  }
+
+private:
+  unsigned *full_, *approx_;
+};
+
+// Just the standard evaluation (`fast` isn't specialized).
+class length_evaluator : public vita::evaluator<vita::i_mep>
+{
+public:
+  explicit length_evaluator(unsigned *full) : full_(full) {}
+
+  vita::fitness_t operator()(const vita::i_mep &prg) override
+  {
+    ++*full_;
+    return {static_cast<double>(prg.active_symbols())};
+  }
+
+private:
+  unsigned *full_;
+};
+
+TEST_SUITE("EVALUATOR")
+{
+
+TEST_CASE("Column store")
+{
+  using namespace vita;
+
+  const auto outputs([](std::size_t n)
+  {
+    gene_outputs go;
+    go.loci[{0, 0}].values = std::make_shared<const std::vector<D_DOUBLE>>(n);
+    return go;
+  });
+
+  const auto bytes(outputs(100).bytes());
+  column_store store(3 * bytes);
+
+  CHECK(!store.find(nullptr));
+
+  const auto go1(store.insert(outputs(100)));
+  const auto go2(store.insert(outputs(100)));
+  const auto go3(store.insert(outputs(100)));
+  CHECK(store.used() == 3 * bytes);
+  CHECK(store.find(go1) == go1);
+  CHECK(store.find(go2) == go2);
+  CHECK(store.find(go3) == go3);
+
+  // `go1` is the least recently used element.
+  const auto go4(store.insert(outputs(100)));
+  CHECK(!store.find(go1));
+  CHECK(store.find(go2) == go2);
+  CHECK(store.find(go3) == go3);
+  CHECK(store.find(go4) == go4);
+  CHECK(store.used() <= store.budget());
+
+  // Elements bigger than the budget aren't stored.
+  const auto big(store.insert(outputs(1000)));
+  CHECK(big);
+  CHECK(!store.find(big));
+  CHECK(store.find(go2) == go2);
+
+  // Subtree index.
+  const hash_t h1(1, 2), h2(3, 4);
+  const auto col(go2->loci.at({0, 0}).values);
+  store.insert(h1, col);
+  CHECK(store.find(h1) == col);
+  CHECK(!store.find(h2));
+  CHECK(store.hits() == 1);
+  CHECK(store.misses() == 1);
+
+  store.clear();
+  CHECK(!store.find(go2));
+  CHECK(!store.find(go3));
+  CHECK(store.used() == 0);
+  CHECK(!store.find(h1));  // column still alive but store cleared
+}
+
+TEST_CASE_FIXTURE(fixture_evaluator, "Incremental evaluation")
+{
+  using namespace vita;
+
+  src_problem pr;
+  pr.env.init();
+  REQUIRE(pr.data().read("./test_resources/mep.csv") == 10);
+  pr.env.mep.code_length = 64;
+  pr.setup_symbols();
+
+  mse_evaluator<i_mep> plain(pr.data());
+  mse_evaluator<i_mep> incremental(pr.data(), 1u << 20);
+
+  for (unsigned k(0); k < 1000; ++k)
+  {
+    const i_mep parent(pr), other(pr);
+
+    CHECK(incremental(parent) == plain(parent));
+    if (const auto po = parent.outputs())  // `double`-only program
+    {
+      const i_mep copy(parent);
+      CHECK(incremental(copy) == plain(copy));
+
+      // Output columns of the copy are the ones of the parent.
+      REQUIRE(copy.outputs());
+      CHECK(copy.outputs()->loci.at(copy.best()).values
+            == po->loci.at(parent.best()).values);
+    }
+
+    i_mep mutated(parent);
+    mutated.mutation(0.1, pr);
+    CHECK(incremental(mutated) == plain(mutated));
+
+    const auto offspring(crossover(parent, other));
+    CHECK(incremental(offspring) == plain(offspring));
+
+    if (k % 100 == 0)
+    {
+      incremental.clear();
+      CHECK(!parent.outputs());
+      CHECK(incremental(mutated) == plain(mutated));
+    }
+  }
+}
+
+TEST_CASE_FIXTURE(fixture_evaluator, "Incremental evaluation in blocks")
+{
+  using namespace vita;
+
+  src_problem pr;
+  pr.env.init();
+  REQUIRE(pr.data().read("./test_resources/mep.csv") == 10);
+  pr.env.mep.code_length = 64;
+  pr.setup_symbols();
+
+  const auto begin(pr.data().begin()), end(pr.data().end());
+
+  column_store store(1u << 20);
+  column_store tiny(64);  // too small for the outputs of a program
+
+  for (unsigned k(0); k < 1000; ++k)
+  {
+    const i_mep prg(pr);
+
+    std::vector<value_t> expected;
+    src_interpreter<i_mep>(&prg).run(begin, end, &expected);
+
+    for (const std::size_t block : {1, 3, 10, 256})
+    {
+      const i_mep copy(prg);
+
+      std::vector<value_t> out;
+      if (src_interpreter<i_mep>(&copy).run(begin, end, &out, store, block))
+      {
+        CHECK(out == expected);
+        CHECK(copy.outputs());
+      }
+    }
+
+    const i_mep copy(prg);
+    std::vector<value_t> out;
+    if (src_interpreter<i_mep>(&copy).run(begin, end, &out, tiny, 3))
+    {
+      CHECK(out == expected);
+      CHECK(!copy.outputs());
+      CHECK(tiny.used() == 0);
+    }
+  }
+}
+
+TEST_CASE_FIXTURE(fixture_evaluator, "Subtree output cache")
+{
+  using namespace vita;
+
+  src_problem pr;
+  pr.env.init();
+  REQUIRE(pr.data().read("./test_resources/mep.csv") == 10);
+  pr.env.mep.code_length = 64;
+  pr.setup_symbols();
+
+  mse_evaluator<i_mep> plain(pr.data());
+  mse_evaluator<i_mep> incremental(pr.data(), 1u << 20);
+
+  CHECK(incremental.info().find("subtree hits 0") != std::string::npos);
+  CHECK(plain.info().empty());
+
+  for (unsigned k(0); k < 1000; ++k)
+  {
+    const i_mep ind(pr);
+    CHECK(incremental(ind) == plain(ind));
+
+    if (!ind.outputs())  // not a `double`-only program
+      continue;
+
+    // An unrelated individual with the same active code.
+    i_mep same(ind);
+    same.outputs(nullptr);
+
+    const std::string before(incremental.info());
+    CHECK(incremental(same) == plain(same));
+    CHECK(incremental.info() != before);
+
+    CHECK(same.outputs()->loci.at(same.best()).values
+          == ind.outputs()->loci.at(ind.best()).values);
+  }
+}
+
+TEST_CASE_FIXTURE(fixture_evaluator, "Racing evaluation")
+{
+  using namespace vita;
+
+  // A dataset spanning many blocks.
+  std::stringstream ss;
+  for (unsigned i(0); i < 2000; ++i)
+  {
+    const double x(i / 100.0);
+    ss << x * x + x + 1.0 << ',' << x << '\n';
+  }
+
+  src_problem pr;
+  pr.env.init();
+  REQUIRE(pr.data().read_csv(ss) == 2000);
+  pr.setup_symbols();
+
+  mse_evaluator<i_mep> eva(pr.data());
+  evaluator_proxy<i_mep, mse_evaluator<i_mep>> proxy(
+    mse_evaluator<i_mep>(pr.data()), 16);
+
+  unsigned partials(0);
+  for (unsigned k(0); k < 500; ++k)
+  {
+    const i_mep i1(pr), i2(pr);
+
+    const auto f1(eva(i1)), f2(eva(i2));
+
+    bool partial;
+    const auto r(eva.race(i2, f1, &partial));
+    if (partial)
+    {
+      ++partials;
+      CHECK(r < f1);
+      CHECK(f2 <= r);
+    }
+    else
+      CHECK(r == f2);
+
+    // Partial results are cached but never returned as complete ones.
+    bool cached_partial;
+    const auto rc(proxy.race(i2, f1, &cached_partial));
+    if (cached_partial)
+    {
+      CHECK(rc < f1);
+      CHECK(f2 <= rc);
+    }
+    else
+      CHECK(rc == f2);
+    CHECK(proxy(i2) == f2);
+    CHECK(proxy.race(i2, f1, &cached_partial) == f2);
+    CHECK(!cached_partial);
+  }
+
+  CHECK(partials);
+}
+
+TEST_CASE_FIXTURE(fixture_evaluator, "Multithreaded evaluation")
+{
+  using namespace vita;
+
+  const auto difficulties([](const dataframe &d)
+  {
+    std::vector<std::uintmax_t> ret;
+    for (const auto &e : d)
+      ret.push_back(e.difficulty);
+    return ret;
+  });
+
+  SUBCASE("Symbolic regression")
+  {
+    std::stringstream ss;
+    for (unsigned i(0); i < 3000; ++i)
+    {
+      const double x(i / 100.0);
+      ss << x * x + x + 1.0 << ',' << x << '\n';
+    }
+
+    src_problem pr;
+    pr.env.init();
+    REQUIRE(pr.data().read_csv(ss) == 3000);
+    pr.setup_symbols();
+
+    dataframe copy(pr.data());
+
+    mae_evaluator<i_mep> eva1(pr.data()), eva4(copy);
+    eva4.threads(4);
+
+    for (unsigned k(0); k < 100; ++k)
+    {
+      const i_mep ind(pr);
+      CHECK(eva1(ind) == eva4(ind));
+    }
+
+    CHECK(difficulties(pr.data()) == difficulties(copy));
+
+    // The stopping point of a race depends on the number of threads.
+    for (unsigned k(0); k < 100; ++k)
+    {
+      const i_mep i1(pr), i2(pr);
+      const auto bound(eva1(i1)), f(eva1(i2));
+
+      bool partial;
+      const auto r(eva4.race(i2, bound, &partial));
+      if (partial)
+      {
+        CHECK(r < bound);
+        CHECK(f <= r);
+      }
+      else
+        CHECK(r == f);
+    }
+  }
+
+  SUBCASE("Classification")
+  {
+    src_problem pr;
+    pr.env.init();
+    REQUIRE(pr.data().read("./test_resources/ionosphere.csv") == 351);
+    pr.setup_symbols();
+
+    dataframe copy(pr.data());
+
+    binary_evaluator<i_mep> bin1(pr.data()), bin4(copy);
+    gaussian_evaluator<i_mep> gau1(pr.data()), gau4(copy);
+    dyn_slot_evaluator<i_mep> dyn1(pr.data()), dyn4(copy);
+    bin4.threads(4);
+    gau4.threads(4);
+    dyn4.threads(4);
+
+    for (unsigned k(0); k < 100; ++k)
+    {
+      const i_mep ind(pr);
+
+      CHECK(bin1(ind) == bin4(ind));
+      CHECK(gau1(ind) == gau4(ind));
+      CHECK(dyn1(ind) == dyn4(ind));
+    }
+
+    CHECK(difficulties(pr.data()) == difficulties(copy));
+  }
+}
+
+TEST_CASE_FIXTURE(fixture_evaluator, "Output store")
+{
+  using namespace vita;
+
+  std::stringstream ss;
+  for (unsigned i(0); i < 1000; ++i)
+  {
+    const double x(i / 100.0);
+    ss << x * x + x + 1.0 << ',' << x << '\n';
+  }
+
+  src_problem pr;
+  pr.env.init();
+  REQUIRE(pr.data().read_csv(ss) == 1000);
+  pr.setup_symbols();
+
+  const std::vector<dataframe::example> all(pr.data().begin(),
+                                            pr.data().end());
+  for (const auto &e : all)
+    CHECK(e.id);
+
+  // A DSS-like setting: a subset of the examples changes every few steps.
+  dataframe training(pr.data()), copy(pr.data());
+  const auto shake([&]
+  {
+    training.clear();
+    copy.clear();
+
+    for (const auto &e : all)
+      if (random::boolean(0.7))
+      {
+        training.push_back(e);
+        copy.push_back(e);
+      }
+  });
+
+  mae_evaluator<i_mep> plain(copy), memo(training, 0, 1u << 20);
+  CHECK(memo.info().find("outputs reused 0") != std::string::npos);
+
+  std::vector<i_mep> prgs;
+  for (unsigned i(0); i < 50; ++i)
+    prgs.emplace_back(pr);
+
+  for (unsigned k(0); k < 10; ++k)
+  {
+    shake();
+    memo.clear();
+
+    for (const auto &prg : prgs)
+      CHECK(memo(prg) == plain(prg));
+
+    CHECK(std::equal(training.begin(), training.end(), copy.begin(),
+                     [](const dataframe::example &e1,
+                        const dataframe::example &e2)
+                     {
+                       return e1.id == e2.id
+                              && e1.difficulty == e2.difficulty;
+                     }));
+  }
+
+  CHECK(memo.info().find("outputs reused 0") == std::string::npos);
+}
+
+TEST_CASE_FIXTURE(fixture_evaluator, "Columnar evaluation")
+{
+  using namespace vita;
+
+  src_problem pr;
+  pr.env.init();
+  REQUIRE(pr.data().read("./test_resources/mep.csv") == 10);
+  pr.env.mep.code_length = 64;
+  pr.setup_symbols();
+
+  const columnar_dataframe cd(pr.data());
+
+  for (unsigned k(0); k < 1000; ++k)
+  {
+    const i_mep prg(pr);
+
+    std::vector<value_t> by_row, by_column;
+    src_interpreter<i_mep>(&prg).run(pr.data().begin(), pr.data().end(),
+                                     &by_row);
+    src_interpreter<i_mep>(&prg).run(cd, 0, cd.size(), &by_column);
+    CHECK(by_row == by_column);
+
+    std::vector<value_t> part;
+    src_interpreter<i_mep>(&prg).run(cd, 3, 7, &part);
+    CHECK(part == std::vector<value_t>(by_row.begin() + 3,
+                                       by_row.begin() + 7));
+  }
+
+  // The evaluator reads the columns of a numeric dataset and follows the
+  // changes of the active dataset.
+  std::stringstream ss;
+  for (unsigned i(0); i < 600; ++i)
+  {
+    const double x(i / 60.0);
+    ss << x * x - x << ',' << x << '\n';
+  }
+
+  src_problem pr2;
+  pr2.env.init();
+  REQUIRE(pr2.data().read_csv(ss) == 600);
+  pr2.setup_symbols();
+
+  const columnar_dataframe cd2(pr2.data());
+  mse_evaluator<i_mep> eva(pr2.data());
+
+  std::vector<i_mep> prgs;
+  for (unsigned k(0); k < 100; ++k)
+  {
+    prgs.emplace_back(pr2);
+    eva(prgs.back());  // builds the columns of the whole dataset
+
+    std::vector<value_t> by_row, by_column;
+    const basic_reg_lambda_f<i_mep, false> agent(prgs.back());
+    agent(pr2.data().begin(), pr2.data().end(), &by_row);
+    if (agent(cd2, 0, cd2.size(), &by_column))
+      CHECK(by_row == by_column);
+  }
+
+  // A single copy of the columns, rebuilt only when the examples change.
+  const auto shared(pr2.data().real_columns());
+  REQUIRE(shared);
+  CHECK(shared->size() == pr2.data().size());
+  CHECK(pr2.data().real_columns() == shared);
+
+  const auto version(pr2.data().version());
+  pr2.data().erase(pr2.data().begin(), std::next(pr2.data().begin(), 300));
+  CHECK(pr2.data().version() != version);
+
+  dataframe copy(pr2.data());
+  CHECK(copy.version() == pr2.data().version());
+  mse_evaluator<i_mep> fresh(copy);
+
+  for (const auto &prg : prgs)
+    CHECK(eva(prg) == fresh(prg));
+
+  CHECK(pr2.data().real_columns() != shared);
+  CHECK(pr2.data().real_columns()->size() == 300);
+
+  // No columns for non-numeric features.
+  dataframe::example e;
+  e.input = {value_t(1.0), value_t(std::string("a"))};
+  e.output = 1.0;
+  dataframe mixed;
+  mixed.push_back(e);
+  CHECK(!mixed.real_columns());
+}
+
+TEST_CASE_FIXTURE(fixture_evaluator, "Batch evaluation")
+{
+  using namespace vita;
+
+  std::stringstream ss;
+  for (unsigned i(0); i < 1000; ++i)
+  {
+    const double x(i / 100.0);
+    ss << x * x - x << ',' << x << '\n';
+  }
+
+  src_problem pr;
+  pr.env.init();
+  REQUIRE(pr.data().read_csv(ss) == 1000);
+  pr.setup_symbols();
+
+  dataframe copy(pr.data());
+
+  std::vector<i_mep> prgs;
+  for (unsigned k(0); k < 50; ++k)
+    prgs.emplace_back(pr);
+  prgs.push_back(prgs.front());  // duplicates are allowed
+
+  std::vector<const i_mep *> ptrs;
+  for (const auto &prg : prgs)
+    ptrs.push_back(&prg);
+
+  mse_evaluator<i_mep> eva1(pr.data());
+  std::vector<fitness_t> expected;
+  for (const auto &prg : prgs)
+    expected.push_back(eva1(prg));
+
+  SUBCASE("Multithreaded")
+  {
+    mse_evaluator<i_mep> eva4(copy);
+    eva4.threads(4);
+
+    CHECK(eva4.batch(ptrs) == expected);
+
+    for (auto e1(pr.data().begin()), e4(copy.begin()); e1 != pr.data().end();
+         ++e1, ++e4)
+      CHECK(e1->difficulty == e4->difficulty);
+  }
+
+  SUBCASE("Proxy")
+  {
+    mse_evaluator<i_mep> eva4(copy);
+    eva4.threads(4);
+    evaluator_proxy<i_mep, mse_evaluator<i_mep>> proxy(std::move(eva4), 16);
+
+    // The second half of the programs is already cached.
+    for (std::size_t i(prgs.size() / 2); i < prgs.size(); ++i)
+      CHECK(proxy(prgs[i]) == expected[i]);
+
+    CHECK(proxy.batch(ptrs) == expected);
+
+    for (std::size_t i(0); i < prgs.size(); ++i)
+      CHECK(proxy(prgs[i]) == expected[i]);
+  }
+
+  SUBCASE("Shared cache")
+  {
+    using proxy_t = evaluator_proxy<i_mep, mse_evaluator<i_mep>,
+                                    concurrent_cache>;
+
+    const auto shared(std::make_shared<concurrent_cache>(16));
+    dataframe copy2(copy);
+    proxy_t proxy1(mse_evaluator<i_mep>(copy), shared),
+            proxy2(mse_evaluator<i_mep>(copy2), shared);
+
+    // Every thread evaluates half of the programs...
+    const auto half(prgs.size() / 2);
+    std::thread t([&]
+    {
+      for (std::size_t i(half); i < prgs.size(); ++i)
+        proxy2(prgs[i]);
+    });
+    for (std::size_t i(0); i < half; ++i)
+      proxy1(prgs[i]);
+    t.join();
+
+    // ... and benefits from the evaluations of the other one.
+    const auto hits(shared->hits());
+    CHECK(proxy1.batch(ptrs) == expected);
+    CHECK(proxy2.batch(ptrs) == expected);
+    CHECK(shared->hits() - hits == 2 * ptrs.size());
+  }
+
+  SUBCASE("Results survive the eviction")
+  {
+    unsigned full(0);
+    evaluator_proxy<i_mep, length_evaluator> proxy(length_evaluator(&full), 7);
+
+    // Many more programs than cache slots.
+    std::vector<i_mep> many;
+    for (unsigned k(0); k < 1000; ++k)
+      many.emplace_back(pr);
+
+    std::vector<const i_mep *> many_ptrs;
+    for (const auto &prg : many)
+      many_ptrs.push_back(&prg);
+
+    const auto fits(proxy.batch(many_ptrs));
+    const auto evaluated(full);
+    CHECK(evaluated > 128);
+
+    for (std::size_t i(0); i < many.size(); ++i)
+      CHECK(proxy(many[i]) == fits[i]);
+    CHECK(full == evaluated);
+  }
+}
+
+TEST_CASE_FIXTURE(fixture_evaluator, "Fast evaluation cache")
+{
+  using namespace vita;
+
+  std::stringstream ss;
+  for (unsigned i(0); i < 100; ++i)
+  {
+    const double x(i / 10.0);
+    ss << x * x - x << ',' << x << '\n';
+  }
+
+  src_problem pr;
+  pr.env.init();
+  REQUIRE(pr.data().read_csv(ss) == 100);
+  pr.setup_symbols();
+
+  // A brood: some members are duplicates.
+  std::vector<i_mep> brood;
+  for (unsigned k(0); k < 10; ++k)
+    brood.emplace_back(pr);
+  brood.push_back(brood[0]);
+  brood.push_back(brood[3]);
+
+  // Random programs may also be logically equivalent.
+  std::set<std::pair<std::uint64_t, std::uint64_t>> distinct;
+  for (const auto &prg : brood)
+    distinct.emplace(prg.signature().data[0], prg.signature().data[1]);
+  const auto n(distinct.size());
+  CHECK(n < brood.size());
+
+  SUBCASE("Specialized fast")
+  {
+    using eva_t = counting_evaluator<mse_evaluator<i_mep>>;
+
+    unsigned full(0), approx(0);
+    evaluator_proxy<i_mep, eva_t> proxy(eva_t(&full, &approx, pr.data()),
+                                        16);
+    mse_evaluator<i_mep> eva(pr.data());
+
+    for (const auto &prg : brood)
+      CHECK(proxy.fast(prg) == eva.fast(prg));
+    CHECK(approx == n);
+
+    for (const auto &prg : brood)
+      proxy.fast(prg);
+    CHECK(approx == n);
+    CHECK(full == 0);
+
+    // Approximated and standard fitnesses don't mix.
+    for (const auto &prg : brood)
+      CHECK(proxy(prg) == eva(prg));
+    CHECK(full == n);
+    CHECK(approx == n);
+
+    // Approximated fitnesses follow the same invalidation rules.
+    proxy.clear();
+    proxy.fast(brood[0]);
+    CHECK(approx == n + 1);
+  }
+
+  SUBCASE("Default fast")
+  {
+    unsigned full(0);
+    evaluator_proxy<i_mep, length_evaluator> proxy(length_evaluator(&full),
+                                                   16);
+
+    for (const auto &prg : brood)
+      CHECK(proxy.fast(prg)
+            == fitness_t{static_cast<double>(prg.active_symbols())});
+    CHECK(full == n);
+
+    // The standard fitnesses are already available.
+    for (const auto &prg : brood)
+      proxy(prg);
+    CHECK(full == n);
+  }
+}
+
+TEST_CASE_FIXTURE(fixture_evaluator, "Chunked evaluation")
+{
+  using namespace vita;
+
+  std::stringstream ss;
+  for (unsigned i(0); i < 1000; ++i)
+  {
+    const double x(i / 100.0);
+    ss << x * x - x << ',' << x << '\n';
+  }
+
+  src_problem pr;
+  pr.env.init();
+  REQUIRE(pr.data().read_csv(ss) == 1000);
+  pr.setup_symbols();
+
+  const auto fn(std::filesystem::temp_directory_path() / "vita_chunked.vdf");
+  REQUIRE(pr.data().write_binary(fn));
+
+  {
+    const chunked_dataframe cd(fn, 300);
+    REQUIRE(cd.chunks() == 4);
+
+    // Every column contains `double`s: the real-valued programs read the
+    // columns of the file in place.
+    const auto cols(cd.real_columns(1));
+    REQUIRE(cols.size() == 2);
+    CHECK(cols[0][0] == doctest::Approx(6.0));
+    CHECK(cols[1][0] == doctest::Approx(3.0));
+    CHECK(cd.range(3).first == 900);
+    CHECK(cd.range(3).second == 1000);
+
+    std::vector<i_mep> prgs;
+    for (unsigned k(0); k < 50; ++k)
+      prgs.emplace_back(pr);
+
+    std::vector<const i_mep *> ptrs;
+    for (const auto &prg : prgs)
+      ptrs.push_back(&prg);
+
+    // The errors of `rmae_evaluator` / `count_evaluator` don't depend on the
+    // other examples: the fitness is the same of a complete evaluation (but
+    // for the rounding errors).
+    rmae_evaluator<i_mep> rmae(pr.data());
+    chunked_evaluator<i_mep, rmae_evaluator<i_mep>> chunked_rmae(cd);
+
+    count_evaluator<i_mep> count(pr.data());
+    chunked_evaluator<i_mep, count_evaluator<i_mep>> chunked_count(cd);
+    chunked_count.threads(4);
+
+    const auto b_rmae(chunked_rmae.batch(ptrs));
+    const auto b_count(chunked_count.batch(ptrs));
+    REQUIRE(b_rmae.size() == prgs.size());
+    REQUIRE(b_count.size() == prgs.size());
+
+    for (std::size_t i(0); i < prgs.size(); ++i)
+    {
+      const auto f_rmae(rmae(prgs[i]));
+      CHECK(chunked_rmae(prgs[i])[0] == doctest::Approx(f_rmae[0]));
+      CHECK(b_rmae[i][0] == doctest::Approx(f_rmae[0]));
+
+      const auto f_count(count(prgs[i]));
+      CHECK(chunked_count(prgs[i])[0] == doctest::Approx(f_count[0]));
+      CHECK(b_count[i][0] == doctest::Approx(f_count[0]));
+
+      CHECK(chunked_rmae.fast(prgs[i]) <= fitness_t{0.0});
+    }
+
+    // The penalty for illegal values continues across the chunks: errors
+    // depending on it match the complete evaluation too.
+    mse_evaluator<i_mep> mse(pr.data());
+    chunked_evaluator<i_mep, mse_evaluator<i_mep>> chunked_mse(cd);
+    chunked_mse.threads(4);
+
+    // Many illegal values make the penalty overflow (`-inf` isn't
+    // approximately equal to itself).
+    const auto same([](double a, double b)
+    {
+      if (std::isinf(b))
+        return std::isinf(a) && std::signbit(a) == std::signbit(b);
+
+      return a == doctest::Approx(b);
+    });
+
+    const auto b_mse(chunked_mse.batch(ptrs));
+    for (std::size_t i(0); i < prgs.size(); ++i)
+    {
+      const auto f_mse(mse(prgs[i]));
+      CHECK(same(b_mse[i][0], f_mse[0]));
+      CHECK(same(chunked_mse(prgs[i])[0], f_mse[0]));
+    }
+
+    // fast() works on the (resident) first chunk, even after a complete pass
+    // over the dataset.
+    dataframe first;
+    cd.load(0, first);
+    mse_evaluator<i_mep> mse_first(first);
+
+    for (const auto &prg : prgs)
+    {
+      const auto f(mse_first.fast(prg));
+      CHECK(chunked_mse.fast(prg) == f);
+
+      chunked_mse.batch({&prg});
+      CHECK(chunked_mse.fast(prg) == f);
+
+      chunked_mse.clear();
+      CHECK(chunked_mse.fast(prg) == f);
+    }
+
+    // A column of strings: the examples are built and evaluated by rows.
+    std::stringstream ms;
+    for (unsigned i(0); i < 1000; ++i)
+    {
+      const double x(i / 100.0);
+      ms << x * x - x << ',' << x << ",s" << i % 3 << '\n';
+    }
+
+    dataframe mixed;
+    REQUIRE(mixed.read_csv(ms) == 1000);
+    REQUIRE(mixed.write_binary(fn));
+
+    const chunked_dataframe mcd(fn, 300);
+    CHECK(mcd.real_columns(0).empty());
+
+    rmae_evaluator<i_mep> mixed_rmae(mixed);
+    chunked_evaluator<i_mep, rmae_evaluator<i_mep>> chunked_mixed(mcd);
+    chunked_mixed.threads(4);
+
+    const auto b_mixed(chunked_mixed.batch(ptrs));
+    for (std::size_t i(0); i < prgs.size(); ++i)
+      CHECK(b_mixed[i][0] == doctest::Approx(mixed_rmae(prgs[i])[0]));
+  }
+
+  std::filesystem::remove(fn);
+}
+
+TEST_CASE_FIXTURE(fixture_evaluator, "Chunked DSS")
+{
+  using namespace vita;
+
+  std::stringstream ss;
+  for (unsigned i(0); i < 2000; ++i)
+  {
+    const double x(i / 100.0);
+    ss << x * x + 1.0 << ',' << x << '\n';
+  }
+
+  const auto fn(std::filesystem::temp_directory_path() / "vita_chunked.vdf");
+
+  {
+    dataframe d;
+    REQUIRE(d.read_csv(ss) == 2000);
+    REQUIRE(d.write_binary(fn));
+  }
+
+  {
+    const chunked_dataframe cd(fn, 256);
+
+    // The problem is initialized with the first chunk.
+    src_problem pr;
+    pr.env.init();
+    pr.env.dss = 2;
+    cd.load(0, pr.data());
+    pr.setup_symbols();
+
+    dataframe &training(pr.data(dataset_t::training));
+    dataframe &validation(pr.data(dataset_t::validation));
+
+    mae_evaluator<i_mep> eva_t(training), eva_v(validation);
+    chunked_dss v(pr, cd, eva_t, eva_v);
+
+    const auto check_sets([&]
+    {
+      CHECK(!training.empty());
+      CHECK(training.size() <= 2 * cd.chunk_size());
+      CHECK(validation.size() == cd.chunk_size());
+
+      std::set<std::uintmax_t> ids;
+      for (const auto &e : training)
+      {
+        CHECK(e.age == 1);
+        ids.insert(e.id);
+      }
+      for (const auto &e : validation)
+        ids.insert(e.id);
+
+      // Training and validation sets are disjoint.
+      CHECK(ids.size() == training.size() + validation.size());
+    });
+
+    v.init(0);
+    check_sets();
+    for (const auto &e : training)
+      CHECK(e.difficulty == 0);
+
+    const i_mep prg(pr);
+    for (unsigned g(1); g < 10; ++g)
+    {
+      eva_t(prg);
+      eva_v(prg);
+
+      CHECK(v.shake(g) == (g % *pr.env.dss == 0));
+      check_sets();
+    }
+
+    v.close(0);
+    CHECK(training.empty());
+    CHECK(validation.size() == cd.chunk_size());
+  }
+
+  std::filesystem::remove(fn);
+}
+
+}  // TEST_SUITE("EVALUATOR")
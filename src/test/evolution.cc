@@ -12,9 +12,12 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <sstream>
 
 #include "kernel/evolution.h"
 #include "kernel/i_mep.h"
+#include "kernel/src/evaluator.h"
+#include "kernel/src/problem.h"
 
 #include "test/fixture2.h"
 
@@ -45,4 +48,134 @@ TEST_CASE_FIXTURE(fixture2, "Creation")
     }
 }
 
+TEST_CASE("Batch mode")
+{
+  using namespace vita;
+
+  // Other tests rely on the sequence of pseudo-random numbers.
+  const auto state(random::engine);
+
+  log::reporting_level = log::lWARNING;
+
+  std::stringstream ss;
+  for (unsigned i(0); i < 500; ++i)
+  {
+    const double x(i / 50.0);
+    ss << x * x + 2.0 * x << ',' << x << '\n';
+  }
+
+  src_problem pr;
+  pr.env.init();
+  REQUIRE(pr.data().read_csv(ss) == 500);
+  pr.setup_symbols();
+
+  pr.env.individuals = 60;
+  pr.env.generations = 5;
+
+  using eva_t = mae_evaluator<i_mep>;
+
+  const auto run([&](unsigned batch, unsigned threads)
+  {
+    pr.env.offspring_batch = batch;
+
+    eva_t eva(pr.data());
+    eva.threads(threads);
+    evaluator_proxy<i_mep, eva_t> proxy(std::move(eva), 16);
+
+    random::seed(1234);
+    return evolution<i_mep, std_es>(pr, proxy).run(1);
+  });
+
+  for (unsigned batch : {1u, 7u, 16u})
+  {
+    const auto s1(run(batch, 1)), s2(run(batch, 1)), s4(run(batch, 4));
+
+    CHECK(s1.best.score.fitness == s2.best.score.fitness);
+    CHECK(s1.best.solution == s2.best.solution);
+
+    // Results don't depend on the number of threads.
+    CHECK(s1.best.score.fitness == s4.best.score.fitness);
+    CHECK(s1.best.solution == s4.best.solution);
+    CHECK(s1.mutations == s4.mutations);
+    CHECK(s1.crossovers == s4.crossovers);
+  }
+
+  random::engine = state;
+}
+
+TEST_CASE("Island model")
+{
+  using namespace vita;
+
+  // Other tests rely on the sequence of pseudo-random numbers.
+  const auto state(random::engine);
+
+  log::reporting_level = log::lWARNING;
+
+  std::stringstream ss;
+  for (unsigned i(0); i < 300; ++i)
+  {
+    const double x(i / 30.0);
+    ss << x * x - 3.0 * x << ',' << x << '\n';
+  }
+
+  src_problem pr;
+  pr.env.init();
+  REQUIRE(pr.data().read_csv(ss) == 300);
+  pr.setup_symbols();
+
+  pr.env.individuals = 30;
+  pr.env.generations = 8;
+  pr.env.layers = 3;
+  pr.env.island.interval = 2;
+  pr.env.island.migrants = 2;
+
+  using eva_t = mae_evaluator<i_mep>;
+
+  // Every additional evaluator works on its own copy of the dataset.
+  struct worker
+  {
+    explicit worker(const dataframe &d) : data(d), eva(data) {}
+
+    dataframe data;
+    eva_t eva;
+  };
+
+  const auto factory([&pr]
+                     {
+                       auto w(std::make_shared<worker>(pr.data()));
+                       return std::shared_ptr<evaluator<i_mep>>(w, &w->eva);
+                     });
+
+  const auto run([&](island_topology t, bool concurrent)
+  {
+    pr.env.island.topology = t;
+
+    evaluator_proxy<i_mep, eva_t> proxy(eva_t(pr.data()), 16);
+
+    random::seed(1234);
+    evolution<i_mep, island_es> evo(pr, proxy);
+    if (concurrent)
+      evo.evaluators(factory);
+
+    return evo.run(1);
+  });
+
+  for (auto t : {island_topology::ring, island_topology::full,
+                 island_topology::random})
+  {
+    const auto s1(run(t, false)), s3(run(t, true));
+
+    CHECK(s1.gen == pr.env.generations + 1);
+
+    // Results don't depend on the number of threads.
+    CHECK(s1.best.score.fitness == s3.best.score.fitness);
+    CHECK(s1.best.solution == s3.best.solution);
+    CHECK(s1.mutations == s3.mutations);
+    CHECK(s1.crossovers == s3.crossovers);
+  }
+
+  random::engine = state;
+}
+
 }  // TEST_SUITE("EVOLUTION")
@@ -27,9 +27,14 @@ struct fixture3
 
     bool input() const override { return true; }
 
-    vita::value_t eval(vita::core_interpreter *) const override { return val; }
+    vita::value_t eval(vita::core_interpreter *) const override
+    {
+      ++evals;
+      return val;
+    }
 
     double val;
+    mutable unsigned evals = 0;  // number of evaluations
   };
 
   fixture3() : prob(), factory(), null(),
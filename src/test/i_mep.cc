@@ -15,6 +15,7 @@
 
 #include "kernel/i_mep.h"
 #include "kernel/interpreter.h"
+#include "kernel/src/primitive/real.h"
 
 #include "fixture1.h"
 #include "fixture3.h"
@@ -137,6 +138,104 @@ TEST_CASE_FIXTURE(fixture3, "Crossover")
   }
 }
 
+TEST_CASE_FIXTURE(fixture3, "Incremental signature")
+{
+  using namespace vita;
+
+  // Signatures computed from scratch (a deserialized individual has no
+  // stored signatures).
+  const auto fresh([&](const i_mep &i)
+  {
+    std::stringstream ss;
+    i.save(ss);
+
+    i_mep loaded;
+    loaded.load(ss, prob.sset);
+    return loaded;
+  });
+
+  const auto check([&](const i_mep &i)
+  {
+    const i_mep f(fresh(i));
+
+    CHECK(i.signature() == f.signature());
+    for (auto it(i.begin()); it != i.end(); ++it)
+      CHECK(i.signature(it.locus()) == f.signature(it.locus()));
+  });
+
+  for (unsigned n(0); n < 1000; ++n)
+  {
+    i_mep i1(prob), i2(prob);
+
+    // Every stored signature of the active code is computed...
+    check(i1);
+    check(i2);
+
+    // ... and then updated after a change of the genome.
+    switch (n % 4)
+    {
+    case 0:
+      i1.mutation(0.2, prob);
+      break;
+    case 1:
+      i1 = crossover(i1, i2);
+      break;
+    case 2:
+      i1 = i1.replace(i2[i2.best()]);
+      break;
+    default:
+      i1 = i1.destroy_block(random::sup(i1.size()), prob.sset);
+    }
+
+    check(i1);
+    CHECK(i1.debug());
+  }
+}
+
+TEST_CASE_FIXTURE(fixture3, "Signature of functions with many arguments")
+{
+  using namespace vita;
+
+  symbol *f_ifb(prob.sset.insert<real::ifb>());
+  REQUIRE(f_ifb->arity() > gene::k_args);
+
+  // Programs differing only in the last argument of FIFB.
+  const i_mep i1({
+                   {{f_ifb, {1, 2, 3, 4, 5}}},  // [0] FIFB [1], ..., [5]
+                   {{   c0,            null}},  // [1] 0.0
+                   {{   c1,            null}},  // [2] 1.0
+                   {{   c2,            null}},  // [3] 2.0
+                   {{   c3,            null}},  // [4] 3.0
+                   {{    x,            null}}   // [5] X
+                 });
+  const i_mep i2({
+                   {{f_ifb, {1, 2, 3, 4, 5}}},  // [0] FIFB [1], ..., [5]
+                   {{   c0,            null}},  // [1] 0.0
+                   {{   c1,            null}},  // [2] 1.0
+                   {{   c2,            null}},  // [3] 2.0
+                   {{   c3,            null}},  // [4] 3.0
+                   {{    y,            null}}   // [5] Y
+                 });
+
+  CHECK(i1.debug());
+  CHECK(i2.debug());
+  CHECK(i1.signature() != i2.signature());
+
+  for (unsigned n(0); n < 1000; ++n)
+  {
+    const i_mep i(prob);
+
+    std::stringstream ss;
+    i.save(ss);
+
+    i_mep loaded;
+    REQUIRE(loaded.load(ss, prob.sset));
+
+    CHECK(i.debug());
+    CHECK(i.signature() == loaded.signature());
+  }
+}
+
 TEST_CASE_FIXTURE(fixture3, "Serialization")
 {
   // Non-empty i_mep serialization.
@@ -214,6 +214,41 @@ TEST_CASE_FIXTURE(fixture, "reg_lambda")
   }
 }
 
+TEST_CASE_FIXTURE(fixture, "reg_lambda batch")
+{
+  using namespace vita;
+
+  CHECK(pr.data().read("./test_resources/mep.csv") == MEP_COUNT);
+  pr.env.mep.code_length = 64;
+  pr.setup_symbols();
+
+  const auto check([&](const auto &lambda)
+  {
+    std::vector<value_t> out;
+    lambda(pr.data().begin(), pr.data().end(), &out);
+    REQUIRE(out.size() == MEP_COUNT);
+
+    std::size_t i(0);
+    for (const auto &e : pr.data())
+      CHECK(out[i++] == lambda(e));
+
+    // Subranges.
+    const auto mid(std::next(pr.data().begin(), MEP_COUNT / 3));
+    lambda(mid, pr.data().end(), &out);
+    REQUIRE(out.size() == MEP_COUNT - MEP_COUNT / 3);
+    CHECK(out.front() == lambda(*mid));
+  });
+
+  for (unsigned k(0); k < 1000; ++k)
+  {
+    const i_mep ind(pr);
+    check(reg_lambda_f<i_mep>(ind));
+
+    const team<i_mep> t(pr);
+    check(reg_lambda_f<team<i_mep>>(t));
+  }
+}
+
 TEST_CASE_FIXTURE(fixture, "reg_lambda serialization")
 {
   using namespace vita;
@@ -10,11 +10,13 @@
  *  You can obtain one at http://mozilla.org/MPL/2.0/
  */
 
+#include <cmath>
 #include <cstdlib>
 #include <iostream>
 
 #include "kernel/i_mep.h"
 #include "kernel/random.h"
+#include "kernel/src/interpreter.h"
 #include "kernel/src/primitive/real.h"
 
 #include "test/fixture3.h"
@@ -305,6 +307,18 @@ TEST_CASE_FIXTURE(fixture3, "f_ife")
   ret = i_interp(&i3).run();
   CHECK(real::base(ret) == doctest::Approx(0.0));
 
+  // IFE(0,0,1,Z) == 1 and Z isn't evaluated (lazy evaluation)
+  const i_mep i_lazy({
+                       {{f_ife, {1, 1, 2, 3}}},  // [0] FIFE [1], [1], [2], [3]
+                       {{   c0,         null}},  // [1] 0.0
+                       {{   c1,         null}},  // [2] 1.0
+                       {{    z,         null}}   // [3] Z
+                     });
+  static_cast<Z *>(z)->evals = 0;
+  ret = i_interp(&i_lazy).run();
+  CHECK(real::base(ret) == doctest::Approx(1.0));
+  CHECK(static_cast<Z *>(z)->evals == 0);
+
   // IFE SAME TERM COMPARISON PENALTY");
   CHECK(i_interp(&i1).penalty() > 0.0);
 
@@ -600,4 +614,62 @@ TEST_CASE_FIXTURE(fixture3, "f_sigmoid")
   }
 }
 
+TEST_CASE("Double-only fast path")
+{
+  using namespace vita;
+
+  problem prob;
+  prob.env.init().mep.code_length = 64;
+
+  symbol_factory factory;
+  for (const auto *s : {"0.0", "1.0", "2.0", "3.0", "REAL", "FABS", "FADD",
+                        "FAQ", "FCOS", "FDIV", "FIDIV", "FIFE", "FIFL",
+                        "FIFZ", "FLN", "FMAX", "FMOD", "FMUL", "FSIGMOID",
+                        "FSIN", "FSQRT", "FSUB"})
+    prob.sset.insert(factory.make(s));
+
+  const std::vector<value_t> no_input;
+
+  for (unsigned j(0); j < 2000; ++j)
+  {
+    const i_mep ind(prob);
+
+    const auto out1(i_interp(&ind).run());
+    const auto out2(src_interpreter<i_mep>(&ind).run(no_input));
+
+    REQUIRE(has_value(out1) == has_value(out2));
+    if (has_value(out1))
+      CHECK(real::base(out1) == doctest::Approx(real::base(out2)));
+  }
+
+  // Signed zeros: FMAX gives the same zero in both paths.
+  symbol *c0(prob.sset.decode("0.0"));
+  symbol *f_max(prob.sset.decode("FMAX"));
+  symbol *f_mul(prob.sset.decode("FMUL"));
+  symbol *neg1(prob.sset.insert(factory.make("-1.0")));
+  const std::vector<index_t> null;
+
+  for (const bool neg_first : {true, false})
+  {
+    const std::vector<index_t> args(neg_first ? std::vector<index_t>{1, 2}
+                                              : std::vector<index_t>{2, 1});
+
+    const i_mep ind({
+                      {{f_max, args}},    // [0] FMAX -0.0, +0.0
+                      {{f_mul, {3, 4}}},  // [1] FMUL [3], [4]
+                      {{   c0,   null}},  // [2] 0.0
+                      {{   c0,   null}},  // [3] 0.0
+                      {{ neg1,   null}}   // [4] -1.0
+                    });
+
+    const auto out1(i_interp(&ind).run());
+    const auto out2(src_interpreter<i_mep>(&ind).run(no_input));
+
+    REQUIRE(has_value(out1));
+    REQUIRE(has_value(out2));
+    CHECK(std::signbit(real::base(out1)) == neg_first);
+    CHECK(std::signbit(real::base(out2)) == neg_first);
+  }
+}
+
 }  // TEST_SUITE("PRIMITIVE_D")
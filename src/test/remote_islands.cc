@@ -0,0 +1,237 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#include "kernel/i_mep.h"
+#include "kernel/remote_islands.h"
+#include "kernel/team.h"
+
+#include "test/fixture3.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "third_party/doctest/doctest.h"
+
+TEST_SUITE("REMOTE ISLANDS")
+{
+
+TEST_CASE_FIXTURE(fixture3, "Wire format")
+{
+  using namespace vita;
+
+  // Other tests rely on the sequence of pseudo-random numbers.
+  const auto state(random::engine);
+
+  SUBCASE("Tokens")
+  {
+    const std::string text("12 -3 0 -0 007 1.5 abc\n99999999999999999999");
+
+    std::string decoded;
+    CHECK(wire::decode(wire::encode(text), &decoded));
+    CHECK(decoded == "12 -3 0 -0 007 1.5 abc 99999999999999999999");
+
+    CHECK(!wire::decode(std::string(1, '\x07'), &decoded));
+  }
+
+  SUBCASE("Individuals")
+  {
+    std::vector<i_mep> v;
+    for (unsigned i(0); i < 100; ++i)
+    {
+      v.emplace_back(prob);
+      for (auto j(random::between(0u, 100u)); j; --j)
+        v.back().inc_age();
+    }
+    v.emplace_back();  // empty individual
+
+    const auto frame(wire::pack(v));
+
+    // The binary format is more compact than the textual one.
+    std::ostringstream ss;
+    for (const auto &prg : v)
+      prg.save(ss);
+    CHECK(frame.size() < ss.str().size());
+
+    std::vector<i_mep> v1;
+    CHECK(wire::unpack(frame, prob.sset, &v1));
+    CHECK(v == v1);
+
+    // Truncated / corrupted frames are rejected and the output isn't
+    // changed.
+    std::vector<i_mep> v2;
+    CHECK(!wire::unpack(frame.substr(0, frame.size() / 2), prob.sset, &v2));
+    CHECK(!wire::unpack("X" + frame.substr(1), prob.sset, &v2));
+    CHECK(!wire::unpack(frame + '\0', prob.sset, &v2));
+    CHECK(v2.empty());
+  }
+
+  SUBCASE("Teams")
+  {
+    std::vector<team<i_mep>> v;
+    for (unsigned i(0); i < 20; ++i)
+      v.emplace_back(prob);
+
+    std::vector<team<i_mep>> v1;
+    CHECK(wire::unpack(wire::pack(v), prob.sset, &v1));
+    CHECK(v == v1);
+  }
+
+  random::engine = state;
+}
+
+TEST_CASE_FIXTURE(fixture3, "Exchange over localhost")
+{
+  using namespace vita;
+  using namespace std::chrono_literals;
+
+  const auto state(random::engine);
+
+  prob.env.individuals = 10;
+  prob.env.island.interval = 1;
+  prob.env.island.migrants = 2;
+
+  remote_islands<i_mep> a(prob), b(prob);
+  CHECK(a.port());
+  CHECK(a.port() != b.port());
+
+  const std::vector<net::endpoint> hosts = {{"127.0.0.1", a.port()},
+                                            {"127.0.0.1", b.port()}};
+  a.join(hosts, 0);
+  b.join(hosts, 1);
+
+  population<i_mep> pa(prob), pb(prob);
+
+  // Every individual of `pa` is better than every individual of `pb`.
+  test_evaluator<i_mep> eva(test_evaluator_type::distinct);
+  for (const auto &prg : pb)
+    eva(prg);
+  for (const auto &prg : pa)
+    eva(prg);
+
+  const auto best([&](const population<i_mep> &p)
+  {
+    summary<i_mep> s;
+    for (const auto &prg : p)
+      if (s.best.solution.empty() || eva(prg) > s.best.score.fitness)
+      {
+        s.best.solution = prg;
+        s.best.score.fitness = eva(prg);
+      }
+    return s;
+  });
+
+  auto sa(best(pa)), sb(best(pb));
+
+  a.exchange(pa, eva, &sa);
+  CHECK(a.sent() == 2);
+
+  for (unsigned i(0); i < 500 && b.received() < 2; ++i)
+    std::this_thread::sleep_for(10ms);
+  REQUIRE(b.received() == 2);
+
+  b.exchange(pb, eva, &sb);
+  CHECK(b.sent() == 2);
+
+  // The best individual of `pa` has moved to `pb`.
+  CHECK(sb.best.solution == sa.best.solution);
+  CHECK(sb.best.score.fitness == sa.best.score.fitness);
+  bool found(false);
+  for (const auto &prg : pb)
+    if (prg == sa.best.solution)
+      found = true;
+  CHECK(found);
+
+  // No exchange outside the migration interval.
+  prob.env.island.interval = 2;
+  sb.gen = 2;
+  b.exchange(pb, eva, &sb);
+  CHECK(b.sent() == 2);
+
+  random::engine = state;
+}
+
+TEST_CASE_FIXTURE(fixture3, "Unfit migrants")
+{
+  using namespace vita;
+  using namespace std::chrono_literals;
+
+  const auto state(random::engine);
+
+  remote_islands<i_mep> r(prob);
+  const net::endpoint to{"127.0.0.1", r.port()};
+
+  // A frame containing a single individual in textual form.
+  const auto frame([](const std::string &text)
+  {
+    std::string f;
+    wire::detail::put_header(&f, 1);
+
+    const auto bin(wire::encode(text));
+    wire::detail::put_varint(&f, bin.size());
+    return f + bin;
+  });
+
+  // Genome of a different shape.
+  ++prob.env.mep.code_length;
+  const i_mep longer(prob);
+  --prob.env.mep.code_length;
+  CHECK(net::send(to, wire::pack(std::vector<i_mep>{longer})));
+
+  // A function referencing itself (the interpreter would loop / read out of
+  // range).
+  std::ostringstream self_ref;
+  self_ref << "0 " << prob.env.mep.code_length << " 1 "
+           << f_add->opcode() << " 0 0";
+  for (unsigned i(1); i < prob.env.mep.code_length; ++i)
+    self_ref << ' ' << c0->opcode();
+  self_ref << " 0 0";
+  CHECK(net::send(to, frame(self_ref.str())));
+
+  // Impossible allocation.
+  CHECK(net::send(to, frame("0 4000000000 4000000000")));
+
+  // The receiving thread is still working.
+  const i_mep good(prob);
+  CHECK(net::send(to, wire::pack(std::vector<i_mep>{good})));
+
+  for (unsigned i(0); i < 500 && !r.received(); ++i)
+    std::this_thread::sleep_for(10ms);
+  CHECK(r.received() == 1);
+
+  random::engine = state;
+}
+
+TEST_CASE("Bounded send")
+{
+  using namespace vita;
+  using namespace std::chrono_literals;
+
+  std::uint16_t port;
+  {
+    const net::server closed;
+    port = closed.port();
+  }
+  CHECK(!net::send({"127.0.0.1", port}, "message", 200ms));
+
+  // The receiver never reads: the sender gives up when the socket buffers
+  // are full.
+  net::server stalled;
+  const std::string big(1u << 25, 'x');
+
+  const auto start(std::chrono::steady_clock::now());
+  CHECK(!net::send({"127.0.0.1", stalled.port()}, big, 200ms));
+  CHECK(std::chrono::steady_clock::now() - start < 5s);
+}
+
+}  // TEST_SUITE("REMOTE ISLANDS")
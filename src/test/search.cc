@@ -0,0 +1,234 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <cstdlib>
+#include <sstream>
+
+#include "kernel/ga/search.h"
+#include "kernel/src/search.h"
+
+#include "test/fixture5.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "third_party/doctest/doctest.h"
+
+// Other test suites contain statistical checks that rely on the sequence of
+// pseudo-random numbers: the state of the engine is restored after every test.
+struct fixture_search
+{
+  fixture_search() : state(vita::random::engine)
+  {
+    vita::log::reporting_level = vita::log::lWARNING;
+  }
+
+  ~fixture_search() { vita::random::engine = state; }
+
+  vita::random::engine_t state;
+};
+
+TEST_SUITE("SEARCH")
+{
+
+TEST_CASE_FIXTURE(fixture_search, "Concurrent runs (symbolic regression)")
+{
+  using namespace vita;
+
+  std::stringstream ss;
+  for (unsigned i(0); i < 200; ++i)
+  {
+    const double x(i / 20.0);
+    ss << x * x * x - x << ',' << x << '\n';
+  }
+
+  src_problem pr;
+  REQUIRE(pr.data().read_csv(ss) == 200);
+  pr.setup_symbols();
+
+  pr.env.individuals = 50;
+  pr.env.generations = 10;
+  pr.env.validation_percentage = 20;
+
+  // The hold-out validation strategy changes the training set.
+  const dataframe original(pr.data());
+
+  // Calls of the callback are serialized: no need for synchronization.
+  unsigned generations(0);
+
+  const auto run([&](unsigned parallel_runs, validator_id v)
+  {
+    pr.data() = original;
+    pr.data(dataset_t::validation).clear();
+    pr.env.parallel_runs = parallel_runs;
+
+    src_search<> s(pr);
+    s.evaluator(evaluator_id::mae).validation_strategy(v);
+    s.after_generation([&](const population<i_mep> &, const summary<i_mep> &)
+                       {
+                         ++generations;
+                       });
+
+    random::seed(42);
+    return s.run(6);
+  });
+
+  for (auto v : {validator_id::as_is, validator_id::holdout})
+  {
+    generations = 0;
+    const auto s1(run(1, v));
+    CHECK(generations == s1.gen);
+
+    generations = 0;
+    const auto s4(run(4, v));
+    CHECK(generations == s4.gen);
+
+    CHECK(s1.best.score.fitness == s4.best.score.fitness);
+    CHECK(s1.best.solution == s4.best.solution);
+    CHECK(s1.gen == s4.gen);
+  }
+}
+
+TEST_CASE_FIXTURE(fixture_search, "Island model (symbolic regression)")
+{
+  using namespace vita;
+
+  std::stringstream ss;
+  for (unsigned i(0); i < 200; ++i)
+  {
+    const double x(i / 20.0);
+    ss << 2.0 * x * x + x << ',' << x << '\n';
+  }
+
+  src_problem pr;
+  REQUIRE(pr.data().read_csv(ss) == 200);
+  pr.setup_symbols();
+
+  pr.env.individuals = 30;
+  pr.env.generations = 6;
+  pr.env.island.interval = 2;
+
+  // With concurrent runs every run evolves its islands sequentially,
+  // otherwise islands are evolved concurrently.
+  const auto run([&](unsigned parallel_runs)
+  {
+    pr.env.parallel_runs = parallel_runs;
+
+    src_search<i_mep, island_es> s(pr);
+    s.evaluator(evaluator_id::mae);
+
+    random::seed(42);
+    return s.run(3);
+  });
+
+  const auto s1(run(1)), s3(run(3));
+
+  CHECK(s1.best.score.fitness == s3.best.score.fitness);
+  CHECK(s1.best.solution == s3.best.solution);
+  CHECK(s1.gen == s3.gen);
+}
+
+TEST_CASE_FIXTURE(fixture_search, "Persistent cache (symbolic regression)")
+{
+  using namespace vita;
+
+  std::stringstream ss;
+  for (unsigned i(0); i < 100; ++i)
+  {
+    const double x(i / 10.0);
+    ss << x * x + 1.0 << ',' << x << '\n';
+  }
+
+  src_problem pr;
+  REQUIRE(pr.data().read_csv(ss) == 100);
+  pr.setup_symbols();
+
+  pr.env.individuals = 40;
+  pr.env.generations = 10;
+  pr.env.misc.cache_file = std::filesystem::temp_directory_path()
+                           / "vita_search_cache.bin";
+  std::filesystem::remove(pr.env.misc.cache_file);
+
+  const auto run([&]
+  {
+    src_search<> s(pr);
+    s.evaluator(evaluator_id::mse);
+
+    random::seed(42);
+    return s.run(2);
+  });
+
+  // The second search starts with a warm cache: same results.
+  const auto s1(run());
+  REQUIRE(std::filesystem::exists(pr.env.misc.cache_file));
+  const auto s2(run());
+
+  CHECK(s1.best.score.fitness == s2.best.score.fitness);
+  CHECK(s1.best.solution == s2.best.solution);
+
+  // The file contains the best individual.
+  src_search<> p(pr);
+  p.evaluator(evaluator_id::mse);
+
+  persistent_cache c(pr.env.cache_size);
+  REQUIRE(c.open(pr.env.misc.cache_file, p.fingerprint()));
+  CHECK(c.find(s1.best.solution.signature()) == s1.best.score.fitness);
+
+  // The fingerprint follows the changes of the training set.
+  const auto fp(p.fingerprint());
+  CHECK(p.fingerprint() == fp);
+
+  auto e(pr.data().front());
+  e.output = lexical_cast<D_DOUBLE>(e.output) + 1.0;
+  pr.data().push_back(e);
+  const auto fp_more(p.fingerprint());
+  CHECK(fp_more != fp);
+
+  pr.data().erase(std::prev(pr.data().end()), pr.data().end());
+  CHECK(p.fingerprint() == fp);
+
+  std::filesystem::remove(pr.env.misc.cache_file);
+}
+
+TEST_CASE_FIXTURE(fixture5_no_init, "Concurrent runs (DE)")
+{
+  using namespace vita;
+
+  const fixture_search fs;
+
+  prob.env.individuals = 50;
+  prob.env.generations = 20;
+  prob.sset.insert<ga::real>(range(-10.0, 10.0));
+  prob.sset.insert<ga::real>(range(-10.0, 10.0));
+
+  auto f = [](const std::vector<double> &x)
+           {
+             return -(std::pow(x[0] - 1.0, 2.0) + std::pow(x[1] + 2.0, 2.0));
+           };
+
+  const auto run([&](unsigned parallel_runs)
+  {
+    prob.env.parallel_runs = parallel_runs;
+
+    de_search<decltype(f)> s(prob, f);
+
+    random::seed(42);
+    return s.run(5);
+  });
+
+  const auto s1(run(1)), s3(run(3)), s5(run(5));
+
+  CHECK(s1.best.score.fitness == s3.best.score.fitness);
+  CHECK(s1.best.solution == s3.best.solution);
+  CHECK(s1.best.score.fitness == s5.best.score.fitness);
+  CHECK(s1.best.solution == s5.best.solution);
+}
+
+}  // TEST_SUITE("SEARCH")
@@ -0,0 +1,70 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <vector>
+
+#include "kernel/cache.h"
+
+#include "utility/timer.h"
+#include "utility/xoshiro256ss.h"
+
+// Compares hit ratio and throughput of the cache with a growing number of
+// ways (the memory used is always the same, `ways == 1` is a direct-mapped
+// table).
+//
+// The workload resembles an evolution: a set of elite individuals is
+// requested again and again, while a flood of new offspring is evaluated
+// (and inserted) just once.
+int main()
+{
+  const std::uint8_t bits(16);
+  const std::size_t elite(1u << (bits - 2));  // a quarter of the table
+  const unsigned requests(20000000);
+
+  vigna::xoshiro256ss e;
+
+  std::vector<vita::hash_t> hot(elite);
+  for (auto &h : hot)
+    h = vita::hash_t(e(), e());
+
+  const vita::fitness_t f{1.0};
+
+  for (unsigned ways(1); ways <= 16; ways *= 2)
+  {
+    vita::cache c(bits, ways);
+    vigna::xoshiro256ss r;
+
+    vita::timer t;
+    for (unsigned i(0); i < requests; ++i)
+    {
+      const auto x(r());
+
+      // Half of the requests regard the elite.
+      const vita::hash_t h(x & 1 ? hot[(x >> 1) % elite]
+                                 : vita::hash_t(r(), x));
+
+      if (!c.find(h).size())
+        c.insert(h, f);
+    }
+    const auto elapsed(t.elapsed().count());
+
+    std::cout << "WAYS " << std::setw(2) << ways
+              << " - Hit ratio: " << std::fixed << std::setprecision(2)
+              << 100.0 * c.hits() / c.probes() << "%"
+              << "  Evictions: " << c.evictions()
+              << "  Elapsed: " << elapsed << "ms\n";
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "utility/csv_parser.h"
+#include "utility/timer.h"
+#include "utility/xoshiro256ss.h"
+
+namespace
+{
+
+std::size_t sink(0);
+
+// Writes a CSV file of (about) `mb` megabytes: a string label, twenty
+// numeric features and, every few lines, a quoted field.
+void generate(const std::filesystem::path &fn, std::size_t mb)
+{
+  vigna::xoshiro256ss e;
+
+  std::ofstream out(fn);
+  std::string line;
+  for (std::size_t written(0); written < (mb << 20); written += line.size())
+  {
+    line = e() % 2 ? "\"class A\"" : "class B";
+    for (unsigned i(0); i < 20; ++i)
+      line += "," + std::to_string(static_cast<double>(e() % 100000) / 7.0);
+    if (e() % 8 == 0)
+      line += ",\"a \"\"quoted\"\", field\"";
+    line += '\n';
+
+    out << line;
+  }
+}
+
+// Prints the time taken to parse the file and the resulting throughput.
+template<class F>
+void report(const std::string &name, std::size_t bytes, F parse)
+{
+  vita::timer t;
+  const std::size_t records(parse());
+  const double ms(std::max<double>(t.elapsed().count(), 1.0));
+
+  std::cout << std::setw(28) << std::left << name << std::right
+            << std::setw(12) << records << std::setw(10) << ms / 1000.0
+            << std::setw(10) << bytes / (ms * 1000.0) << '\n';
+}
+
+}  // unnamed namespace
+
+// Compares the line-by-line `csv_parser` with the `csv_block_parser` (single
+// thread and all the hardware threads) on a large synthetic CSV file.
+//
+// Usage: `speed_csv [size in MB]` (default 2048). The temporary file is
+// removed at the end.
+int main(int argc, char *argv[])
+{
+  using namespace vita;
+
+  const std::size_t mb(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2048);
+  const auto fn(std::filesystem::temp_directory_path() / "vita_speed_csv.csv");
+
+  std::cout << "Generating " << mb << "MB CSV file (" << fn << ")...\n";
+  generate(fn, mb);
+  const auto bytes(std::filesystem::file_size(fn));
+
+  csv_dialect dialect;
+  dialect.has_header = false;
+
+  std::cout << '\n' << std::setw(28) << std::left << "parser" << std::right
+            << std::setw(12) << "records" << std::setw(10) << "time (s)"
+            << std::setw(10) << "MB/s" << '\n'
+            << std::fixed << std::setprecision(2);
+
+  report("csv_parser", bytes, [&]
+  {
+    std::ifstream in(fn);
+    std::size_t n(0);
+    for (const auto &r : csv_parser(in, dialect))
+    {
+      sink += r.size();
+      ++n;
+    }
+    return n;
+  });
+
+  const auto block([&](unsigned threads)
+  {
+    return [&, threads]
+    {
+      std::ifstream in(fn);
+      return csv_block_parser(in, dialect).threads(threads).for_each(
+        [](const csv_block_parser::fields_t &fields)
+        {
+          sink += fields.size();
+        });
+    };
+  });
+
+  report("csv_block_parser (1 thread)", bytes, block(1));
+
+  const auto hw(std::max(std::thread::hardware_concurrency(), 1u));
+  if (hw > 1)
+    report("csv_block_parser (" + std::to_string(hw) + " threads)", bytes,
+           block(hw));
+
+  std::filesystem::remove(fn);
+
+  return sink ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,148 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <vector>
+
+#include "kernel/cache_hash.h"
+#include "kernel/evaluator_proxy.h"
+#include "kernel/ga/evaluator.h"
+#include "kernel/ga/i_de.h"
+#include "kernel/ga/problem.h"
+
+#include "utility/timer.h"
+#include "utility/xoshiro256ss.h"
+
+namespace
+{
+
+std::uint64_t sink(0);
+
+// Throughput (GB/s) of the hash function `H` on messages of `len` bytes.
+template<class H>
+double throughput(const std::vector<unsigned char> &buffer, std::size_t len)
+{
+  const std::size_t total(1ull << 31);  // bytes hashed for every test
+  const auto n(total / len);
+
+  vita::timer t;
+  for (std::size_t i(0); i < n; ++i)
+  {
+    // Different messages (the offset changes) avoid loop-invariant hashes.
+    const auto h(H::hash128(buffer.data() + (i & 63), len));
+    sink += h.data[0] ^ h.data[1];
+  }
+  const double elapsed(t.elapsed().count());
+
+  return elapsed > 0.0 ? n * len / (elapsed * 1.0e6) : 0.0;
+}
+
+// Average time (ns) taken by the hash function `H` to sign a genome of `n`
+// parameters.
+template<class H>
+double sign_time(std::size_t n)
+{
+  const unsigned rounds(10000000);
+
+  vigna::xoshiro256ss r;
+  std::vector<double> genome(n);
+
+  vita::timer t;
+  for (unsigned i(0); i < rounds; ++i)
+  {
+    genome[i % n] = static_cast<double>(r());
+
+    const auto h(H::hash128(genome.data(), n * sizeof(double)));
+    sink += h.data[0] ^ h.data[1];
+  }
+
+  return t.elapsed().count() * 1.0e6 / rounds;
+}
+
+}  // unnamed namespace
+
+// Compares the hash functions available for signatures:
+// - throughput on messages of growing size;
+// - time needed to sign the genome of an `i_de` individual;
+// - overhead of the evaluation cache (`evaluator_proxy`, using the current
+//   `vita::hash`) with respect to a cheap fitness function.
+int main()
+{
+  using namespace vita;
+
+  std::vector<unsigned char> buffer((1u << 20) + 64);
+  vigna::xoshiro256ss e;
+  for (auto &b : buffer)
+    b = static_cast<unsigned char>(e());
+
+  std::cout << "THROUGHPUT (GB/s)\n"
+            << "     bytes  murmurhash3     mulxhash\n";
+  for (std::size_t len : {8u, 16u, 40u, 64u, 128u, 256u, 1024u, 16384u,
+                          1u << 20})
+    std::cout << std::setw(10) << len << std::fixed << std::setprecision(2)
+              << std::setw(13) << throughput<murmurhash3>(buffer, len)
+              << std::setw(13) << throughput<mulxhash>(buffer, len) << '\n';
+
+  std::cout << "\nI_DE SIGNATURE (ns)\n"
+            << "parameters  murmurhash3     mulxhash\n";
+  for (std::size_t n : {4u, 16u, 32u, 64u})
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(1)
+              << std::setw(13) << sign_time<murmurhash3>(n)
+              << std::setw(13) << sign_time<mulxhash>(n) << '\n';
+
+  // Every evaluation regards a new individual (as for the offspring of an
+  // evolution): the proxy must compute the signature and miss the cache.
+  std::cout << "\nEVALUATOR_PROXY OVERHEAD (hash id " << hash::id << ")\n"
+            << "parameters    direct (ns)   proxy (ns)\n";
+  for (std::size_t n : {4u, 16u, 32u, 64u})
+  {
+    de_problem prob(n, range(-10.0, 10.0));
+    prob.env.init();
+
+    const auto sphere([](const std::vector<double> &x)
+                      {
+                        double s(0.0);
+                        for (auto v : x)
+                          s += v * v;
+                        return -s;
+                      });
+
+    using eva_t = ga_evaluator<i_de, decltype(sphere)>;
+    eva_t eva(sphere);
+    evaluator_proxy<i_de, eva_t> proxy(eva, 16);
+
+    const unsigned rounds(2000000);
+    i_de ind(prob);
+
+    const auto run([&](auto &evaluate)
+                   {
+                     vigna::xoshiro256ss r;
+
+                     timer t;
+                     for (unsigned i(0); i < rounds; ++i)
+                     {
+                       ind[i % n] = static_cast<double>(r() >> 11);
+                       sink += static_cast<std::uint64_t>(evaluate(ind)[0]);
+                     }
+                     return t.elapsed().count() * 1.0e6 / rounds;
+                   });
+
+    const auto direct(run(eva));
+    const auto cached(run(proxy));
+
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(1)
+              << std::setw(15) << direct << std::setw(13) << cached << '\n';
+  }
+
+  return sink ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -16,6 +16,7 @@
 #include "test/dataframe.cc"
 #include "test/de.cc"
 #include "test/discretization.cc"
+#include "test/evaluator.cc"
 #include "test/evolution.cc"
 #include "test/evolution_selection.cc"
 #include "test/facultative.cc"
@@ -31,6 +32,8 @@
 #include "test/population_coord.cc"
 #include "test/primitive_d.cc"
 #include "test/primitive_i.cc"
+#include "test/remote_islands.cc"
+#include "test/search.cc"
 #include "test/small_vector.cc"
 #include "test/src_constant.cc"
 #include "test/src_problem.cc"
@@ -40,3 +43,4 @@
 #include "test/terminal.cc"
 #include "test/utility.cc"
 #include "test/value.cc"
+#include "test/xml_reader.cc"
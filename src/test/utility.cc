@@ -10,8 +10,13 @@
  *  You can obtain one at http://mozilla.org/MPL/2.0/
  */
 
+#include <atomic>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
 
+#include "utility/spsc_queue.h"
+#include "utility/thread_pool.h"
 #include "utility/utility.h"
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
@@ -40,4 +45,113 @@ TEST_CASE("is_number")
   CHECK(!is_number("'1'"));
 }
 
+TEST_CASE("thread_pool")
+{
+  using namespace vita;
+
+  for (unsigned n(1); n <= 4; ++n)
+  {
+    thread_pool pool(n);
+    CHECK(pool.size() == n);
+
+    for (std::size_t tasks : {0, 1, 2, 100, 1000})
+    {
+      std::vector<unsigned> executed(tasks, 0);
+      std::atomic<bool> wrong_worker(false);
+
+      pool.run(tasks, [&](std::size_t i, unsigned w)
+                      {
+                        ++executed[i];
+                        if (w >= n)
+                          wrong_worker = true;
+                      });
+
+      CHECK(std::all_of(executed.begin(), executed.end(),
+                        [](unsigned e) { return e == 1; }));
+      CHECK(!wrong_worker);
+    }
+
+    CHECK_THROWS_AS(pool.run(10, [](std::size_t i, unsigned)
+                                 {
+                                   if (i == 5)
+                                     throw std::runtime_error("task");
+                                 }),
+                    std::runtime_error);
+
+    // The pool is still usable after an exception.
+    std::atomic<unsigned> count(0);
+    pool.run(10, [&](std::size_t, unsigned) { ++count; });
+    CHECK(count == 10);
+  }
+
+  CHECK(thread_pool(0).size() >= 1);
+}
+
+TEST_CASE("spsc_queue")
+{
+  using namespace vita;
+
+  SUBCASE("Single thread")
+  {
+    spsc_queue<int> q(3);
+    CHECK(q.capacity() == 3);
+    CHECK(q.empty());
+
+    int e(-1);
+    CHECK(!q.pop(&e));
+    CHECK(e == -1);
+
+    CHECK(q.push(1));
+    CHECK(q.push(2));
+    CHECK(q.push(3));
+    CHECK(!q.push(4));
+    CHECK(!q.empty());
+
+    CHECK(q.pop(&e));
+    CHECK(e == 1);
+    CHECK(q.push(4));
+
+    for (int i(2); i <= 4; ++i)
+    {
+      CHECK(q.pop(&e));
+      CHECK(e == i);
+    }
+
+    CHECK(q.empty());
+  }
+
+  SUBCASE("Producer / consumer")
+  {
+    const int n(100000);
+    spsc_queue<int> q(16);
+
+    std::thread producer([&q]
+                         {
+                           for (int i(0); i < n; ++i)
+                             while (!q.push(i))
+                               std::this_thread::yield();
+                         });
+
+    // Elements arrive in order and none is lost.
+    bool ordered(true);
+    for (int expected(0); expected < n;)
+    {
+      int e;
+      if (q.pop(&e))
+      {
+        if (e != expected)
+          ordered = false;
+        ++expected;
+      }
+      else
+        std::this_thread::yield();
+    }
+
+    producer.join();
+
+    CHECK(ordered);
+    CHECK(q.empty());
+  }
+}
+
 }  // TEST_SUITE("UTILITY")
@@ -0,0 +1,113 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <sstream>
+
+#include "utility/xml_reader.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "third_party/doctest/doctest.h"
+
+namespace
+{
+
+// A compact trace of the events of a document: `<name` for start elements,
+// `>name=text` for end elements, `$` for the end of the document and `!` for
+// errors.
+std::string trace(const std::string &doc)
+{
+  std::istringstream is(doc);
+  vita::xml_reader xml(is);
+
+  std::string ret;
+  for (;;)
+    switch (xml.next())
+    {
+    case vita::xml_reader::start_element:
+      ret += "<" + xml.name();
+      break;
+    case vita::xml_reader::end_element:
+      ret += ">" + xml.name() + "=" + xml.text();
+      break;
+    case vita::xml_reader::end_document:
+      return ret + "$";
+    case vita::xml_reader::error:
+      return ret + "!";
+    }
+}
+
+}  // unnamed namespace
+
+TEST_SUITE("XML_READER")
+{
+
+TEST_CASE("Events")
+{
+  CHECK(trace("<a/>") == "<a>a=$");
+  CHECK(trace("<a>x</a>") == "<a>a=x$");
+  CHECK(trace("<a><b>1</b><b/><c>2</c></a>") == "<a<b>b=1<b>b=<c>c=2>a=$");
+  CHECK(trace("  <a> x y </a>\n") == "<a>a= x y $");
+
+  // Prolog, comments, processing instructions and DOCTYPE are skipped.
+  CHECK(trace("<?xml version=\"1.0\"?>\n"
+              "<!DOCTYPE a [<!ELEMENT a (#PCDATA)>]>\n"
+              "<!-- a comment -->"
+              "<a>x<!-- -- --->y<?pi ?>z</a>") == "<a>a=xyz$");
+}
+
+TEST_CASE("Text")
+{
+  CHECK(trace("<a>&lt;&gt;&amp;&quot;&apos;</a>") == "<a>a=<>&\"'$");
+  CHECK(trace("<a>&#65;&#x42;&#xe8;</a>") == "<a>a=AB\xC3\xA8$");
+  CHECK(trace("<a><![CDATA[<b>&amp;]]]></a>") == "<a>a=<b>&amp;]$");
+}
+
+TEST_CASE("Attributes")
+{
+  std::istringstream is(R"(<a x="1" y = 'two' z="&lt;3&gt;"><b/></a>)");
+  vita::xml_reader xml(is);
+
+  CHECK(xml.next() == vita::xml_reader::start_element);
+  CHECK(xml.name() == "a");
+  CHECK(xml.path() == std::vector<std::string>{"a"});
+  CHECK(xml.attribute("x") == "1");
+  CHECK(xml.attribute("y") == "two");
+  CHECK(xml.attribute("z") == "<3>");
+  CHECK(!xml.attribute("w"));
+
+  CHECK(xml.next() == vita::xml_reader::start_element);
+  CHECK(xml.path() == std::vector<std::string>{"a", "b"});
+  CHECK(!xml.attribute("x"));
+
+  CHECK(xml.next() == vita::xml_reader::end_element);
+  CHECK(xml.path() == std::vector<std::string>{"a", "b"});
+
+  CHECK(xml.next() == vita::xml_reader::end_element);
+  CHECK(xml.path() == std::vector<std::string>{"a"});
+
+  CHECK(xml.next() == vita::xml_reader::end_document);
+}
+
+TEST_CASE("Errors")
+{
+  CHECK(trace("") == "!");
+  CHECK(trace("<a>") == "<a!");
+  CHECK(trace("<a></b>") == "<a!");
+  CHECK(trace("<a><b></a>") == "<a<b!");
+  CHECK(trace("<a/><b/>") == "<a>a=!");
+  CHECK(trace("text<a/>") == "!");
+  CHECK(trace("<a x=1/>") == "!");
+  CHECK(trace("<a>&unknown;</a>") == "<a!");
+  CHECK(trace("<a><!-- unterminated</a>") == "<a!");
+}
+
+}  // TEST_SUITE("XML_READER")
@@ -10,7 +10,11 @@
  *  You can obtain one at http://mozilla.org/MPL/2.0/
  */
 
+#include <cstring>
+#include <future>
+
 #include "utility/csv_parser.h"
+#include "utility/thread_pool.h"
 #include "utility/utility.h"
 
 namespace
@@ -62,6 +66,88 @@ bool upper_case(const std::string &s)
                      });
 }
 
+bool is_space(char c)
+{
+  return std::isspace(static_cast<unsigned char>(c));
+}
+
+// `true` if the `[first, last[` range contains only spaces.
+bool blank(const char *first, const char *last)
+{
+  return std::all_of(first, last, is_space);
+}
+
+std::string_view trim_view(std::string_view s)
+{
+  while (!s.empty() && is_space(s.front()))
+    s.remove_prefix(1);
+  while (!s.empty() && is_space(s.back()))
+    s.remove_suffix(1);
+
+  return s;
+}
+
+constexpr std::uint64_t ones = 0x0101010101010101ull;
+constexpr std::uint64_t highs = 0x8080808080808080ull;
+
+// A word with every byte equal to `c`.
+constexpr std::uint64_t broadcast(char c)
+{
+  return ones * static_cast<unsigned char>(c);
+}
+
+// Non-zero if and only if a byte of `x` is zero. It can report false
+// positives but only in the bytes following a real zero byte.
+constexpr std::uint64_t zero_byte(std::uint64_t x)
+{
+  return (x - ones) & ~x & highs;
+}
+
+// Finds the characters which are relevant for the field splitting (quote,
+// delimiter, carriage return and `\0`) examining eight characters at a time
+// (SIMD within a register).
+class special_finder
+{
+public:
+  explicit special_finder(char delim) : delim_(delim), word_(broadcast(delim))
+  {
+  }
+
+  // Returns the position of the first special character in `[p, end[` or
+  // `end`.
+  const char *operator()(const char *p, const char *end) const
+  {
+    for (; end - p >= 8; p += 8)
+    {
+      std::uint64_t w;
+      std::memcpy(&w, p, sizeof(w));
+
+      // A match in the word (false positives are always preceded by a real
+      // match) is located by the slower check that follows.
+      if (zero_byte(w ^ word_) | zero_byte(w ^ quotes_) | zero_byte(w ^ cr_)
+          | zero_byte(w))
+        break;
+    }
+
+    while (p != end && !special(*p))
+      ++p;
+
+    return p;
+  }
+
+private:
+  bool special(char c) const
+  {
+    return c == delim_ || c == '"' || c == '\r' || c == '\0';
+  }
+
+  static constexpr std::uint64_t quotes_ = broadcast('"');
+  static constexpr std::uint64_t cr_ = broadcast('\r');
+
+  char delim_;
+  std::uint64_t word_;
+};
+
 }  // unnamed namespace
 
 namespace vita
@@ -423,4 +509,400 @@ csv_parser::const_iterator::value_type csv_parser::const_iterator::parse_line(
   return record;
 }
 
+///
+/// Records contained in a chunk of a block.
+///
+struct csv_block_parser::chunk
+{
+  const char *first = nullptr;
+  const char *last = nullptr;
+
+  // The `i`-th record contains the fields in the `[ends[i-1], ends[i][`
+  // range (`ends[-1]` is `0`).
+  std::vector<std::string_view> fields = {};
+  std::vector<std::size_t> ends = {};
+
+  // Content of the quoted fields. Its capacity is reserved in advance (the
+  // content of a field is never longer than its source) so the views don't
+  // get invalidated.
+  std::string unquoted = {};
+};
+
+///
+/// A newline-aligned block of the CSV file.
+///
+struct csv_block_parser::block
+{
+  std::string data = {};
+  std::vector<chunk> chunks = {};
+};
+
+///
+/// Initializes the parser trying to sniff the CSV format.
+///
+/// \param[in] is input stream containing CSV data
+///
+csv_block_parser::csv_block_parser(std::istream &is)
+  : csv_block_parser(is, {})
+{
+  dialect_ = csv_sniffer(is);
+}
+
+///
+/// Initializes the parser.
+///
+/// \param[in] is input stream containing CSV data
+/// \param[in] d  dialect used for CSV data
+///
+csv_block_parser::csv_block_parser(std::istream &is, const csv_dialect &d)
+  : is_(&is), filter_hook_(nullptr), dialect_(d), threads_(0),
+    block_size_(1u << 24)
+{
+}
+
+///
+/// \return a constant reference to the active CSV dialect
+///
+const csv_dialect &csv_block_parser::dialect() const
+{
+  return dialect_;
+}
+
+///
+/// \param[in] filter a filter function for CSV records
+/// \return           a reference to `this` object (fluent interface)
+///
+/// \note
+/// A filter function returns `true` for records to be keep. It's called
+/// sequentially, in file order (as for vita::csv_parser).
+///
+/// \remark
+/// Filtered records are copied (the filter can change them).
+///
+csv_block_parser &csv_block_parser::filter_hook(filter_hook_t filter) &
+{
+  filter_hook_ = filter;
+  return *this;
+}
+csv_block_parser csv_block_parser::filter_hook(filter_hook_t filter) &&
+{
+  filter_hook_ = filter;
+  return *this;
+}
+
+///
+/// \param[in] n number of threads used for parsing (`0` means the number of
+///              concurrent threads supported by the hardware)
+/// \return      a reference to `this` object (fluent interface)
+///
+csv_block_parser &csv_block_parser::threads(unsigned n) &
+{
+  threads_ = n;
+  return *this;
+}
+csv_block_parser csv_block_parser::threads(unsigned n) &&
+{
+  threads_ = n;
+  return *this;
+}
+
+///
+/// \param[in] n size (in bytes) of the blocks read from the input stream
+/// \return      a reference to `this` object (fluent interface)
+///
+/// \remark
+/// Two blocks are kept in memory at the same time. Lines longer than a block
+/// are allowed.
+///
+csv_block_parser &csv_block_parser::block_size(std::size_t n) &
+{
+  Expects(n);
+  block_size_ = n;
+  return *this;
+}
+csv_block_parser csv_block_parser::block_size(std::size_t n) &&
+{
+  Expects(n);
+  block_size_ = n;
+  return *this;
+}
+
+///
+/// Parses the whole input stream.
+///
+/// \param[in] f function called for every record (in file order)
+/// \return      number of records delivered
+///
+/// As vita::csv_parser::begin, parsing starts from the beginning of the
+/// stream.
+///
+std::size_t csv_block_parser::for_each(
+  const std::function<void (const fields_t &)> &f) const
+{
+  Expects(is_);
+
+  is_->clear();
+  is_->seekg(0, std::ios::beg);  // back to the start!
+
+  thread_pool pool(threads_);
+
+  std::string carry;  // incomplete line at the end of the last block read
+
+  // Blocks are never moved: views refer to their buffers.
+  block blocks[2];
+  unsigned current(0);
+
+  if (!read_block(blocks[current].data, carry))
+    return 0;
+  parse(blocks[current], pool);
+
+  fields_t fields;
+  record_t record;
+  std::size_t count(0);
+
+  for (bool more(true); more;)
+  {
+    // Reading and parsing of the next block overlap with the delivery of the
+    // current one.
+    auto &next(blocks[!current]);
+
+    std::future<void> pending;
+    more = read_block(next.data, carry);
+    if (more)
+      pending = std::async(pool.size() > 1 ? std::launch::async
+                                           : std::launch::deferred,
+                           [&] { parse(next, pool); });
+
+    for (const auto &c : blocks[current].chunks)
+      for (std::size_t r(0), begin(0); r < c.ends.size(); begin = c.ends[r++])
+      {
+        const auto b(std::next(c.fields.begin(), begin));
+        const auto e(std::next(c.fields.begin(), c.ends[r]));
+
+        if (filter_hook_)
+        {
+          record.assign(b, e);
+          if (!filter_hook_(record))
+            continue;
+
+          fields.assign(record.begin(), record.end());
+        }
+        else
+          fields.assign(b, e);
+
+        f(fields);
+        ++count;
+      }
+
+    if (pending.valid())
+      pending.get();
+    current = !current;
+  }
+
+  return count;
+}
+
+///
+/// Reads the next block of the input stream.
+///
+/// \param[out]    buffer the block. It contains whole lines only
+/// \param[in,out] carry  the incomplete line at the end of the previous
+///                       block (input) / of this block (output)
+/// \return               `false` if there isn't more input
+///
+bool csv_block_parser::read_block(std::string &buffer,
+                                  std::string &carry) const
+{
+  buffer.swap(carry);
+  carry.clear();
+
+  for (;;)
+  {
+    const auto old(buffer.size());
+    buffer.resize(old + block_size_);
+    is_->read(buffer.data() + old, block_size_);
+    buffer.resize(old + is_->gcount());
+
+    if (!*is_)  // end of input: the last line may lack the terminator
+      return !buffer.empty();
+
+    // `carry` never contains a newline: a match is always in the new data.
+    if (const auto nl = buffer.rfind('\n'); nl != std::string::npos)
+    {
+      carry.assign(buffer, nl + 1, std::string::npos);
+      buffer.resize(nl + 1);
+      return true;
+    }
+  }
+}
+
+///
+/// Splits a block into newline-aligned chunks and parses them in parallel.
+///
+/// \param[in,out] b   a block
+/// \param[in]    pool threads used for parsing
+///
+void csv_block_parser::parse(block &b, thread_pool &pool) const
+{
+  const std::size_t min_chunk(1u << 16);  // smaller chunks aren't worthwhile
+
+  const char *const first(b.data.data());
+  const char *const last(first + b.data.size());
+
+  const auto n(std::clamp<std::size_t>(b.data.size() / min_chunk,
+                                       1, pool.size()));
+
+  b.chunks.resize(n);
+  const char *p(first);
+  for (std::size_t i(0); i < n; ++i)
+  {
+    const char *end(i + 1 < n ? first + (i + 1) * b.data.size() / n : last);
+
+    end = std::max(end, p);
+    if (end != last)
+    {
+      end = static_cast<const char *>(std::memchr(end, '\n', last - end));
+      end = end ? end + 1 : last;
+    }
+
+    b.chunks[i].first = p;
+    b.chunks[i].last = end;
+    p = end;
+  }
+
+  pool.run(n, [&](std::size_t i, unsigned)
+              {
+                parse_chunk(b.chunks[i]);
+              });
+}
+
+///
+/// Parses the lines of a chunk.
+///
+/// \param[in,out] out a chunk (its `fields` and `ends` are filled)
+///
+/// Produces the same fields of `csv_parser::const_iterator::parse_line`.
+///
+void csv_block_parser::parse_chunk(chunk &out) const
+{
+  const char *first(out.first);
+  const char *const last(out.last);
+
+  out.fields.clear();
+  out.ends.clear();
+  out.unquoted.clear();
+
+  const special_finder find(dialect_.delimiter);
+
+  const auto add_field([&](std::string_view field)
+                       {
+                         out.fields.push_back(dialect_.trim_ws
+                                              ? trim_view(field) : field);
+                       });
+
+  for (const char *eol; first < last; first = eol + 1)
+  {
+    eol = static_cast<const char *>(std::memchr(first, '\n', last - first));
+    if (!eol)
+      eol = last;
+
+    if (blank(first, eol))  // skips empty lines
+      continue;
+
+    for (const char *field(first), *p(first);;)
+    {
+      p = find(p, eol);
+
+      if (p != eol && *p == '"')
+      {
+        if (!blank(field, p))  // a quote inside a field is a normal character
+        {
+          ++p;
+          continue;
+        }
+
+        p = parse_quoted(field, eol, out);
+      }
+      else
+        add_field({field, static_cast<std::size_t>(p - field)});
+
+      if (p == eol || *p != dialect_.delimiter)  // `\r`, `\0` or end of line
+        break;
+
+      field = ++p;
+    }
+
+    out.ends.push_back(out.fields.size());
+  }
+}
+
+///
+/// Parses a field containing quotes.
+///
+/// \param[in]  first beginning of the field
+/// \param[in]  eol   end of the line
+/// \param[out] out   the field is appended to `out.fields`
+/// \return           the end of the field
+///
+/// This is the slow path: the character by character state machine of
+/// `csv_parser::const_iterator::parse_line`.
+///
+const char *csv_block_parser::parse_quoted(const char *first, const char *eol,
+                                           chunk &out) const
+{
+  const char quote('"');
+
+  if (out.unquoted.capacity() < static_cast<std::size_t>(out.last - out.first))
+    out.unquoted.reserve(out.last - out.first);
+  const auto start(out.unquoted.size());
+
+  const auto field_blank([&]
+                         {
+                           return blank(out.unquoted.data() + start,
+                                        out.unquoted.data()
+                                        + out.unquoted.size());
+                         });
+
+  bool inquotes(false);
+  const char *p(first);
+  for (; p != eol && *p; ++p)
+  {
+    const auto c(*p);
+
+    if (!inquotes && c == quote && field_blank())  // begin quote char
+    {
+      if (dialect_.quoting == csv_dialect::KEEP_QUOTES)
+        out.unquoted.push_back(c);
+
+      inquotes = true;
+    }
+    else if (inquotes && c == quote)
+    {
+      if (p + 1 != eol && p[1] == quote)  // quote char
+      {
+        // Encountered 2 double quotes in a row (resolves to 1 double quote).
+        out.unquoted.push_back(c);
+        ++p;
+      }
+      else  // end quote char
+      {
+        if (dialect_.quoting == csv_dialect::KEEP_QUOTES)
+          out.unquoted.push_back(c);
+
+        inquotes = false;
+      }
+    }
+    else if (!inquotes && (c == dialect_.delimiter || c == '\r'))
+      break;
+    else
+      out.unquoted.push_back(c);
+  }
+
+  const std::string_view field(out.unquoted.data() + start,
+                               out.unquoted.size() - start);
+  out.fields.push_back(dialect_.trim_ws ? trim_view(field) : field);
+
+  return p;
+}
+
 }  // namespace vita
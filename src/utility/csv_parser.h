@@ -19,12 +19,15 @@
 #include <functional>
 #include <optional>
 #include <sstream>
+#include <string_view>
 
 #include "kernel/common.h"
 
 namespace vita
 {
 
+class thread_pool;
+
 ///
 /// Information about the CSV dialect.
 ///
@@ -153,6 +156,70 @@ private:
   value_type value_;
 };  // class csv_parser::const_iterator
 
+///
+/// A high-throughput parser for (large) CSV files.
+///
+/// It accepts the same dialects of vita::csv_parser and produces the same
+/// records (with the same `filter_hook` semantics) but:
+/// - the input is read in large blocks (see `block_size`) and not line by
+///   line;
+/// - delimiters, quotes and line terminators are searched a machine word (8
+///   characters) at a time;
+/// - fields are `std::string_view`s referring to the block buffer. Only
+///   quoted fields are copied (they may need unescaping);
+/// - every block is split into newline-aligned chunks parsed in parallel (see
+///   `threads`) and the next block is parsed while the records of the
+///   current one are delivered.
+///
+/// Records are delivered, in file order, by `for_each`:
+///
+///     csv_block_parser(f, dialect).for_each(
+///       [](const csv_block_parser::fields_t &fields) { ... });
+///
+/// \warning
+/// Fields are valid only during the call of the delivery function.
+///
+class csv_block_parser
+{
+public:
+  using record_t = csv_parser::record_t;
+  using fields_t = std::vector<std::string_view>;
+  using filter_hook_t = csv_parser::filter_hook_t;
+
+  explicit csv_block_parser(std::istream &);
+  csv_block_parser(std::istream &, const csv_dialect &);
+
+  const csv_dialect &dialect() const;
+
+  csv_block_parser &filter_hook(filter_hook_t) &;
+  csv_block_parser filter_hook(filter_hook_t) &&;
+
+  csv_block_parser &threads(unsigned) &;
+  csv_block_parser threads(unsigned) &&;
+
+  csv_block_parser &block_size(std::size_t) &;
+  csv_block_parser block_size(std::size_t) &&;
+
+  std::size_t for_each(const std::function<void (const fields_t &)> &) const;
+
+private:
+  struct chunk;
+  struct block;
+
+  bool read_block(std::string &, std::string &) const;
+  void parse(block &, thread_pool &) const;
+  void parse_chunk(chunk &) const;
+  const char *parse_quoted(const char *, const char *, chunk &) const;
+
+  std::istream *is_;
+
+  filter_hook_t filter_hook_;
+  csv_dialect dialect_;
+
+  unsigned threads_;
+  std::size_t block_size_;
+};  // class csv_block_parser
+
 }  // namespace vita
 
 #endif  // include guard
@@ -0,0 +1,312 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#if !defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)
+#  include <arpa/inet.h>
+#  include <fcntl.h>
+#  include <netdb.h>
+#  include <netinet/in.h>
+#  include <poll.h>
+#  include <sys/socket.h>
+#  include <sys/time.h>
+#  include <unistd.h>
+#endif
+
+#include "kernel/exceptions.h"
+#include "utility/net.h"
+
+namespace vita::net
+{
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
+
+// Only POSIX sockets are supported: elsewhere there is no server and every
+// message is lost.
+
+server::server(std::uint16_t port, const std::string &address)
+  : fd_(-1), port_(port)
+{
+  throw exception::network("Cannot listen on " + address + ':'
+                           + std::to_string(port)
+                           + " (sockets aren't supported on this platform)");
+}
+
+server::~server() {}
+
+std::uint16_t server::port() const
+{
+  return port_;
+}
+
+bool server::receive(std::string *, std::chrono::milliseconds)
+{
+  return false;
+}
+
+bool send(const endpoint &, const std::string &, std::chrono::milliseconds)
+{
+  return false;
+}
+
+#else
+
+// Writes to a closed connection return an error instead of raising
+// `SIGPIPE` (platforms without `MSG_NOSIGNAL` use `SO_NOSIGPIPE`).
+#if !defined(MSG_NOSIGNAL)
+#  define MSG_NOSIGNAL 0
+#endif
+
+namespace
+{
+
+// Longer messages are rejected (they're garbage or come from a misbehaving
+// peer).
+constexpr std::size_t max_message_size = 1u << 26;
+
+// Closes a file descriptor when going out of scope.
+class fd_guard
+{
+public:
+  explicit fd_guard(int fd) : fd_(fd) {}
+  ~fd_guard() { if (fd_ >= 0) ::close(fd_); }
+
+  DISALLOW_COPY_AND_ASSIGN(fd_guard);
+
+  int get() const { return fd_; }
+
+private:
+  int fd_;
+};
+
+bool write_all(int fd, const char *data, std::size_t n)
+{
+  while (n)
+  {
+    const auto w(::send(fd, data, n, MSG_NOSIGNAL));
+    if (w <= 0)
+      return false;
+
+    data += w;
+    n -= static_cast<std::size_t>(w);
+  }
+
+  return true;
+}
+
+bool read_all(int fd, char *data, std::size_t n)
+{
+  while (n)
+  {
+    const auto r(::recv(fd, data, n, 0));
+    if (r <= 0)
+      return false;
+
+    data += r;
+    n -= static_cast<std::size_t>(r);
+  }
+
+  return true;
+}
+
+// Connects a socket waiting, at most, `timeout`.
+bool connect_within(int fd, const sockaddr *addr, socklen_t len,
+                    std::chrono::milliseconds timeout)
+{
+  const int flags(::fcntl(fd, F_GETFL, 0));
+  if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+    return false;
+
+  if (::connect(fd, addr, len) < 0)
+  {
+    if (errno != EINPROGRESS)
+      return false;
+
+    pollfd pfd{fd, POLLOUT, 0};
+    if (::poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0)
+      return false;
+
+    int err(0);
+    socklen_t err_len(sizeof(err));
+    if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &err_len) < 0 || err)
+      return false;
+  }
+
+  // Back to blocking mode: writes are bounded by `SO_SNDTIMEO`.
+  return ::fcntl(fd, F_SETFL, flags) == 0;
+}
+
+}  // unnamed namespace
+
+///
+/// Starts listening.
+///
+/// \param[in] port    a TCP port (`0` lets the operating system choose a free
+///                    one, see server::port)
+/// \param[in] address numeric IPv4 address of the interface to listen on.
+///                    The default accepts only local connections;
+///                    `0.0.0.0` means every interface
+///
+/// \exception exception::network the port cannot be bound
+///
+server::server(std::uint16_t port, const std::string &address)
+  : fd_(::socket(AF_INET, SOCK_STREAM, 0)), port_(port)
+{
+  if (fd_ < 0)
+    throw exception::network("Cannot create socket");
+
+  const int yes(1);
+  ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+
+  if (::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1)
+  {
+    ::close(fd_);
+    throw exception::network("Invalid interface address " + address);
+  }
+
+  socklen_t len(sizeof(addr));
+  if (::bind(fd_, reinterpret_cast<sockaddr *>(&addr), len) < 0
+      || ::listen(fd_, SOMAXCONN) < 0
+      || ::getsockname(fd_, reinterpret_cast<sockaddr *>(&addr), &len) < 0)
+  {
+    ::close(fd_);
+    throw exception::network("Cannot listen on " + address + ':'
+                             + std::to_string(port));
+  }
+
+  port_ = ntohs(addr.sin_port);
+}
+
+server::~server()
+{
+  ::close(fd_);
+}
+
+///
+/// \return the port the server is listening on
+///
+std::uint16_t server::port() const
+{
+  return port_;
+}
+
+///
+/// Waits for a message.
+///
+/// \param[out] msg     the message received
+/// \param[in]  timeout maximum waiting time
+/// \return             `true` if a message has been received (`false` on
+///                     timeout or malformed message)
+///
+bool server::receive(std::string *msg, std::chrono::milliseconds timeout)
+{
+  Expects(msg);
+
+  pollfd pfd{fd_, POLLIN, 0};
+  if (::poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0)
+    return false;
+
+  const fd_guard conn(::accept(fd_, nullptr, nullptr));
+  if (conn.get() < 0)
+    return false;
+
+  // A stalled sender cannot block the server forever.
+  timeval tv{1, 0};
+  ::setsockopt(conn.get(), SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  unsigned char header[4];
+  if (!read_all(conn.get(), reinterpret_cast<char *>(header), sizeof(header)))
+    return false;
+
+  const std::size_t n((std::size_t(header[0]) << 24)
+                      | (std::size_t(header[1]) << 16)
+                      | (std::size_t(header[2]) << 8)
+                      | std::size_t(header[3]));
+  if (n > max_message_size)
+    return false;
+
+  std::string buffer(n, '\0');
+  if (n && !read_all(conn.get(), buffer.data(), n))
+    return false;
+
+  *msg = std::move(buffer);
+  return true;
+}
+
+///
+/// Sends a message.
+///
+/// \param[in] to      the receiving server
+/// \param[in] msg     the message
+/// \param[in] timeout maximum waiting time for the connection and for every
+///                    write operation
+/// \return            `true` if the message has been delivered to the
+///                    receiving host
+///
+/// An unreachable or stalled receiver cannot block the sender (typically the
+/// evolution thread) for long: the operation fails after `timeout`.
+///
+bool send(const endpoint &to, const std::string &msg,
+          std::chrono::milliseconds timeout)
+{
+  if (msg.size() > max_message_size)
+    return false;
+
+  addrinfo hints;
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+
+  addrinfo *res;
+  if (::getaddrinfo(to.host.c_str(), std::to_string(to.port).c_str(), &hints,
+                    &res))
+    return false;
+
+  const fd_guard fd(::socket(res->ai_family, res->ai_socktype,
+                             res->ai_protocol));
+  const bool connected(fd.get() >= 0
+                       && connect_within(fd.get(), res->ai_addr,
+                                         res->ai_addrlen, timeout));
+  ::freeaddrinfo(res);
+
+  if (!connected)
+    return false;
+
+  const auto ms(timeout.count());
+  timeval tv{static_cast<decltype(tv.tv_sec)>(ms / 1000),
+             static_cast<decltype(tv.tv_usec)>(ms % 1000 * 1000)};
+  ::setsockopt(fd.get(), SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+#if defined(SO_NOSIGPIPE)
+  const int yes(1);
+  ::setsockopt(fd.get(), SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(yes));
+#endif
+
+  const auto n(static_cast<std::uint32_t>(msg.size()));
+  const char header[4] = {static_cast<char>(n >> 24),
+                          static_cast<char>(n >> 16),
+                          static_cast<char>(n >> 8),
+                          static_cast<char>(n)};
+
+  return write_all(fd.get(), header, sizeof(header))
+         && write_all(fd.get(), msg.data(), msg.size());
+}
+
+#endif
+
+}  // namespace vita::net
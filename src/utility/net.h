@@ -0,0 +1,67 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_NET_H)
+#define      VITA_NET_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "kernel/common.h"
+
+namespace vita::net
+{
+
+///
+/// Address of a process accepting messages.
+///
+struct endpoint
+{
+  std::string host;
+  std::uint16_t port;
+};
+
+///
+/// Receives length-prefixed messages over TCP.
+///
+/// Every connection carries exactly one message: the sender connects,
+/// writes a 32 bit (big endian) length followed by the payload and closes
+/// the connection (see net::send).
+///
+/// \remark
+/// POSIX sockets only: elsewhere the constructor throws (and net::send always
+/// fails).
+///
+class server
+{
+public:
+  DISALLOW_COPY_AND_ASSIGN(server);
+
+  explicit server(std::uint16_t = 0, const std::string & = "127.0.0.1");
+  ~server();
+
+  std::uint16_t port() const;
+
+  bool receive(std::string *, std::chrono::milliseconds);
+
+private:
+  int fd_;
+  std::uint16_t port_;
+};
+
+bool send(const endpoint &, const std::string &,
+          std::chrono::milliseconds = std::chrono::seconds(1));
+
+}  // namespace vita::net
+
+#endif  // include guard
@@ -0,0 +1,66 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_SPSC_QUEUE_H)
+#define      VITA_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "kernel/common.h"
+
+namespace vita
+{
+
+///
+/// A bounded, lock-free, single-producer / single-consumer queue.
+///
+/// \tparam T type of the elements
+///
+/// One thread (the producer) calls `push`, another thread (the consumer)
+/// calls `pop`: neither of them ever blocks. When the queue is full `push`
+/// fails and the element isn't inserted.
+///
+/// The implementation is the classic ring buffer with one slot left empty to
+/// distinguish between the full and the empty state.
+///
+template<class T>
+class spsc_queue
+{
+public:
+  DISALLOW_COPY_AND_ASSIGN(spsc_queue);
+
+  explicit spsc_queue(std::size_t);
+
+  std::size_t capacity() const;
+  bool empty() const;
+
+  bool push(const T &);
+  bool pop(T *);
+
+private:
+  std::size_t next(std::size_t) const;
+
+  std::vector<T> buffer_;
+
+  // Producer and consumer indexes live on different cache lines (avoids
+  // false sharing).
+  alignas(64) std::atomic<std::size_t> head_;  // next element to be popped
+  alignas(64) std::atomic<std::size_t> tail_;  // next free slot
+};
+
+#include "utility/spsc_queue.tcc"
+
+}  // namespace vita
+
+#endif  // include guard
@@ -0,0 +1,102 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_SPSC_QUEUE_H)
+#  error "Don't include this file directly, include the specific .h instead"
+#endif
+
+#if !defined(VITA_SPSC_QUEUE_TCC)
+#define      VITA_SPSC_QUEUE_TCC
+
+///
+/// \param[in] n maximum number of elements stored in the queue
+///
+template<class T>
+spsc_queue<T>::spsc_queue(std::size_t n) : buffer_(n + 1), head_(0), tail_(0)
+{
+  Expects(n);
+}
+
+///
+/// \return maximum number of elements stored in the queue
+///
+template<class T>
+std::size_t spsc_queue<T>::capacity() const
+{
+  return buffer_.size() - 1;
+}
+
+///
+/// \return `true` if the queue is empty
+///
+/// \remark The result is only a snapshot if the queue is used concurrently.
+///
+template<class T>
+bool spsc_queue<T>::empty() const
+{
+  return head_.load(std::memory_order_acquire)
+         == tail_.load(std::memory_order_acquire);
+}
+
+template<class T>
+std::size_t spsc_queue<T>::next(std::size_t i) const
+{
+  return ++i == buffer_.size() ? 0 : i;
+}
+
+///
+/// Inserts an element at the end of the queue.
+///
+/// \param[in] e element to be inserted
+/// \return      `false` if the queue is full (`e` isn't inserted)
+///
+/// \warning Must only be called by the producer thread.
+///
+template<class T>
+bool spsc_queue<T>::push(const T &e)
+{
+  const auto tail(tail_.load(std::memory_order_relaxed));
+  const auto next_tail(next(tail));
+
+  if (next_tail == head_.load(std::memory_order_acquire))
+    return false;
+
+  buffer_[tail] = e;
+  tail_.store(next_tail, std::memory_order_release);
+
+  return true;
+}
+
+///
+/// Extracts the element at the front of the queue.
+///
+/// \param[out] e the extracted element
+/// \return       `false` if the queue is empty (`e` isn't changed)
+///
+/// \warning Must only be called by the consumer thread.
+///
+template<class T>
+bool spsc_queue<T>::pop(T *e)
+{
+  Expects(e);
+
+  const auto head(head_.load(std::memory_order_relaxed));
+  if (head == tail_.load(std::memory_order_acquire))
+    return false;
+
+  *e = std::move(buffer_[head]);
+  head_.store(next(head), std::memory_order_release);
+
+  return true;
+}
+
+#endif  // include guard
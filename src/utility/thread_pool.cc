@@ -0,0 +1,151 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <algorithm>
+
+#include "utility/thread_pool.h"
+
+namespace vita
+{
+
+///
+/// \param[in] n number of workers (calling thread included). `0` means the
+///              number of concurrent threads supported by the hardware
+///
+thread_pool::thread_pool(unsigned n)
+  : threads_(), mutex_(), start_(), done_(), task_(nullptr), tasks_(0),
+    next_(0), busy_(0), generation_(0), stop_(false), error_()
+{
+  if (!n)
+    n = std::max(std::thread::hardware_concurrency(), 1u);
+
+  threads_.reserve(n - 1);
+  for (unsigned w(1); w < n; ++w)
+    threads_.emplace_back(&thread_pool::work, this, w);
+
+  Ensures(size() == n);
+}
+
+///
+/// Stops and joins the worker threads.
+///
+thread_pool::~thread_pool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+
+  for (auto &t : threads_)
+    t.join();
+}
+
+///
+/// \return number of workers (calling thread included)
+///
+unsigned thread_pool::size() const
+{
+  return static_cast<unsigned>(threads_.size()) + 1;
+}
+
+///
+/// Executes a group of tasks.
+///
+/// \param[in] n number of tasks
+/// \param[in] f function executing a task. `f(i, w)` executes the `i`-th
+///              task on the `w`-th worker (`w` is in the `[0, size()[`
+///              range). Tasks on the same worker are sequential
+///
+/// Returns when all the tasks have been executed. The first exception thrown
+/// by a task (if any) is rethrown.
+///
+void thread_pool::run(std::size_t n,
+                      const std::function<void(std::size_t, unsigned)> &f)
+{
+  if (threads_.empty() || n <= 1)
+  {
+    for (std::size_t i(0); i < n; ++i)
+      f(i, 0);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    task_ = &f;
+    tasks_ = n;
+    next_ = 0;
+    busy_ = static_cast<unsigned>(threads_.size());
+    error_ = nullptr;
+    ++generation_;
+  }
+  start_.notify_all();
+
+  drain(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return busy_ == 0; });
+  task_ = nullptr;
+
+  if (error_)
+    std::rethrow_exception(error_);
+}
+
+///
+/// Executes tasks of the current group until there are no more.
+///
+/// \param[in] w index of the worker
+///
+void thread_pool::drain(unsigned w)
+{
+  for (auto i(next_++); i < tasks_; i = next_++)
+    try
+    {
+      (*task_)(i, w);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_)
+        error_ = std::current_exception();
+    }
+}
+
+///
+/// Main loop of a worker thread.
+///
+/// \param[in] w index of the worker
+///
+void thread_pool::work(unsigned w)
+{
+  for (decltype(generation_) seen(0);;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+
+      if (stop_)
+        return;
+
+      seen = generation_;
+    }
+
+    drain(w);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--busy_ == 0)
+      done_.notify_one();
+  }
+}
+
+}  // namespace vita
@@ -0,0 +1,85 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_THREAD_POOL_H)
+#define      VITA_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "kernel/common.h"
+
+namespace vita
+{
+
+///
+/// A fixed set of worker threads executing groups of independent tasks.
+///
+/// The typical use is:
+///
+///     thread_pool pool(8);
+///
+///     pool.run(n, [&](std::size_t task, unsigned worker)
+///                 {
+///                   do_task(task, data_of[worker]);
+///                 });
+///
+/// `run` blocks until every task has been executed. The calling thread takes
+/// part in the execution (it's the worker `0`), so a pool of size `n` starts
+/// `n - 1` threads.
+///
+/// \warning
+/// `run` isn't reentrant: a pool must be used by one thread at a time and
+/// tasks cannot call `run` on the same pool.
+///
+class thread_pool
+{
+public:
+  DISALLOW_COPY_AND_ASSIGN(thread_pool);
+
+  explicit thread_pool(unsigned);
+  ~thread_pool();
+
+  unsigned size() const;
+
+  void run(std::size_t, const std::function<void(std::size_t, unsigned)> &);
+
+private:
+  void drain(unsigned);
+  void work(unsigned);
+
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;
+  std::condition_variable start_;  // a new group of tasks is available
+  std::condition_variable done_;   // every worker is idle
+
+  // Current group of tasks.
+  const std::function<void(std::size_t, unsigned)> *task_;
+  std::size_t tasks_;
+  std::atomic<std::size_t> next_;  // index of the next task to be executed
+
+  unsigned busy_;              // number of threads working on the group
+  unsigned long generation_;   // identifies the current group
+  bool stop_;
+
+  std::exception_ptr error_;  // first exception thrown by a task
+};
+
+}  // namespace vita
+
+#endif  // include guard
@@ -0,0 +1,420 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "utility/xml_reader.h"
+
+namespace vita
+{
+
+namespace
+{
+
+constexpr int eof(std::char_traits<char>::eof());
+
+bool is_space(int c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool is_name_char(int c)
+{
+  return c != eof && !is_space(c) && !std::strchr("/>=<&\"'", c);
+}
+
+// Appends the UTF-8 encoding of the code point `cp` to `out`.
+bool append_utf8(unsigned long cp, std::string &out)
+{
+  if (cp < 0x80)
+    out.push_back(static_cast<char>(cp));
+  else if (cp < 0x800)
+  {
+    out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+  else if (cp < 0x10000)
+  {
+    out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+  else if (cp < 0x110000)
+  {
+    out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+  else
+    return false;
+
+  return true;
+}
+
+}  // unnamed namespace
+
+///
+/// \param[in] in stream containing the XML document
+///
+/// The document is read starting from the current position of the stream.
+///
+xml_reader::xml_reader(std::istream &in)
+  : in_(in.rdbuf()), path_(), attributes_(), name_(), text_(), pop_(false),
+    self_close_(false), root_seen_(false)
+{
+  Expects(in_);
+}
+
+///
+/// Reads the document up to the next event.
+///
+/// \return the event:
+///         - `start_element`. `name()` and `attribute()` refer to the new
+///           element;
+///         - `end_element`. `name()` is the name of the closed element and
+///           `text()` the character data between the previous tag and the
+///           closing one;
+///         - `end_document`. The root element has been closed and there is
+///           no more input;
+///         - `error`. The document is malformed.
+///
+/// `<a/>` generates both a `start_element` and an `end_element` event.
+///
+xml_reader::event xml_reader::next()
+{
+  text_.clear();
+
+  if (self_close_)
+  {
+    self_close_ = false;
+    pop_ = true;
+    return end_element;
+  }
+
+  if (pop_)
+  {
+    path_.pop_back();
+    pop_ = false;
+  }
+
+  for (;;)
+  {
+    const int c(get());
+
+    if (c == eof)
+      return path_.empty() && root_seen_ ? end_document : error;
+
+    if (c == '<')
+    {
+      const int n(peek());
+
+      if (n == '/')
+      {
+        get();
+        return read_end_tag() ? end_element : error;
+      }
+
+      if (n == '!' || n == '?')
+      {
+        if (!read_markup())
+          return error;
+        continue;
+      }
+
+      if (root_seen_ && path_.empty())  // multiple root elements
+        return error;
+
+      return read_start_tag() ? start_element : error;
+    }
+
+    if (path_.empty())  // only spaces are allowed outside the root element
+    {
+      if (!is_space(c))
+        return error;
+    }
+    else if (c == '&')
+    {
+      if (!read_reference(text_))
+        return error;
+    }
+    else
+      text_.push_back(static_cast<char>(c));
+  }
+}
+
+///
+/// \return the name of the current element
+///
+const std::string &xml_reader::name() const
+{
+  return name_;
+}
+
+///
+/// \return the names of the open elements (from the root to the current
+///         element, which is included also for `end_element` events)
+///
+const std::vector<std::string> &xml_reader::path() const
+{
+  return path_;
+}
+
+///
+/// \param[in] n name of an attribute
+/// \return      the value of the attribute `n` of the last start tag (if
+///              present)
+///
+std::optional<std::string> xml_reader::attribute(const std::string &n) const
+{
+  const auto it(std::find_if(attributes_.begin(), attributes_.end(),
+                             [&n](const attribute_t &a)
+                             {
+                               return a.first == n;
+                             }));
+
+  if (it == attributes_.end())
+    return {};
+  return it->second;
+}
+
+///
+/// \return the character data between the previous tag and the current one
+///         (references are replaced)
+///
+const std::string &xml_reader::text() const
+{
+  return text_;
+}
+
+int xml_reader::get()
+{
+  return in_->sbumpc();
+}
+
+int xml_reader::peek()
+{
+  return in_->sgetc();
+}
+
+void xml_reader::skip_spaces()
+{
+  while (is_space(peek()))
+    get();
+}
+
+// Skips every character up to (and including) the `end` sequence.
+bool xml_reader::skip_until(const char *end)
+{
+  const std::size_t n(std::strlen(end));
+  std::string window;
+
+  for (int c(get()); c != eof; c = get())
+  {
+    window.push_back(static_cast<char>(c));
+    if (window.size() > n)
+      window.erase(window.begin());
+
+    if (window == end)
+      return true;
+  }
+
+  return false;
+}
+
+bool xml_reader::read_name(std::string &out)
+{
+  out.clear();
+
+  while (is_name_char(peek()))
+    out.push_back(static_cast<char>(get()));
+
+  return !out.empty();
+}
+
+// Reads a reference (the initial `&` has already been read) and appends the
+// replacement text to `out`.
+bool xml_reader::read_reference(std::string &out)
+{
+  std::string ref;
+  for (int c(get()); c != ';'; c = get())
+  {
+    if (c == eof || ref.size() > 10)
+      return false;
+    ref.push_back(static_cast<char>(c));
+  }
+
+  if (ref == "lt")
+    out.push_back('<');
+  else if (ref == "gt")
+    out.push_back('>');
+  else if (ref == "amp")
+    out.push_back('&');
+  else if (ref == "quot")
+    out.push_back('"');
+  else if (ref == "apos")
+    out.push_back('\'');
+  else if (ref.size() > 1 && ref[0] == '#')
+  {
+    const bool hex(ref[1] == 'x');
+    const auto digits(ref.substr(hex ? 2 : 1));
+
+    if (digits.empty())
+      return false;
+
+    char *end;
+    const auto cp(std::strtoul(digits.c_str(), &end, hex ? 16 : 10));
+    if (*end || !append_utf8(cp, out))
+      return false;
+  }
+  else
+    return false;
+
+  return true;
+}
+
+// Reads a start tag (the initial `<` has already been read).
+bool xml_reader::read_start_tag()
+{
+  attributes_.clear();
+
+  if (!read_name(name_))
+    return false;
+
+  for (;;)
+  {
+    skip_spaces();
+
+    switch (peek())
+    {
+    case '>':
+      get();
+      break;
+
+    case '/':
+      get();
+      if (get() != '>')
+        return false;
+      self_close_ = true;
+      break;
+
+    default:
+    {
+      attribute_t a;
+
+      if (!read_name(a.first))
+        return false;
+
+      skip_spaces();
+      if (get() != '=')
+        return false;
+      skip_spaces();
+
+      const int quote(get());
+      if (quote != '"' && quote != '\'')
+        return false;
+
+      for (int c(get()); c != quote; c = get())
+        if (c == eof || c == '<')
+          return false;
+        else if (c == '&')
+        {
+          if (!read_reference(a.second))
+            return false;
+        }
+        else
+          a.second.push_back(static_cast<char>(c));
+
+      attributes_.push_back(std::move(a));
+      continue;
+    }
+    }
+
+    break;
+  }
+
+  path_.push_back(name_);
+  root_seen_ = true;
+  return true;
+}
+
+// Reads an end tag (`</` has already been read).
+bool xml_reader::read_end_tag()
+{
+  if (!read_name(name_))
+    return false;
+
+  skip_spaces();
+  if (get() != '>')
+    return false;
+
+  if (path_.empty() || path_.back() != name_)
+    return false;
+
+  pop_ = true;
+  return true;
+}
+
+// Reads comments, `CDATA` sections, processing instructions and the
+// document type declaration (`<` has already been read).
+bool xml_reader::read_markup()
+{
+  if (get() == '?')
+    return skip_until("?>");
+
+  // `<!`
+  if (peek() == '-')
+  {
+    get();
+    return get() == '-' && skip_until("-->");
+  }
+
+  if (peek() == '[')
+  {
+    for (const char *p("[CDATA["); *p; ++p)
+      if (get() != *p)
+        return false;
+
+    if (path_.empty())
+      return false;
+
+    // The content is character data (without references).
+    const auto start(text_.size());
+    for (int c(get()); c != eof; c = get())
+    {
+      text_.push_back(static_cast<char>(c));
+
+      if (text_.size() - start >= 3
+          && !text_.compare(text_.size() - 3, 3, "]]>"))
+      {
+        text_.resize(text_.size() - 3);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Document type declaration (possibly with an internal subset).
+  for (int c(get()), depth(0); c != eof; c = get())
+    if (c == '[')
+      ++depth;
+    else if (c == ']')
+      --depth;
+    else if (c == '>' && depth <= 0)
+      return true;
+
+  return false;
+}
+
+}  // namespace vita
@@ -0,0 +1,92 @@
+/**
+ *  \file
+ *  \remark This file is part of VITA.
+ *
+ *  \copyright Copyright (C) 2020 EOS di Manlio Morini.
+ *
+ *  \license
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ *  You can obtain one at http://mozilla.org/MPL/2.0/
+ */
+
+#if !defined(VITA_XML_READER_H)
+#define      VITA_XML_READER_H
+
+#include <istream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "kernel/common.h"
+
+namespace vita
+{
+
+///
+/// A streaming (pull) parser for XML documents.
+///
+/// The document is read sequentially from a stream and reported as a
+/// sequence of events:
+///
+///     xml_reader xml(in);
+///     for (auto e(xml.next()); e != xml_reader::end_document; e = xml.next())
+///       if (e == xml_reader::error)
+///         ...
+///       else if (e == xml_reader::start_element && xml.name() == "value")
+///         ...
+///
+/// Only the current tag and the text that precedes it are kept in memory, so
+/// the memory used doesn't depend on the size of the document.
+///
+/// Comments, processing instructions and the document type declaration are
+/// skipped. `CDATA` sections and the predefined / numeric character
+/// references are supported.
+///
+/// \remark
+/// It isn't a validating parser: it only checks that the document is well
+/// formed enough to be read (tags are properly nested and closed).
+///
+class xml_reader
+{
+public:
+  enum event {start_element, end_element, end_document, error};
+
+  explicit xml_reader(std::istream &);
+
+  event next();
+
+  const std::string &name() const;
+  const std::vector<std::string> &path() const;
+  std::optional<std::string> attribute(const std::string &) const;
+  const std::string &text() const;
+
+private:
+  using attribute_t = std::pair<std::string, std::string>;
+
+  int get();
+  int peek();
+  bool skip_until(const char *);
+  bool read_name(std::string &);
+  bool read_reference(std::string &);
+  bool read_start_tag();
+  bool read_end_tag();
+  bool read_markup();
+  void skip_spaces();
+
+  std::streambuf *in_;
+
+  std::vector<std::string> path_;  // open elements
+  std::vector<attribute_t> attributes_;
+  std::string name_;
+  std::string text_;
+
+  bool pop_;         // the last element of `path_` has just been closed
+  bool self_close_;  // the last start tag was also an end tag (`<a/>`)
+  bool root_seen_;
+};
+
+}  // namespace vita
+
+#endif  // include guard